@@ -1,8 +1,14 @@
 #pragma once
 
 #include "guarantyrwadb.hpp"
+#include <flon/lazy_global.hpp>
+#include <flon/plan_alloc.hpp>
 #include <invest.rwa/investrwadb.hpp>
 
+#ifdef RWAFI_HUB
+#include <rwafihub.hpp>
+#endif
+
 namespace rwafi {
 
 using namespace eosio;
@@ -52,35 +58,130 @@ public:
     guarantyrwa(name receiver, name code, datastream<const char*> ds)
     : contract(receiver, code, ds),
       _db(get_self()),
-      _db_invest(get_self()),
-      _global(get_self(), get_self().value)
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-        _db_invest = dbc(_gstate.invest_contract);
-    }
-
-    ~guarantyrwa() {
-        _global.set(_gstate, get_self());
-    }
+      _gstate(get_self())
+    {}
 
+    // 担保本金 / keeper 预算：转入 vault（memo guaranty/<type>:<plan_id>），vault 转发通知
+    // 担保本金可指定分级：guaranty:<plan_id>:<tranche>，缺省为劣后级（0）；share:<plan_id> 申购担保份额
+    // 份额币（rwafi.token）直接转回本合约赎回，memo redeem:<plan_id>
     [[eosio::on_notify("*::transfer")]]
     void on_transfer(const name& from, const name& to, const asset& quantity, const string& memo);
 
+    // 担保人收益（yield 收益分配，经 vault 子账转移）
+    [[eosio::on_notify("vaultrwa1111::move")]]
+    void on_move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id);
+
+    // 多计划担保人收益（yield 批量收益分配），按明细逐计划入账
+    [[eosio::on_notify("vaultrwa1111::movebatch")]]
+    void on_movebatch(const name& from_pool, const name& to_pool, const name& bank, const std::vector<plan_alloc_t>& allocs);
+
     ACTION init(const name& admin);
     ACTION guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& year);
     ACTION redeem(const name& guarantor, const uint64_t& plan_id, const asset& quantity);
 
+    /**
+     * 收益合约通知：投资人部分收益已交付（yield.rwa 内联调用）
+     * @param plan_id 计划ID
+     * @param quantity 本次交付给 stake 池的投资人收益
+     */
+    ACTION addyield(const uint64_t& plan_id, const asset& quantity);
+
+    // 批量收益分配时的 addyield：每个计划一条明细，只发一次内联调用
+    ACTION addyields(const std::vector<plan_alloc_t>& allocs);
+
+    /**
+     * keeper 维护入口：按计划年结束时间依次执行年度保底补足
+     * 每补足一个计划年计为一个工作单元
+     * @param keeper 调用者（奖励接收账户）
+     * @param max_work 本次最多处理的计划年数（1 ~ MAX_CRANK_WORK）
+     */
+    ACTION crank(const name& keeper, const uint16_t& max_work);
+
+    ACTION setkeeper(const asset& fee_per_work);
+
+    /**
+     * 设置担保分级的收益权重（下标即分级 id，瀑布顺序）
+     * 分级数只能增加，已有计划的分级 id 保持有效
+     * @param weights 各分级收益权重，TRANCHE_WEIGHT_BASE 为 1 倍
+     */
+    ACTION settranches(const std::vector<uint16_t>& weights);
+
+    // 按新格式重写已部署的 global（keeper 与分级权重取默认值），可重复执行
+    ACTION migrateconf();
+
+    /**
+     * 迁移旧版担保统计（guarantystat → guarstats，金额列去掉符号）
+     * @param max_rows 本次最多迁移的行数
+     */
+    ACTION migratestats(const uint16_t& max_rows);
+
+    // 迁移旧版担保人记录（stakes → guarantors），scope 为 plan_id，每次最多 max_rows 行
+    ACTION migratestake(const uint64_t& plan_id, const uint16_t& max_rows);
+
+    // 升级导入：本合约账户持有的 bank/sym 余额整笔转入 vault 记入本池子账（升级后支付只走 vault）
+    ACTION migratebal(const name& bank, const symbol& sym);
+
+    // 按当前担保池总额重新推送计划覆盖率到 yield（任何人可调用，用于补齐已有计划的缓存）
+    ACTION synccover(const uint64_t& plan_id);
+
+    /**
+     * 开通计划的担保份额池：在 rwafi.token 创建份额币（本合约为发行人，精度同 goal）
+     * 份额池资产被补足耗尽后可换新份额币重开：旧份额作废，按 1:1 重新申购
+     * @param submitter 计划创建者或管理员
+     * @param share_code 份额币符号
+     */
+    ACTION openshares(const name& submitter, const uint64_t& plan_id, const symbol_code& share_code);
+
+    using addyield_action  = eosio::action_wrapper<"addyield"_n, &guarantyrwa::addyield>;
+    using addyields_action = eosio::action_wrapper<"addyields"_n, &guarantyrwa::addyields>;
+
 private:
     // === 工具方法 ===
     static uint64_t _current_period_yyyymm();
-    static asset _yearly_guarantee_principal(const fundplan_t& plan);
+
+    // === 保底收益计提 ===
+    static void _accrue(guaranty_stats_t& stats, const fundplan_t& plan, const time_point_sec& to);
+    asset _pay_shortfall(const fundplan_t& plan, const time_point_sec& until);
+
+    // === 年度补足排期 ===
+    static uint16_t _total_years(const fundplan_t& plan);
+    static time_point_sec _year_end(const fundplan_t& plan, const uint64_t& year);
+    static void _schedule_pay(guaranty_stats_t& stats, const fundplan_t& plan, const uint64_t& next_year);
+
+    void _pay_keeper(const name& keeper, const uint32_t& done);
 
     // === 内部事件处理 ===
-    void _handle_guaranty_transfer(const name& from, const fundplan_t& plan, const asset& quantity);
+    void _handle_guaranty_transfer(const name& from, const fundplan_t& plan, const asset& quantity,
+                                   const uint8_t& tranche);
     void _handle_reward_transfer(const fundplan_t& plan, const asset& quantity);
 
+    // 旧版统计行尚未经 migratestats 搬迁时拒绝新建统计行，避免新旧两行并存
+    void _check_stats_migrated(const uint64_t& plan_id) const;
+
+    // 旧版担保人分批搬迁期间分级汇总只含已搬部分：冻结该计划的担保充值、解押、分红与补足扣减
+    bool _stakes_migrated(const uint64_t& plan_id) const;
+    void _check_stakes_migrated(const uint64_t& plan_id) const;
+
+    // 担保池总额累加（首笔建统计行），返回累加后的总额
+    int64_t _add_guarantee_funds(const fundplan_t& plan, const asset& quantity);
+
+    // === 担保份额 ===
+    void _handle_share_deposit(const name& from, const fundplan_t& plan, const asset& quantity);
+    void _redeem_shares(const name& owner, const asset& shares, const string& memo);
+
+    // 投资人收益已交付：计提后累加到 delivered_yield（addyield / addyields）
+    void _add_yield(const uint64_t& plan_id, const asset& quantity);
+
     // === 担保收益补足逻辑 ===
-    void _deduct_from_guarantors(uint64_t plan_id, const asset& pay);
+    // 按分级瀑布扣减担保人额度，返回扣减后的担保池总额
+    int64_t _deduct_from_guarantors(uint64_t plan_id, const asset& pay);
+
+    // 担保池总额变化后推送覆盖率（bp）到 yield，与缓存值相同时不推送
+    void _push_coverage(const fundplan_t& plan, const int64_t& funds);
+
+    // === 担保分级 ===
+    uint16_t _tranche_weight(const uint64_t& tranche) const;
+    void _settle_guarantor(guarantor_stake_t::idx_t& stakes, guarantor_stake_t::idx_t::const_iterator it);
 
     // === 赎回逻辑分段 ===
     void _redeem_failed_project(const name& guarantor,
@@ -106,9 +207,11 @@ private:
 
 private:
     dbc              _db;           ///< 本合约数据库
-    dbc              _db_invest;    ///< 投资计划数据库 (investrwa)
-    global_singleton _global;       ///< 全局配置
-    global_t         _gstate;       ///< 全局状态
+    lazy_global<global_singleton, global_t> _gstate;   ///< 全局状态（首次访问时加载，修改后析构回写）
+
+#ifdef RWAFI_HUB
+    friend struct rwahub::pools;    // hub 内池间转移直接调用入账逻辑
+#endif
 };
 
 } // namespace rwafi
\ No newline at end of file
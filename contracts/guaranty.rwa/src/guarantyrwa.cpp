@@ -1,75 +1,145 @@
 #include "guarantyrwa.hpp"
 #include "yield.rwa/yieldrwadb.hpp"
+#ifndef RWAFI_HUB
+#include <yield.rwa/yieldrwa.hpp>
+#endif
 
 #include <flon/flon.token.hpp>
 #include <flon/utils.hpp>
+#include <flon/calendar.hpp>
+#include <flon/decimal.hpp>
+#include <vault.rwa/vaultrwa.hpp>
 
 using namespace rwafi;
 using namespace eosio;
 using namespace flon;
 
 uint64_t guarantyrwa::_current_period_yyyymm() {
-    const time_t t = (time_t) current_time_point().sec_since_epoch();
-    const tm* g = gmtime(&t);
-    return ((g->tm_year + 1900) * 100 + (g->tm_mon + 1));
+    return calendar::to_period(current_time_point().sec_since_epoch());
 }
 
-asset guarantyrwa::_yearly_guarantee_principal(const fundplan_t& plan) {
-    uint16_t years = std::max<uint16_t>(1, (plan.return_months + 11) / 12);
-    int64_t yearly_amt = (int64_t)((__int128)plan.goal_quantity.amount / years / 2);
-    return {yearly_amt, plan.goal_quantity.symbol};
+// 将保底收益计提推进到 to：obligation += principal × apr × dt / (10000 × 1年)
+// 仅在收益期 [start_time, return_end_time] 且计划成功后计提
+// 计划成功前不推进 last_accrued_at，成功后从收益期起点补计
+void guarantyrwa::_accrue(guaranty_stats_t& stats, const fundplan_t& plan, const time_point_sec& to) {
+    if (plan.status != PlanStatus::SUCCESS && plan.status != PlanStatus::COMPLETED) return;
+
+    const uint32_t from  = std::max(stats.last_accrued_at, plan.start_time).sec_since_epoch();
+    const uint32_t until = std::min(to, plan.return_end_time).sec_since_epoch();
+
+    if (until > from && plan.guaranteed_yield_apr > 0) {
+        const int128_t apr_dt = (int128_t)plan.guaranteed_yield_apr * (until - from);
+        const int128_t denom  = (int128_t)10000 * seconds_per_year;
+        const int64_t owed = muldiv(plan.total_raised_funds.amount, apr_dt, denom);
+        CHECKC(owed <= std::numeric_limits<int64_t>::max() - stats.accrued_obligation.amount,
+               err::PARAM_ERROR, "overflow in apr accrual");
+        stats.accrued_obligation.amount += owed;
+    }
+    if (to > stats.last_accrued_at) stats.last_accrued_at = to;
 }
 
-static void record_yield_log_monthly(const name& yield_contract,const name& payer,uint64_t plan_id,const asset& pay)
-{
-    yield_log_t::idx_t logs(yield_contract, plan_id);
-    const uint64_t period = []() {
-        const time_t t = (time_t) current_time_point().sec_since_epoch();
-        const tm* g = gmtime(&t);
-        return ((g->tm_year + 1900) * 100 + (g->tm_mon + 1));
-    }();
-
-    asset cumulative_prev(0, pay.symbol);
-    if (auto it = logs.rbegin(); it != logs.rend()) cumulative_prev = it->cumulative_yield;
-
-    auto itr = logs.find(period);
-    if (itr == logs.end()) {
-        logs.emplace(payer, [&](auto& y) {
-            y.period           = period;
-            y.period_yield     = pay;
-            y.cumulative_yield = cumulative_prev + pay;
-            y.created_at       = y.updated_at = time_point_sec(current_time_point());
+// 按计提结果补足保底缺口：从担保池支付到 stake 池
+asset guarantyrwa::_pay_shortfall(const fundplan_t& plan, const time_point_sec& until) {
+    const time_point_sec now = time_point_sec(current_time_point());
+
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    auto it_stats = stats_tbl.find(plan.id);
+    CHECKC(it_stats != stats_tbl.end(), err::RECORD_NOT_FOUND, "no stats");
+
+    asset pay(0, plan.goal_quantity.symbol);
+    stats_tbl.modify(it_stats, same_payer, [&](auto& s) {
+        _accrue(s, plan, until);
+        pay.amount = std::min<int64_t>(s.shortfall(), s.total_guarantee_funds.amount);
+        s.delivered_yield.amount += pay.amount;
+        s.updated_at = now;
+    });
+    if (pay.amount <= 0) return pay;
+
+    _push_coverage(plan, _deduct_from_guarantors(plan.id, pay));
+
+    plan_payment_t::idx_t payments(get_self(), plan.id);
+    const uint64_t period = _current_period_yyyymm();
+    auto pay_itr = payments.find(period);
+    if (pay_itr == payments.end()) {
+        payments.emplace(get_self(), [&](auto& p) {
+            p.period     = period;
+            p.total_paid = pay;
+            p.created_at = now;
         });
     } else {
-        logs.modify(itr, payer, [&](auto& y) {
-            y.period_yield     += pay;
-            y.cumulative_yield += pay;
-            y.updated_at        = time_point_sec(current_time_point());
+        payments.modify(pay_itr, same_payer, [&](auto& p) {
+            p.total_paid += pay;
         });
     }
+
+#ifdef RWAFI_HUB
+    rwahub::pools::stake_reward(get_self(), rwahub::GUARANTY_TO_STAKE, plan.goal_asset_contract, pay, plan.id);
+#else
+    POOL_MOVE(STAKE_POOL, plan.goal_asset_contract, pay, plan.id);
+#endif
+    return pay;
+}
+
+uint16_t guarantyrwa::_total_years(const fundplan_t& plan) {
+    return std::max<uint16_t>(1, (plan.return_months + 11) / 12);
+}
+
+// 计划年结束时间（以募资开始时间为起点，最后一年截止到收益结束）
+time_point_sec guarantyrwa::_year_end(const fundplan_t& plan, const uint64_t& year) {
+    return std::min(
+        time_point_sec(calendar::add_months(plan.start_time.sec_since_epoch(), year * calendar::MONTHS_PER_YEAR)),
+        plan.return_end_time);
+}
+
+// 排期下一个待补足计划年，超出收益期则清空
+void guarantyrwa::_schedule_pay(guaranty_stats_t& stats, const fundplan_t& plan, const uint64_t& next_year) {
+    stats.next_pay_year = (uint16_t)next_year;
+    stats.next_pay_at   = next_year <= _total_years(plan) ? _year_end(plan, next_year) : time_point_sec();
+}
+
+void guarantyrwa::_pay_keeper(const name& keeper, const uint32_t& done) {
+    const asset reward = _gstate.mut().keeper.charge(done);
+    if (reward.amount > 0)
+        POOL_PAY(SING_BANK, keeper, reward, "crank reward: " + std::to_string(done));
 }
 
 void guarantyrwa::init(const name& admin) {
     require_auth(get_self());
     CHECKC(is_account(admin), err::ACCOUNT_INVALID, "invalid admin");
-    _gstate.admin = admin;
-    _global.set(_gstate, get_self());
+    _gstate.mut().admin = admin;
 }
 
 // 担保本金 / 分红
-void guarantyrwa::on_transfer(const name& from, const name& to, const asset& quantity, const string& memo) {
-    if (from == get_self() || to != get_self()) return;
+void guarantyrwa::on_transfer(const name& from, const name& to, const asset& quantity, const string& raw_memo) {
+    // 份额币转回本合约赎回（不经 vault）；本合约自身发出的份额转账忽略
+    if (get_first_receiver() == RECEIPT_BANK) {
+        if (from == get_self() || to != get_self()) return;
+        return _redeem_shares(from, quantity, raw_memo);
+    }
+
+    string memo;
+    if (!vault_deposit(get_self(), GUARANTY_MODULE, from, to, raw_memo, memo)) return;
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "invalid transfer amount");
 
-    // 解析 memo: 格式 <type>:<plan_id>
+    // keeper 预算充值
+    if (memo == KEEPER_MEMO) {
+        CHECKC(get_first_receiver() == SING_BANK && quantity.symbol == SING_SYM,
+               err::SYMBOL_MISMATCH, "keeper budget must be SING");
+        _gstate.mut().keeper.budget += quantity;
+        return;
+    }
+
+    // 解析 memo: 格式 <type>:<plan_id>，担保本金可带分级 guaranty:<plan_id>:<tranche>
     auto parts = split(memo, ":");
-    CHECKC(parts.size() == 2, err::INVALID_FORMAT, "memo must be <type>:<plan_id>");
+    CHECKC(parts.size() == 2 || (parts.size() == 3 && parts[0] == "guaranty"), err::INVALID_FORMAT,
+           "memo must be <type>:<plan_id>");
 
     const string action = parts[0];
     const uint64_t plan_id = std::stoull(parts[1]);
+    const uint64_t tranche = parts.size() == 3 ? to_uint64(parts[2], "tranche") : FIRST_LOSS_TRANCHE;
 
     // 从 investrwa 合约中读取计划
-    fundplan_t::idx_t fundplans(_gstate.invest_contract, _gstate.invest_contract.value);
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
     auto itr = fundplans.find(plan_id);
     CHECKC(itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
     const fundplan_t plan = *itr;
@@ -79,37 +149,72 @@ void guarantyrwa::on_transfer(const name& from, const name& to, const asset& qua
     CHECKC(quantity.symbol == plan.goal_quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch");
 
     // 分派逻辑
-    if (action == "guaranty") return _handle_guaranty_transfer(from, plan, quantity);
+    if (action == "guaranty") {
+        CHECKC(tranche < _gstate->tranche_weights.size(), err::PARAM_ERROR, "invalid tranche: " + parts[2]);
+        return _handle_guaranty_transfer(from, plan, quantity, (uint8_t)tranche);
+    }
     if (action == "reward")   return _handle_reward_transfer(plan, quantity);
+    if (action == "share")    return _handle_share_deposit(from, plan, quantity);
 
     CHECKC(false, err::PARAM_ERROR, "unsupported transfer type");
 }
 
+// 担保收益经 vault 子账转入
+void guarantyrwa::on_move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id) {
+    if (to_pool != get_self()) return;
+    CHECKC(from_pool == YIELD_POOL, err::ACCOUNT_INVALID, "reward must come from yield pool");
+
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    auto itr = fundplans.find(plan_id);
+    CHECKC(itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    CHECKC(quantity.contract == itr->goal_asset_contract, err::CONTRACT_MISMATCH, "token contract mismatch");
+    CHECKC(quantity.quantity.symbol == itr->goal_quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch");
+
+    _handle_reward_transfer(*itr, quantity.quantity);
+}
+
+void guarantyrwa::on_movebatch(const name& from_pool, const name& to_pool, const name& bank, const std::vector<plan_alloc_t>& allocs) {
+    if (to_pool != get_self()) return;
+    CHECKC(from_pool == YIELD_POOL, err::ACCOUNT_INVALID, "reward must come from yield pool");
+
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    for (const auto& a : allocs) {
+        auto itr = fundplans.find(a.plan_id);
+        CHECKC(itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+        CHECKC(bank == itr->goal_asset_contract, err::CONTRACT_MISMATCH, "token contract mismatch");
+        CHECKC(a.quantity.symbol == itr->goal_quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch");
+
+        _handle_reward_transfer(*itr, a.quantity);
+    }
+}
+
 // 担保本金充值
 void guarantyrwa::_handle_guaranty_transfer(const name& from,
                                             const fundplan_t& plan,
-                                            const asset& quantity)
+                                            const asset& quantity,
+                                            const uint8_t& tranche)
 {
     const time_point_sec now = time_point_sec(current_time_point());
     const uint64_t plan_id   = plan.id;
-    const symbol sym         = quantity.symbol;
-
-    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
-    auto stats_itr = stats_tbl.find(plan_id);
 
-    if (stats_itr == stats_tbl.end()) {
-        // 首次创建
-        stats_tbl.emplace(get_self(), [&](auto& s) {
-            s.plan_id               = plan_id;
-            s.total_guarantee_funds = quantity;
-            s.used_guarantee_funds  = asset(0, sym);
-            s.created_at = s.updated_at = now;
+    _push_coverage(plan, _add_guarantee_funds(plan, quantity));
+    _check_stakes_migrated(plan_id);
+
+    // 分级汇总
+    guaranty_tranche_t::idx_t tranches(get_self(), plan_id);
+    auto t_itr = tranches.find(tranche);
+    if (t_itr == tranches.end()) {
+        t_itr = tranches.emplace(get_self(), [&](auto& t) {
+            t.id            = tranche;
+            t.total_stake   = quantity;
+            t.capital       = quantity;
+            t.updated_at    = now;
         });
     } else {
-        // 累加担保金额
-        stats_tbl.modify(stats_itr, same_payer, [&](auto& s) {
-            s.total_guarantee_funds += quantity;
-            s.updated_at             = now;
+        tranches.modify(t_itr, same_payer, [&](auto& t) {
+            t.total_stake += quantity;
+            t.capital     += quantity;
+            t.updated_at   = now;
         });
     }
 
@@ -121,13 +226,17 @@ void guarantyrwa::_handle_guaranty_transfer(const name& from,
             s.guarantor       = from;
             s.total_stake     = quantity;
             s.locked_stake    = quantity;
-            s.available_stake = asset(0, sym);
-            s.earned_yield    = asset(0, sym);
-            s.withdrawn       = asset(0, sym);
             s.created_at = s.updated_at = now;
+            s.tranche         = tranche;
+            s.reward_index    = t_itr->reward_index;
+            s.loss_index      = t_itr->loss_index;
         });
     } else {
+        CHECKC(itr->tranche == tranche, err::PARAM_ERROR,
+               "guarantor already in tranche " + std::to_string(itr->tranche));
+        // 先按原本金结算，再追加本金
         stakes.modify(itr, same_payer, [&](auto& s) {
+            s.settle(*t_itr);
             s.total_stake  += quantity;
             s.locked_stake += quantity;
             s.updated_at    = now;
@@ -135,35 +244,95 @@ void guarantyrwa::_handle_guaranty_transfer(const name& from,
     }
 }
 
-// 担保收益分红
-void guarantyrwa::_handle_reward_transfer(const fundplan_t& plan, const asset& quantity) {
+int64_t guarantyrwa::_add_guarantee_funds(const fundplan_t& plan, const asset& quantity) {
     const time_point_sec now = time_point_sec(current_time_point());
-    const uint64_t plan_id = plan.id;
 
-    guarantor_stake_t::idx_t stakes(get_self(), plan_id);
-    CHECKC(stakes.begin() != stakes.end(), err::RECORD_NOT_FOUND, "no guarantors");
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    auto stats_itr = stats_tbl.find(plan.id);
 
-    asset total_stake(0, quantity.symbol);
-    for (const auto& s : stakes) total_stake += s.total_stake;
-    CHECKC(total_stake.amount > 0, err::PARAM_ERROR, "total stake is zero");
+    if (stats_itr == stats_tbl.end()) {
+        // 首次创建
+        _check_stats_migrated(plan.id);
+        stats_tbl.emplace(get_self(), [&](auto& s) {
+            s.plan_id               = plan.id;
+            s.total_guarantee_funds = quantity;
+            s.created_at = s.updated_at = now;
+            _schedule_pay(s, plan, 1);
+        });
+        return quantity.amount;
+    }
 
-    int64_t distributed = 0;
-    const auto end_itr = std::prev(stakes.end());
+    // 累加担保金额
+    stats_tbl.modify(stats_itr, same_payer, [&](auto& s) {
+        s.total_guarantee_funds += quantity;
+        s.updated_at             = now;
+    });
+    return stats_itr->total_guarantee_funds.amount;
+}
 
-    for (auto it = stakes.begin(); it != stakes.end(); ++it) {
-        int64_t share_amt = (it != end_itr)
-            ? (int64_t)((__int128)quantity.amount * it->total_stake.amount / total_stake.amount)
+void guarantyrwa::_check_stats_migrated(const uint64_t& plan_id) const {
+    legacy_stats_t::idx_t legacy(get_self(), get_self().value);
+    CHECKC(legacy.find(plan_id) == legacy.end(), err::UNDER_MAINTENANCE,
+           "plan stats pending migration: " + std::to_string(plan_id));
+}
+
+bool guarantyrwa::_stakes_migrated(const uint64_t& plan_id) const {
+    legacy_stake_t::idx_t legacy(get_self(), plan_id);
+    return legacy.begin() == legacy.end();
+}
+
+void guarantyrwa::_check_stakes_migrated(const uint64_t& plan_id) const {
+    CHECKC(_stakes_migrated(plan_id), err::UNDER_MAINTENANCE,
+           "plan guarantors pending migration: " + std::to_string(plan_id));
+}
+
+// 担保收益分红：按 分级本金 × 权重 分给各分级，分级内累加分红指数，担保人访问时结算
+// 份额池按 资产 × 1 倍权重 参与，分到的部分只计入池资产（提高汇率）
+void guarantyrwa::_handle_reward_transfer(const fundplan_t& plan, const asset& quantity) {
+    const time_point_sec now = time_point_sec(current_time_point());
+    const uint64_t plan_id = plan.id;
+    _check_stakes_migrated(plan_id);
+
+    guaranty_tranche_t::idx_t tranches(get_self(), plan_id);
+    guaranty_share_t::idx_t share_pools(get_self(), get_self().value);
+    auto share_itr = share_pools.find(plan_id);
+    const bool to_pool = share_itr != share_pools.end() && share_itr->assets.amount > 0;
+    CHECKC(to_pool || tranches.begin() != tranches.end(), err::RECORD_NOT_FOUND, "no guarantors");
+
+    int128_t total_weight = to_pool ? (int128_t)share_itr->assets.amount * TRANCHE_WEIGHT_BASE : 0;
+    uint64_t last_id      = 0;
+    for (const auto& t : tranches) {
+        if (t.total_stake.amount <= 0) continue;
+        total_weight += (int128_t)t.total_stake.amount * _tranche_weight(t.id);
+        last_id = t.id;
+    }
+    CHECKC(total_weight > 0, err::PARAM_ERROR, "total stake is zero");
+
+    int64_t distributed = 0;
+    for (auto it = tranches.begin(); it != tranches.end(); ++it) {
+        if (it->total_stake.amount <= 0) continue;
+        int64_t share_amt = (to_pool || it->id != last_id)
+            ? muldiv(quantity.amount, (int128_t)it->total_stake.amount * _tranche_weight(it->id), total_weight)
             : (quantity.amount - distributed);
         if (share_amt <= 0) continue;
 
         distributed += share_amt;
-        const asset share(share_amt, quantity.symbol);
+        tranches.modify(it, same_payer, [&](auto& t) {
+            t.reward_index        += muldiv_wide(share_amt, APR_INDEX_PRECISION, t.total_stake.amount);
+            t.earned_yield.amount += share_amt;
+            t.updated_at           = now;
+        });
+    }
 
-        stakes.modify(it, get_self(), [&](auto& s) {
-            s.earned_yield    += share;
-            s.available_stake += share;
-            s.updated_at = now;
+    // 份额池取分配余数；分红留在池内继续承担补足，计入担保池总额
+    if (to_pool) {
+        const asset pool_reward(quantity.amount - distributed, quantity.symbol);
+        share_pools.modify(share_itr, same_payer, [&](auto& p) {
+            p.assets       += pool_reward;
+            p.earned_yield += pool_reward;
+            p.updated_at    = now;
         });
+        if (pool_reward.amount > 0) _push_coverage(plan, _add_guarantee_funds(plan, pool_reward));
     }
 }
 
@@ -171,7 +340,7 @@ void guarantyrwa::_handle_reward_transfer(const fundplan_t& plan, const asset& q
 void guarantyrwa::guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& year) {
     require_auth(submitter);
 
-    fundplan_t::idx_t fundplans(_gstate.invest_contract, _gstate.invest_contract.value);
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
     auto plan_itr = fundplans.find(plan_id);
     CHECKC(plan_itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
     const auto& plan = *plan_itr;
@@ -180,31 +349,117 @@ void guarantyrwa::guarantpay(const name& submitter, const uint64_t& plan_id, con
     CHECKC(_db.get(stats), err::RECORD_NOT_FOUND, "no stats");
     CHECKC(stats.total_guarantee_funds.amount > 0, err::QUANTITY_INSUFFICIENT, "empty guarantee pool");
 
-    const uint16_t total_years = std::max<uint16_t>(1, (plan.return_months + 11) / 12);
-    CHECKC(year > 0 && year <= total_years, err::PARAM_ERROR, "invalid year");
+    CHECKC(year > 0 && year <= _total_years(plan), err::PARAM_ERROR, "invalid year");
 
-    const asset yearly_due = _yearly_guarantee_principal(plan);
-    CHECKC(yearly_due.amount > 0, err::PARAM_ERROR, "invalid yearly principal");
+    const time_point_sec year_end = _year_end(plan, year);
+    CHECKC(time_point_sec(current_time_point()) >= year_end, err::NOT_EXPIRED, "plan year not finished yet");
 
-    yield_log_t::idx_t logs(_gstate.yield_contract, plan_id);
-    asset distributed(0, yearly_due.symbol);
-    if (auto it = logs.rbegin(); it != logs.rend()) distributed = it->period_yield;
+    // 补足截至年末的计提保底收益与已交付收益之差
+    _pay_shortfall(plan, year_end);
 
-    const int64_t diff = yearly_due.amount - distributed.amount;
-    if (diff <= 0) return;
+    // 手动补足后顺延 crank 排期
+    if (year >= stats.next_pay_year) {
+        guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+        stats_tbl.modify(stats_tbl.find(plan_id), same_payer, [&](auto& s) {
+            _schedule_pay(s, plan, year + 1);
+        });
+    }
+}
+
+void guarantyrwa::crank(const name& keeper, const uint16_t& max_work) {
+    require_auth(keeper);
+    CHECKC(max_work > 0 && max_work <= MAX_CRANK_WORK, err::PARAM_ERROR,
+           "max_work must be in [1, " + std::to_string(MAX_CRANK_WORK) + "]");
+
+    const uint64_t now = current_time_point().sec_since_epoch();
+    uint16_t steps = 0, done = 0;   // done 仅统计实际结算的计划，停排 / 次日重试不计报酬
+
+    while (steps < max_work) {
+        guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+        auto due = stats_tbl.get_index<"bynextpay"_n>();
+        auto it = due.begin();
+        if (it == due.end() || it->by_next_pay() > now) break;
+
+        const uint64_t       plan_id  = it->plan_id;
+        const uint64_t       year     = it->next_pay_year;
+        const time_point_sec year_end = it->next_pay_at;
+
+        fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+        auto plan_itr = fundplans.find(plan_id);
+        const bool payable = plan_itr != fundplans.end() &&
+            (plan_itr->status == PlanStatus::SUCCESS || plan_itr->status == PlanStatus::COMPLETED) &&
+            _stakes_migrated(plan_id);
+        const bool dead    = plan_itr == fundplans.end() ||
+            plan_itr->status == PlanStatus::FAILED || plan_itr->status == PlanStatus::CANCELLED ||
+            plan_itr->status == PlanStatus::REFUNDED;
+
+        if (payable) _pay_shortfall(*plan_itr, year_end);
+
+        // 重新读取：_pay_shortfall 已更新该行
+        guaranty_stats_t::idx_t fresh(get_self(), get_self().value);
+        fresh.modify(fresh.find(plan_id), same_payer, [&](auto& s) {
+            if (payable)    _schedule_pay(s, *plan_itr, year + 1);
+            else if (dead)  s.next_pay_at = time_point_sec();                   // 计划失败：不再排期
+            else            s.next_pay_at = time_point_sec(now + DAY_SECONDS);  // 状态未推进 / 担保人搬迁中：次日重试
+        });
+        if (payable) ++done;
+        ++steps;
+    }
+
+    CHECKC(steps > 0, err::NOT_EXPIRED, "no overdue guarantee payment to crank");
+    _pay_keeper(keeper, done);
+}
+
+void guarantyrwa::setkeeper(const asset& fee_per_work) {
+    require_auth(_gstate->admin);
+    CHECKC(fee_per_work.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper fee must be SING");
+    CHECKC(fee_per_work.amount >= 0, err::NOT_POSITIVE, "keeper fee must not be negative");
 
-    asset pay(std::min<int64_t>(diff, stats.total_guarantee_funds.amount), yearly_due.symbol);
-    CHECKC(pay.amount > 0, err::QUANTITY_INSUFFICIENT, "insufficient guarantee pool");
+    _gstate.mut().keeper.fee_per_work = fee_per_work;
+}
 
-    stats.total_guarantee_funds -= pay;
-    stats.used_guarantee_funds  += pay;
-    stats.updated_at = time_point_sec(current_time_point());
-    _db.set(stats);
+// 收益合约通知：投资人收益已交付
+void guarantyrwa::addyield(const uint64_t& plan_id, const asset& quantity) {
+    require_auth(YIELD_POOL);
+    _add_yield(plan_id, quantity);
+}
 
-    _deduct_from_guarantors(plan_id, pay);
-    TRANSFER(plan.goal_asset_contract, _gstate.stake_contract, pay,
-             "guarantee payout for plan:" + std::to_string(plan_id));
-    record_yield_log_monthly(_gstate.yield_contract, get_self(), plan_id, pay);
+void guarantyrwa::addyields(const std::vector<plan_alloc_t>& allocs) {
+    require_auth(YIELD_POOL);
+    for (const auto& a : allocs)
+        _add_yield(a.plan_id, a.quantity);
+}
+
+void guarantyrwa::_add_yield(const uint64_t& plan_id, const asset& quantity) {
+    CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "invalid yield amount");
+
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    auto plan_itr = fundplans.find(plan_id);
+    CHECKC(plan_itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    CHECKC(quantity.symbol == plan_itr->goal_quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch");
+
+    const time_point_sec now = time_point_sec(current_time_point());
+
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    auto it_stats = stats_tbl.find(plan_id);
+    if (it_stats == stats_tbl.end()) {
+        // 尚无担保人：先建统计行，保证已交付收益不丢失
+        _check_stats_migrated(plan_id);
+        stats_tbl.emplace(get_self(), [&](auto& s) {
+            s.plan_id               = plan_id;
+            s.delivered_yield       = quantity;
+            s.created_at = s.updated_at = now;
+            _accrue(s, *plan_itr, now);
+            _schedule_pay(s, *plan_itr, 1);
+        });
+        return;
+    }
+
+    stats_tbl.modify(it_stats, same_payer, [&](auto& s) {
+        _accrue(s, *plan_itr, now);
+        s.delivered_yield += quantity;
+        s.updated_at       = now;
+    });
 }
 
 
@@ -213,7 +468,7 @@ void guarantyrwa::redeem(const name& guarantor, const uint64_t& plan_id, const a
     require_auth(guarantor);
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "invalid redeem amount");
 
-    fundplan_t::idx_t fundplans(_gstate.invest_contract, _gstate.invest_contract.value);
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
     auto itr_plan = fundplans.find(plan_id);
     CHECKC(itr_plan != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
     fundplan_t plan = *itr_plan;
@@ -223,10 +478,12 @@ void guarantyrwa::redeem(const name& guarantor, const uint64_t& plan_id, const a
     guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
     auto it_stats = stats_tbl.find(plan_id);
     CHECKC(it_stats != stats_tbl.end(), err::RECORD_NOT_FOUND, "no guaranty pool");
+    _check_stakes_migrated(plan_id);
 
     guarantor_stake_t::idx_t stakes(get_self(), plan_id);
     auto it = stakes.find(guarantor.value);
     CHECKC(it != stakes.end(), err::RECORD_NOT_FOUND, "guarantor not found in this plan");
+    _settle_guarantor(stakes, it);
 
     CHECKC(it->total_stake.amount > 0, err::PARAM_ERROR, "guarantor has no active stake");
     CHECKC(quantity.amount <= (it->available_stake.amount + it->locked_stake.amount + it->earned_yield.amount),
@@ -243,14 +500,15 @@ void guarantyrwa::redeem(const name& guarantor, const uint64_t& plan_id, const a
 // === (1) 项目失败或取消 ===
 void guarantyrwa::_redeem_failed_project(const name& guarantor,
                                          const fundplan_t& plan,
-                                         const guaranty_stats_t& stats,
+                                         const guaranty_stats_t&,
                                          const asset& quantity) {
     guarantor_stake_t::idx_t stakes(get_self(), plan.id);
     auto it = stakes.find(guarantor.value);
     CHECKC(it != stakes.end(), err::RECORD_NOT_FOUND, "guarantor not found");
 
     // === 汇总可解押金额 ===
-    asset redeemable = it->available_stake + it->locked_stake;
+    const symbol sym = plan.goal_quantity.symbol;
+    asset redeemable = it->available_stake.of(sym) + it->locked_stake.of(sym);
     CHECKC(quantity <= redeemable, err::QUANTITY_INSUFFICIENT, "exceeds redeemable funds");
 
     // === 将锁仓资金解锁 ===
@@ -278,38 +536,17 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
                                       const asset& quantity) {
     const time_point_sec now = time_point_sec(current_time_point());
 
+    const symbol sym = plan.goal_quantity.symbol;
     __int128 required_cover = (__int128)plan.goal_quantity.amount / 2;  // 50% 担保线
 
-    // === 1️⃣ 从收益日志中读取动态比例 ===
-    yield_log_t::idx_t logs(_gstate.yield_contract, plan.id);
-    CHECKC(logs.begin() != logs.end(), err::RECORD_NOT_FOUND, "no yield logs found");
-
-    asset total_yield(0, plan.goal_quantity.symbol);
-    asset total_investor(0, plan.goal_quantity.symbol);
-    asset total_guarantor(0, plan.goal_quantity.symbol);
-    asset total_buyback(0, plan.goal_quantity.symbol);
-
-    for (auto itr = logs.begin(); itr != logs.end(); ++itr) {
-        total_yield     += itr->period_yield;
-        total_investor  += itr->investor_yield;
-        total_guarantor += itr->guarantor_yield;
-        total_buyback   += itr->buyback_yield;
-    }
-
-    CHECKC(total_yield.amount > 0, err::PARAM_ERROR, "invalid yield log (empty)");
-
-    double investor_share_ratio  = double(total_investor.amount)  / double(total_yield.amount);
-    double guarantor_share_ratio = double(total_guarantor.amount) / double(total_yield.amount);
-    double buyback_share_ratio   = double(total_buyback.amount)   / double(total_yield.amount);
-
-    // === 2️⃣ 计算当前累计分红 ===
-    asset distributed(0, plan.goal_quantity.symbol);
-    if (auto lit = logs.rbegin(); lit != logs.rend())
-        distributed = lit->cumulative_yield;
+    // === 1️⃣ 从收益累计中读取担保人分成（全生命周期，不受日志窗口影响） ===
+    yield_total_t::idx_t totals(YIELD_POOL, YIELD_POOL.value);
+    auto tot = totals.find(plan.id);
+    CHECKC(tot != totals.end(), err::RECORD_NOT_FOUND, "no yield logs found");
+    CHECKC(tot->total_yield.amount > 0, err::PARAM_ERROR, "invalid yield log (empty)");
 
-    __int128 guarantor_total_share = (__int128)(distributed.amount * guarantor_share_ratio);
-    __int128 buyback_amount        = (__int128)(distributed.amount * buyback_share_ratio);
-    __int128 net_distributed       = distributed.amount - buyback_amount;
+    // === 2️⃣ 担保人累计分成 ===
+    __int128 guarantor_total_share = tot->guarantor_yield.amount;
 
     // === 3️⃣ 计算担保资金真实覆盖量 ===
     __int128 actual_cover = (__int128)stats.total_guarantee_funds.amount + guarantor_total_share;
@@ -319,12 +556,14 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
     auto it = stakes.find(guarantor.value);
     CHECKC(it != stakes.end(), err::RECORD_NOT_FOUND, "guarantor not found");
 
-    asset total_stake(0, plan.goal_quantity.symbol);
-    for (auto s : stakes) total_stake += s.total_stake;
+    guaranty_tranche_t::idx_t tranches(get_self(), plan.id);
+    amount64 total_stake;
+    for (const auto& t : tranches) total_stake += t.total_stake;
     CHECKC(total_stake.amount > 0, err::PARAM_ERROR, "zero total stake");
 
     // === 5️⃣ 覆盖不足 (<50%) → 回锁所有可用资金和收益 ===
     if (actual_cover < required_cover) {
+        const int64_t relocked_yield = it->earned_yield.amount;
         stakes.modify(it, get_self(), [&](auto& s) {
             s.locked_stake.amount    += s.available_stake.amount + s.earned_yield.amount;
             s.total_stake.amount     += s.earned_yield.amount;
@@ -332,6 +571,9 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
             s.earned_yield.amount     = 0;
             s.updated_at = now;
         });
+        tranches.modify(tranches.find(it->tranche), same_payer, [&](auto& t) {
+            t.total_stake.amount += relocked_yield;
+        });
         CHECKC(false, err::INVALID_STATUS, "coverage below 50%, all funds relocked");
     }
 
@@ -339,8 +581,8 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
     int64_t unlock_pool = (int64_t)(actual_cover - required_cover);
     CHECKC(unlock_pool > 0, err::INVALID_STATUS, "no unlockable coverage margin");
 
-    __int128 unlockable = (__int128)unlock_pool * it->total_stake.amount / total_stake.amount;
-    int64_t unlocked = (int64_t)std::min<__int128>(unlockable, it->locked_stake.amount);
+    int64_t unlockable = muldiv(unlock_pool, it->total_stake.amount, total_stake.amount);
+    int64_t unlocked = std::min(unlockable, it->locked_stake.amount);
 
     if (unlocked > 0) {
         stakes.modify(it, get_self(), [&](auto& s) {
@@ -351,7 +593,7 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
     }
 
     // === 7️⃣ 优先使用 earned_yield 提现 ===
-    asset available_all = it->available_stake + it->earned_yield;
+    asset available_all = it->available_stake.of(sym) + it->earned_yield.of(sym);
     CHECKC(quantity.amount <= available_all.amount, err::QUANTITY_INSUFFICIENT, "redeem exceeds available+earned");
 
     stakes.modify(it, get_self(), [&](auto& s) {
@@ -375,73 +617,19 @@ void guarantyrwa::_redeem_in_progress(const name& guarantor,
 // === (3) 项目到期 ===
 void guarantyrwa::_redeem_project_end(const name& guarantor,
                                       const fundplan_t& plan,
-                                      const guaranty_stats_t& stats,
+                                      const guaranty_stats_t&,
                                       const asset& quantity) {
-    const time_point_sec now = time_point_sec(current_time_point());
-
-    // === 1️⃣ 从收益日志读取真实分配比例 ===
-    yield_log_t::idx_t logs(_gstate.yield_contract, plan.id);
-    CHECKC(logs.begin() != logs.end(), err::RECORD_NOT_FOUND, "no yield logs found");
-
-    asset total_yield(0, plan.goal_quantity.symbol);
-    asset total_investor(0, plan.goal_quantity.symbol);
-    asset total_guarantor(0, plan.goal_quantity.symbol);
-    asset total_buyback(0, plan.goal_quantity.symbol);
-
-    for (auto itr = logs.begin(); itr != logs.end(); ++itr) {
-        total_yield     += itr->period_yield;
-        total_investor  += itr->investor_yield;
-        total_guarantor += itr->guarantor_yield;
-        total_buyback   += itr->buyback_yield;
-    }
+    // === 1️⃣ 补足整个收益期的保底缺口 ===
+    _pay_shortfall(plan, plan.return_end_time);
 
-    CHECKC(total_yield.amount > 0, err::PARAM_ERROR, "invalid yield log");
-
-    double investor_share_ratio  = double(total_investor.amount)  / double(total_yield.amount);
-    double guarantor_share_ratio = double(total_guarantor.amount) / double(total_yield.amount);
-    double buyback_share_ratio   = double(total_buyback.amount)   / double(total_yield.amount);
-
-    // === 2️⃣ 取累计分红 ===
-    asset distributed(0, plan.goal_quantity.symbol);
-    if (auto lit = logs.rbegin(); lit != logs.rend())
-        distributed = lit->cumulative_yield;
-
-    // === 3️⃣ 计算理论目标与已分配差额 ===
-    __int128 theoretical_total = (__int128)plan.goal_quantity.amount / 2;
-    __int128 buyback_amount    = (__int128)(distributed.amount * buyback_share_ratio);
-    __int128 net_distributed   = distributed.amount - buyback_amount;
-    __int128 guarantor_total_share = (__int128)(distributed.amount * guarantor_share_ratio);
-    __int128 diff = theoretical_total - net_distributed;
-
-    // === 4️⃣ 若仍需补偿担保池 ===
-    if (diff > 0) {
-        asset pay(std::min<int64_t>(diff, stats.total_guarantee_funds.amount), plan.goal_quantity.symbol);
-
-        if (pay.amount > 0) {
-            TRANSFER(plan.goal_asset_contract, _gstate.stake_contract, pay,
-                     "final guarantee payout:" + std::to_string(plan.id));
-
-            guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
-            auto it_stats = stats_tbl.find(plan.id);
-            CHECKC(it_stats != stats_tbl.end(), err::RECORD_NOT_FOUND, "no stats");
-
-            stats_tbl.modify(it_stats, same_payer, [&](auto& s) {
-                s.total_guarantee_funds -= pay;
-                s.used_guarantee_funds  += pay;
-                s.updated_at = now;
-            });
-
-            _deduct_from_guarantors(plan.id, pay);
-            record_yield_log_monthly(_gstate.yield_contract, get_self(), plan.id, pay);
-        }
-    }
-
-    // === 5️⃣ 可赎回余额 ===
+    // === 2️⃣ 可赎回余额（补足已计入分级扣减指数，重新结算） ===
     guarantor_stake_t::idx_t stakes(get_self(), plan.id);
     auto it = stakes.find(guarantor.value);
     CHECKC(it != stakes.end(), err::RECORD_NOT_FOUND, "guarantor not found");
+    _settle_guarantor(stakes, it);
 
-    asset redeemable = it->available_stake + it->locked_stake + it->earned_yield;
+    const symbol sym = plan.goal_quantity.symbol;
+    asset redeemable = it->available_stake.of(sym) + it->locked_stake.of(sym) + it->earned_yield.of(sym);
     CHECKC(quantity <= redeemable, err::QUANTITY_INSUFFICIENT, "redeem exceeds balance");
 
     _do_redeem(guarantor, plan, quantity, "redeem after project end");
@@ -465,15 +653,150 @@ void guarantyrwa::_do_redeem(const name& guarantor,
         s.updated_at = time_point_sec(current_time_point());
     });
 
-    TRANSFER(plan.goal_asset_contract, guarantor, quantity, memo);
+    POOL_PAY(plan.goal_asset_contract, guarantor, quantity, memo);
+}
+
+// ============================================================
+// 担保分级
+// ============================================================
+
+void guarantyrwa::settranches(const std::vector<uint16_t>& weights) {
+    require_auth(_gstate->admin);
+    CHECKC(weights.size() >= _gstate->tranche_weights.size() && weights.size() <= MAX_TRANCHES, err::PARAM_ERROR,
+           "tranche count must be in [" + std::to_string(_gstate->tranche_weights.size()) + ", "
+           + std::to_string(MAX_TRANCHES) + "]");
+    for (const auto& w : weights)
+        CHECKC(w > 0, err::NOT_POSITIVE, "tranche weight must be positive");
+
+    _gstate.mut().tranche_weights = weights;
+}
+
+// 旧行读出时 keeper 与分级权重取默认值，标记修改后由 _gstate 按新格式写回；重复执行无副作用
+void guarantyrwa::migrateconf() {
+    require_auth(_gstate->admin);
+    _gstate.mut();
+}
+
+// 旧版担保统计逐行搬入紧凑表：先写新行再删旧行，行数受 max_rows 限制可分多次执行
+// 旧版按年整笔补足，迁移前的保底义务视为已结清：收益期内的计划从迁移时刻起计提，
+// 补足排期从当前未结束的计划年开始；尚未成功的计划与新建计划相同，从第 1 年开始
+void guarantyrwa::migratestats(const uint16_t& max_rows) {
+    require_auth(_gstate->admin);
+    CHECKC(max_rows > 0, err::PARAM_ERROR, "max_rows must be positive");
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    legacy_stats_t::idx_t legacy(get_self(), get_self().value);
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+
+    uint16_t done = 0;
+    for (auto it = legacy.begin(); it != legacy.end() && done < max_rows; ++done) {
+        CHECKC(stats_tbl.find(it->plan_id) == stats_tbl.end(), err::RECORD_EXISTS,
+               "plan already migrated: " + std::to_string(it->plan_id));
+        stats_tbl.emplace(get_self(), [&](auto& s) {
+            s.plan_id               = it->plan_id;
+            s.total_guarantee_funds = it->total_guarantee_funds;
+            s.total_locked_funds    = it->total_locked_funds;
+            s.total_unlocked_funds  = it->total_unlocked_funds;
+            s.used_guarantee_funds  = it->used_guarantee_funds;
+            s.cumulative_yield      = it->cumulative_yield;
+            s.created_at            = it->created_at;
+            s.updated_at            = it->updated_at;
+            s.accrued_obligation    = asset(0, it->total_guarantee_funds.symbol);
+            s.delivered_yield       = asset(0, it->total_guarantee_funds.symbol);
+
+            auto plan_itr = fundplans.find(it->plan_id);
+            if (plan_itr == fundplans.end()) return;   // 计划已不存在：不再排期
+            if (plan_itr->status != PlanStatus::SUCCESS && plan_itr->status != PlanStatus::COMPLETED) {
+                _schedule_pay(s, *plan_itr, 1);
+                return;
+            }
+            s.last_accrued_at = now;
+            uint64_t year = 1;
+            while (year <= _total_years(*plan_itr) && _year_end(*plan_itr, year) <= now) ++year;
+            _schedule_pay(s, *plan_itr, year);
+        });
+        it = legacy.erase(it);
+    }
+    CHECKC(done > 0, err::RECORD_NOT_FOUND, "no legacy stats to migrate");
+}
+
+// 旧版担保人均归入首损分级（0 级），分级汇总随之累加，担保人指数取分级当前值
+// 搬迁完成前该计划冻结分红与补足扣减，分级指数保持不变，分批搬入的担保人指数一致
+void guarantyrwa::migratestake(const uint64_t& plan_id, const uint16_t& max_rows) {
+    require_auth(_gstate->admin);
+    CHECKC(max_rows > 0, err::PARAM_ERROR, "max_rows must be positive");
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    legacy_stake_t::idx_t legacy(get_self(), plan_id);
+    guarantor_stake_t::idx_t stakes(get_self(), plan_id);
+    guaranty_tranche_t::idx_t tranches(get_self(), plan_id);
+
+    uint16_t done = 0;
+    for (auto it = legacy.begin(); it != legacy.end() && done < max_rows; ++done) {
+        CHECKC(stakes.find(it->guarantor.value) == stakes.end(), err::RECORD_EXISTS,
+               "guarantor already migrated: " + it->guarantor.to_string());
+
+        auto t_itr = tranches.find(FIRST_LOSS_TRANCHE);
+        if (t_itr == tranches.end()) {
+            t_itr = tranches.emplace(get_self(), [&](auto& t) {
+                t.id = FIRST_LOSS_TRANCHE;
+            });
+        }
+        tranches.modify(t_itr, same_payer, [&](auto& t) {
+            t.total_stake += it->total_stake;
+            t.capital     += it->locked_stake;
+            t.updated_at   = now;
+        });
+        stakes.emplace(get_self(), [&](auto& s) {
+            s.guarantor       = it->guarantor;
+            s.total_stake     = it->total_stake;
+            s.available_stake = it->available_stake;
+            s.locked_stake    = it->locked_stake;
+            s.earned_yield    = it->earned_yield;
+            s.withdrawn       = it->withdrawn;
+            s.created_at      = it->created_at;
+            s.updated_at      = it->updated_at;
+            s.tranche         = FIRST_LOSS_TRANCHE;
+            s.reward_index    = t_itr->reward_index;
+            s.loss_index      = t_itr->loss_index;
+        });
+        it = legacy.erase(it);
+    }
+    CHECKC(done > 0, err::RECORD_NOT_FOUND, "no legacy stakes to migrate");
+}
+
+void guarantyrwa::migratebal(const name& bank, const symbol& sym) {
+    require_auth(_gstate->admin);
+    const asset balance = token::get_balance(bank, get_self(), sym.code());
+    CHECKC(balance.amount > 0, err::NOT_POSITIVE, "no balance to migrate");
+    POOL_IMPORT(bank, GUARANTY_MODULE, balance);
+}
+
+uint16_t guarantyrwa::_tranche_weight(const uint64_t& tranche) const {
+    return tranche < _gstate->tranche_weights.size() ? _gstate->tranche_weights[tranche] : TRANCHE_WEIGHT_BASE;
+}
+
+// 担保人结算至所在分级的当前指数
+void guarantyrwa::_settle_guarantor(guarantor_stake_t::idx_t& stakes, guarantor_stake_t::idx_t::const_iterator it) {
+    guaranty_tranche_t::idx_t tranches(get_self(), stakes.get_scope());
+    auto t_itr = tranches.find(it->tranche);
+    CHECKC(t_itr != tranches.end(), err::RECORD_NOT_FOUND, "tranche not found");
+    if (t_itr->reward_index == it->reward_index && t_itr->loss_index == it->loss_index) return;
+
+    stakes.modify(it, same_payer, [&](auto& s) {
+        s.settle(*t_itr);
+        s.updated_at = time_point_sec(current_time_point());
+    });
 }
 
 // ============================================================
 // 担保成本分摊
 // ============================================================
 
-void guarantyrwa::_deduct_from_guarantors(uint64_t plan_id, const asset& pay) {
+int64_t guarantyrwa::_deduct_from_guarantors(uint64_t plan_id, const asset& pay) {
     CHECKC(pay.amount > 0, err::NOT_POSITIVE, "invalid pay amount");
+    _check_stakes_migrated(plan_id);
 
     // === 1️⃣ 读取担保池 ===
     guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
@@ -481,44 +804,200 @@ void guarantyrwa::_deduct_from_guarantors(uint64_t plan_id, const asset& pay) {
     CHECKC(it_stats != stats_tbl.end(), err::RECORD_NOT_FOUND, "no stats");
     CHECKC(it_stats->total_guarantee_funds.amount > 0, err::PARAM_ERROR, "empty pool");
 
-    // === 2️⃣ 读取担保人表 ===
-    guarantor_stake_t::idx_t stakes(get_self(), plan_id);
-    CHECKC(stakes.begin() != stakes.end(), err::RECORD_NOT_FOUND, "no guarantors");
+    // === 2️⃣ 读取分级表与份额池 ===
+    guaranty_tranche_t::idx_t tranches(get_self(), plan_id);
+    guaranty_share_t::idx_t share_pools(get_self(), get_self().value);
+    auto share_itr = share_pools.find(plan_id);
+    const int64_t pool_assets = share_itr != share_pools.end() ? share_itr->assets.amount : 0;
+    CHECKC(pool_assets > 0 || tranches.begin() != tranches.end(), err::RECORD_NOT_FOUND, "no guarantors");
+
+    // 分级内按 total_stake 比例扣减锁定额度：累加扣减指数，担保人访问时结算
+    const time_point_sec now = time_point_sec(current_time_point());
+    auto absorb = [&](auto it, int64_t amount) {
+        tranches.modify(it, same_payer, [&](auto& t) {
+            t.loss_index            += muldiv_wide(amount, APR_INDEX_PRECISION, t.total_stake.amount);
+            t.capital.amount         = sub_floor0(t.capital.amount, amount);
+            t.absorbed_loss.amount  += amount;
+            t.updated_at             = now;
+        });
+    };
+
+    // === 3️⃣ 份额池与各分级按剩余本金比例分担，份额池只降低汇率 ===
+    int64_t remain = pay.amount;
+    if (pool_assets > 0) {
+        int64_t capital = 0;
+        for (const auto& t : tranches)
+            if (t.total_stake.amount > 0) capital += t.capital.amount;
+
+        const int64_t take = std::min(pool_assets, muldiv(pay.amount, pool_assets, (int128_t)pool_assets + capital));
+        remain -= take;
+        share_pools.modify(share_itr, same_payer, [&](auto& p) {
+            p.assets.amount        -= take;
+            p.absorbed_loss.amount += take;
+            p.updated_at            = now;
+        });
+    }
+
+    // === 4️⃣ 瀑布扣减：劣后级先以剩余本金承担，不足部分顺延至更优先的分级 ===
+    auto senior = tranches.end();
+    for (auto it = tranches.begin(); it != tranches.end() && remain > 0; ++it) {
+        if (it->total_stake.amount <= 0) continue;
+        senior = it;
 
-    // === 3️⃣ 汇总总担保量 ===
-    __int128 total_stake = 0;
-    for (const auto& s : stakes) {
-        total_stake += s.total_stake.amount;
+        const int64_t take = std::min(remain, it->capital.amount);
+        if (take <= 0) continue;
+        remain -= take;
+        absorb(it, take);
     }
-    CHECKC(total_stake > 0, err::PARAM_ERROR, "invalid total stake");
+    CHECKC(senior != tranches.end() || pool_assets > 0, err::PARAM_ERROR, "invalid total stake");
 
-    // === 4️⃣ 计算扣减比例 ===
-    int64_t total_deducted = 0;
-    const auto end_itr = std::prev(stakes.end());
+    // === 5️⃣ 各级本金均已耗尽：余额由最优先的分级承担（锁定额度扣至 0 为止） ===
+    if (remain > 0 && senior != tranches.end()) absorb(senior, remain);
 
-    for (auto it = stakes.begin(); it != stakes.end(); ++it) {
-        // ⛓ 按比例扣减
-        int64_t deduct_amt = (it != end_itr)
-            ? static_cast<int64_t>(((__int128)pay.amount * it->total_stake.amount) / total_stake)
-            : (pay.amount - total_deducted);
+    // === 6️⃣ 同步更新担保池 ===
+    stats_tbl.modify(it_stats, same_payer, [&](auto& s) {
+        s.total_guarantee_funds.amount = sub_floor0(s.total_guarantee_funds.amount, pay.amount);
+        s.used_guarantee_funds.amount  += pay.amount;
+        s.updated_at = time_point_sec(current_time_point());
+    });
+    return it_stats->total_guarantee_funds.amount;
+}
 
-        if (deduct_amt <= 0) continue;
+// ============================================================
+// 覆盖率推送（yield 收益分配按缓存的覆盖率折算担保份额）
+// ============================================================
 
-        total_deducted += deduct_amt;
-        asset deduct_asset(deduct_amt, pay.symbol);
+void guarantyrwa::_push_coverage(const fundplan_t& plan, const int64_t& funds) {
+    const uint16_t bps = plan_coverage_t::bps_of(funds, plan.goal_quantity.amount);
 
-        // 🔐 更新锁定额度
-        stakes.modify(it, get_self(), [&](auto& s) {
-            int64_t new_locked = std::max<int64_t>(0, s.locked_stake.amount - deduct_amt);
-            s.locked_stake.amount = new_locked;
-            s.updated_at = time_point_sec(current_time_point());
+    plan_coverage_t::idx_t covers(YIELD_POOL, YIELD_POOL.value);
+    auto it = covers.find(plan.id);
+    if ((it != covers.end() ? it->coverage_bps : 0) == bps) return;
+
+#ifdef RWAFI_HUB
+    rwahub::pools::yield_coverage(get_self(), plan.id, bps);
+#else
+    yieldrwa::setcoverage_action{YIELD_POOL, {get_self(), "active"_n}}.send(plan.id, bps);
+#endif
+}
+
+void guarantyrwa::synccover(const uint64_t& plan_id) {
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    auto plan_itr = fundplans.find(plan_id);
+    CHECKC(plan_itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    auto it_stats = stats_tbl.find(plan_id);
+    _push_coverage(*plan_itr, it_stats != stats_tbl.end() ? it_stats->total_guarantee_funds.amount : 0);
+}
+
+// ============================================================
+// 担保份额（份额币在担保人之间自由转让，池级事件只改池资产）
+// ============================================================
+
+void guarantyrwa::openshares(const name& submitter, const uint64_t& plan_id, const symbol_code& share_code) {
+    require_auth(submitter);
+    CHECKC(share_code.is_valid(), err::PARAM_ERROR, "invalid share symbol");
+
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    auto plan_itr = fundplans.find(plan_id);
+    CHECKC(plan_itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    CHECKC(submitter == plan_itr->creator || submitter == _gstate->admin, err::NO_AUTH,
+           "no auth to open shares of this plan");
+
+    const symbol sym(share_code, plan_itr->goal_quantity.symbol.precision());
+    guaranty_share_t::idx_t share_pools(get_self(), get_self().value);
+    auto itr = share_pools.find(plan_id);
+    if (itr == share_pools.end()) {
+        share_pools.emplace(get_self(), [&](auto& p) {
+            p.plan_id      = plan_id;
+            p.share_symbol = sym;
+            p.updated_at   = time_point_sec(current_time_point());
+        });
+    } else {
+        // 资产已被补足耗尽：换新份额币重开，旧份额币不再能赎回，汇率回到 1:1
+        CHECKC(itr->shares.amount > 0 && itr->assets.amount == 0, err::RECORD_EXISTS, "share pool already opened");
+        CHECKC(sym != itr->share_symbol, err::PARAM_ERROR, "reopen needs a new share symbol");
+        share_pools.modify(itr, same_payer, [&](auto& p) {
+            p.share_symbol  = sym;
+            p.shares.amount = 0;
+            p.updated_at    = time_point_sec(current_time_point());
         });
     }
 
-    // === 5️⃣ 同步更新担保池 ===
+    CREATE(RECEIPT_BANK, get_self(), asset(asset::max_amount, sym));
+}
+
+// 申购：按当前汇率发行份额币，先发行给本合约再转给担保人
+void guarantyrwa::_handle_share_deposit(const name& from, const fundplan_t& plan, const asset& quantity) {
+    guaranty_share_t::idx_t share_pools(get_self(), get_self().value);
+    auto itr = share_pools.find(plan.id);
+    CHECKC(itr != share_pools.end(), err::RECORD_NOT_FOUND, "plan has no share pool");
+    CHECKC(itr->shares.amount == 0 || itr->assets.amount > 0, err::INVALID_STATUS,
+           "share pool exhausted, reopen it with a new share symbol");
+
+    const asset minted(itr->to_shares(quantity.amount), itr->share_symbol);
+    CHECKC(minted.amount > 0, err::QUANTITY_INSUFFICIENT, "deposit too small for one share unit");
+
+    share_pools.modify(itr, same_payer, [&](auto& p) {
+        p.assets     += quantity;
+        p.shares     += minted;
+        p.updated_at  = time_point_sec(current_time_point());
+    });
+    _push_coverage(plan, _add_guarantee_funds(plan, quantity));
+
+    const string memo = "guaranty shares: " + std::to_string(plan.id);
+    ISSUE(RECEIPT_BANK, get_self(), minted, memo);
+    TRANSFER(RECEIPT_BANK, from, minted, memo);
+}
+
+// 赎回：份额已转入本合约，按当前汇率折算资产后销毁份额
+// 进行中的计划赎回后担保池不得低于 50% 担保线；到期先补足整个收益期的保底缺口
+void guarantyrwa::_redeem_shares(const name& owner, const asset& shares, const string& memo) {
+    CHECKC(shares.amount > 0, err::NOT_POSITIVE, "invalid redeem amount");
+
+    auto parts = split(memo, ":");
+    CHECKC(parts.size() == 2 && parts[0] == "redeem", err::INVALID_FORMAT, "memo must be redeem:<plan_id>");
+    const uint64_t plan_id = to_uint64(parts[1], "plan_id");
+
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
+    auto plan_itr = fundplans.find(plan_id);
+    CHECKC(plan_itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    const fundplan_t& plan = *plan_itr;
+
+    const bool failed = (plan.status == PlanStatus::FAILED || plan.status == PlanStatus::CANCELLED);
+    const bool ended  = (time_point_sec(current_time_point()) >= plan.return_end_time);
+    if (ended && !failed) _pay_shortfall(plan, plan.return_end_time);
+
+    // 补足已扣减池资产：在其之后读取份额池
+    guaranty_share_t::idx_t share_pools(get_self(), get_self().value);
+    auto share_itr = share_pools.find(plan_id);
+    CHECKC(share_itr != share_pools.end(), err::RECORD_NOT_FOUND, "plan has no share pool");
+    CHECKC(shares.symbol == share_itr->share_symbol, err::SYMBOL_MISMATCH, "share symbol mismatch");
+
+    const asset payout(share_itr->to_assets(shares.amount), plan.goal_quantity.symbol);
+    CHECKC(payout.amount > 0, err::QUANTITY_INSUFFICIENT, "redeem amount too small");
+
+    guaranty_stats_t::idx_t stats_tbl(get_self(), get_self().value);
+    auto it_stats = stats_tbl.find(plan_id);
+    CHECKC(it_stats != stats_tbl.end(), err::RECORD_NOT_FOUND, "no guaranty pool");
+
+    const int64_t funds = sub_floor0(it_stats->total_guarantee_funds.amount, payout.amount);
+    CHECKC(failed || ended || funds >= plan.goal_quantity.amount / 2, err::INVALID_STATUS,
+           "redeem would drop coverage below 50%");
+
+    const time_point_sec now = time_point_sec(current_time_point());
     stats_tbl.modify(it_stats, same_payer, [&](auto& s) {
-        s.total_guarantee_funds.amount = std::max<int64_t>(0, s.total_guarantee_funds.amount - pay.amount);
-        s.used_guarantee_funds.amount  += pay.amount;
-        s.updated_at = time_point_sec(current_time_point());
+        s.total_guarantee_funds.amount = funds;
+        s.updated_at                   = now;
     });
-}
\ No newline at end of file
+    share_pools.modify(share_itr, same_payer, [&](auto& p) {
+        p.shares     -= shares;
+        p.assets     -= payout;
+        p.updated_at  = now;
+    });
+    _push_coverage(plan, funds);
+
+    BURN(RECEIPT_BANK, shares, "redeem:" + std::to_string(plan_id));
+    POOL_PAY(plan.goal_asset_contract, owner, payout, "redeem shares: " + std::to_string(plan_id));
+}
@@ -1,6 +1,11 @@
 #include "investrwadb.hpp"
 #include "flon/flon.token.hpp"
 #include "flon/utils.hpp"
+#include "flon/lazy_global.hpp"
+
+#ifdef RWAFI_HUB
+#include <rwafihub.hpp>
+#endif
 
 using namespace std;
 using namespace wasm::db;
@@ -50,27 +55,16 @@ enum class investrwa_type: uint8_t {
 class [[eosio::contract("invest.rwa")]] investrwa: public eosio::contract {
 private:
     dbc                 _db;
-    dbc                 _db_stake;
-    global_singleton    _global;
-    global_t            _gstate;
+    lazy_global<global_singleton, global_t> _gstate;     // 首次访问时加载，修改后析构回写
 
 public:
     using contract::contract;
 
     investrwa(eosio::name receiver, eosio::name code, datastream<const char*> ds):
-        _db(_self),
-        _db_stake(_self),
         contract(receiver, code, ds),
-        _global(_self, _self.value)
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-
-        _db_stake = dbc( _gstate.stake_contract );
-    }
-
-    ~investrwa() {
-        _global.set(_gstate, get_self());
-    }
+        _db(_self),
+        _gstate(_self)
+    {}
 
     ACTION addtoken( const name& contract, const symbol& sym );
     ACTION deltoken( const symbol& sym );
@@ -91,7 +85,42 @@ public:
 
     ACTION cancelplan( const name& creator, const uint64_t& plan_id );
 
-    // Invest with some allowed token
+    /**
+     * 设置计划投资人白名单（计划创建者或管理员）
+     * @param merkle_root 白名单账户默克尔根（flon/merkle.hpp），全零表示取消白名单
+     */
+    ACTION setallowlist( const name& submitter, const uint64_t& plan_id, const checksum256& merkle_root );
+
+    /**
+     * 证明投资人在计划白名单内，留下一次性凭证供随后的投资转账使用
+     * 凭证绑定证明时的根：setallowlist 更换根后须重新证明
+     * @param proof 叶子到根的兄弟节点（不超过 MAX_MERKLE_PROOF 个）
+     */
+    ACTION prove( const name& investor, const uint64_t& plan_id, const std::vector<checksum256>& proof );
+
+    /**
+     * keeper 维护入口：按截止时间推进已到期计划的状态
+     * - 每推进一个计划计为一个工作单元，失败计划同时触发批量退款
+     * - 按完成的工作单元从 keeper 预算支付奖励
+     * @param keeper 调用者（奖励接收账户）
+     * @param max_work 本次最多处理的计划数（1 ~ MAX_CRANK_WORK）
+     */
+    ACTION crank( const name& keeper, const uint16_t& max_work );
+
+    // 设置每单位工作的 keeper 奖励（SING）
+    ACTION setkeeper( const asset& fee_per_work );
+
+    // 按新格式重写已部署的 global（keeper 取默认值），可重复执行
+    ACTION migrateconf();
+
+    /**
+     * 原地迁移旧版募资计划（version 为 0 的行删除后重写，补建 bydeadline 索引条目）
+     * 升级后须在任何 crank 之前执行完毕
+     * @param max_rows 本次最多迁移的行数
+     */
+    ACTION migrateplans( const uint16_t& max_rows );
+
+    // Invest with some allowed token; memo "keeper" tops up the keeper budget
     [[eosio::on_notify("*::transfer")]]
     void on_transfer(const name& from, const name& to, const asset& quantity, const string& memo);
 
@@ -99,15 +128,37 @@ public:
         require_auth( _self );
         CHECKC( is_account(admin), err::ACCOUNT_INVALID, "account invalid" );
 
-        _gstate.admin = admin;
+        _gstate.mut().admin = admin;
     }
 
     using addtoken_action    = eosio::action_wrapper<"addtoken"_n, &investrwa::addtoken>;
 
+    /**
+     * 投资金额换算回执数量：accepted × receipt_per_unit / 10^goal_precision（向下取整）
+     */
+    static int64_t calc_issue_amount(const asset& accepted, const asset& receipt_per_unit);
+
+    /**
+     * 回执换算退款金额：receipts × 10^goal_precision / receipt_per_unit（向下取整，不多于投入，可为 0）
+     */
+    static int64_t calc_refund_amount(const asset& receipts, const asset& receipt_per_unit, const symbol& goal_symbol);
+
+    /**
+     * 软顶 / 硬顶金额：goal × cap_percent / 100
+     */
+    static int64_t calc_cap_amount(const asset& goal_quantity, const uint8_t& cap_percent);
+
+    /**
+     * 按募资硬顶计算回执最大供应量
+     */
+    static int64_t calc_max_supply(const asset& goal_quantity, const uint8_t& hard_cap_percent, const asset& receipt_per_unit);
+
 private:
-    void _process_refund( const name& from, const name& to, const asset& quantity, const string& memo, fundplan_t& plan );
+    void _process_refund( const name& investor, const asset& quantity, fundplan_t& plan );
     void _process_investment( const name& from, const name& to, const asset& quantity, const string& memo, fundplan_t& plan );
     void _update_plan_status( fundplan_t& plan );
+    void _check_allowlist( const name& investor, const uint64_t& plan_id );
+    void _pay_keeper( const name& keeper, const uint32_t& done );
 
     bool _check_guarantee(const fundplan_t& plan);
 
@@ -115,5 +166,8 @@ private:
     asset _get_investor_stake_balance( const name& investor, const uint64_t& plan_id );
     // asset _get_collateral_stake_balance( const name& guanrantor, const uint64_t& plan_id );
 
+#ifdef RWAFI_HUB
+    friend struct rwahub::pools;    // hub 内池间转移直接调用入账逻辑
+#endif
 };
 } // namespace rwafi
\ No newline at end of file
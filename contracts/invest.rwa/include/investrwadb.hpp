@@ -6,8 +6,11 @@
 #include <eosio/singleton.hpp>
 #include <eosio/system.hpp>
 #include <eosio/time.hpp>
+#include <eosio/crypto.hpp>
 #include <flon/wasm_db.hpp>
+#include <flon/serialize.hpp>
 #include "flon/consts.hpp"
+#include "flon/keeper.hpp"
 
 using namespace eosio;
 using namespace std;
@@ -37,16 +40,23 @@ namespace PlanStatus {
 }
 
 
+// keeper 为追加列：已部署的旧行原地读出默认值，migrateconf 按新格式重写
 NTBL("global") global_t {
     name            admin;
-    name            stake_contract      = STAKE_POOL;
+    name            stake_contract      = STAKE_POOL;       // 以下三列仅兼容旧表结构，地址取自 consts.hpp
     name            yield_contract      = YIELD_POOL;
     name            guaranty_contract   = GUARANTY_POOL;
     uint64_t        last_plan_id        = 0;
+    keeper_conf_t   keeper;                                 // crank 激励预算
 
-    EOSLIB_SERIALIZE( global_t, (admin)(stake_contract)(yield_contract)(guaranty_contract)(last_plan_id) )
+    FLON_SERIALIZE_EXT( global_t, (admin)(stake_contract)(yield_contract)(guaranty_contract)(last_plan_id), (keeper) )
 };
+#ifdef RWAFI_HUB
+// hub 构建中四个模块共用一个账户，各自的 global 单例分表存放
+typedef eosio::singleton< "investglobal"_n, global_t > global_singleton;
+#else
 typedef eosio::singleton< "global"_n, global_t > global_singleton;
+#endif
 
 // whitlisted investment tokens
 //
@@ -99,22 +109,65 @@ TBL fundplan_t {                                    //scope: _self
     asset               total_raised_funds;        // 已募集数量
     asset               total_issued_receipts;     // 已发凭证数量
     name                status = PlanStatus::PENDING; //募资计划状态
+    uint8_t             version = 0;               // 行版本：0 为旧版行（缺 bydeadline 索引条目），新建计划写入 CURRENT_VERSION
+
+    static constexpr uint8_t CURRENT_VERSION = 1;
 
     uint64_t primary_key() const { return id; }
 
+    // 下一次按时间推进状态的时刻（crank 按此排序），终态为 max
+    uint64_t by_deadline() const {
+        if (status == PlanStatus::PENDING)      return start_time.sec_since_epoch();
+        if (status == PlanStatus::RAISEACTIVE)  return (uint64_t)end_time.sec_since_epoch() + 1;
+        if (status == PlanStatus::SUCCESS)      return return_end_time.sec_since_epoch();
+        return std::numeric_limits<uint64_t>::max();
+    }
+
     fundplan_t(){}
     fundplan_t( const uint64_t& i ): id(i){}
 
-    typedef eosio::multi_index<"fundplans"_n, fundplan_t> idx_t;
+    // 旧版行由 migrateplans 原地删除重写，补建 bydeadline 索引条目
+    typedef eosio::multi_index<"fundplans"_n, fundplan_t,
+        indexed_by<"bydeadline"_n, const_mem_fun<fundplan_t, uint64_t, &fundplan_t::by_deadline>>
+    > idx_t;
 
-    EOSLIB_SERIALIZE( fundplan_t, (id)(title)(creator)(goal_asset_contract)(goal_quantity)(created_at)
+    FLON_SERIALIZE_EXT( fundplan_t, (id)(title)(creator)(goal_asset_contract)(goal_quantity)(created_at)
                                         (receipt_asset_contract)(receipt_symbol)(receipt_quantity_per_unit)
                                         (soft_cap_percent)(hard_cap_percent)
                                         (start_time)(end_time)
                                         (return_months)(return_end_time)
                                         (guaranteed_yield_apr)
-                                        (total_raised_funds)(total_issued_receipts)(status) )
+                                        (total_raised_funds)(total_issued_receipts)(status), (version) )
+
+};
+
+static constexpr uint8_t MAX_MERKLE_PROOF = 32;     // 白名单证明最大深度（2^32 个账户）
+
+// 计划投资人白名单：只存默克尔根（见 flon/merkle.hpp），无记录的计划不限制投资人
+TBL plan_allowlist_t {                              //scope: _self
+    uint64_t            plan_id;                    //PK: 募资计划ID
+    checksum256         merkle_root;                //白名单账户默克尔根
+    time_point_sec      updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    typedef eosio::multi_index<"allowlists"_n, plan_allowlist_t> idx_t;
+
+    EOSLIB_SERIALIZE( plan_allowlist_t, (plan_id)(merkle_root)(updated_at) )
+};
+
+// 白名单证明通过的凭证：prove 写入（投资人付 RAM），该投资人下一笔投资时消耗并删除
+// 通常与投资转账放在同一交易内，不常驻；记下证明所用的根，白名单更换后旧凭证失效
+TBL invest_pass_t {                                 //scope: plan_id
+    name                investor;                   //PK: 投资人
+    checksum256         merkle_root;                //证明时的白名单根
+    time_point_sec      proved_at;
+
+    uint64_t primary_key() const { return investor.value; }
+
+    typedef eosio::multi_index<"investpass"_n, invest_pass_t> idx_t;
 
+    EOSLIB_SERIALIZE( invest_pass_t, (investor)(merkle_root)(proved_at) )
 };
 
 } // namespace rwafi
\ No newline at end of file
@@ -7,6 +7,9 @@
 #include <eosio/crypto.hpp>
 #include "guaranty.rwa/guarantyrwadb.hpp"
 #include "flon/flon.token.hpp"
+#include "flon/calendar.hpp"
+#include "flon/decimal.hpp"
+#include "flon/merkle.hpp"
 
 using std::chrono::system_clock;
 using namespace wasm;
@@ -17,6 +20,25 @@ static constexpr name RECEIPT_TOKEN_BANK{"rwafi.token"_n};
 static constexpr eosio::name active_perm  {"active"_n};
 
 // ------------------- Internal functions ------------------------------------------------------
+int64_t investrwa::calc_issue_amount(const asset& accepted, const asset& receipt_per_unit) {
+    return muldiv(accepted.amount, receipt_per_unit.amount, pow10(accepted.symbol.precision()));
+}
+
+int64_t investrwa::calc_refund_amount(const asset& receipts, const asset& receipt_per_unit, const symbol& goal_symbol) {
+    // refund = 用户RCP × 10^goal_precision / 每1SING对应RCP；不足一个最小单位的尘埃回执退 0
+    return muldiv(receipts.amount, pow10(goal_symbol.precision()), receipt_per_unit.amount);
+}
+
+int64_t investrwa::calc_cap_amount(const asset& goal_quantity, const uint8_t& cap_percent) {
+    return muldiv(goal_quantity.amount, cap_percent, 100);
+}
+
+int64_t investrwa::calc_max_supply(const asset& goal_quantity, const uint8_t& hard_cap_percent, const asset& receipt_per_unit) {
+    // 硬顶全部募满时发行的回执数量
+    const asset hard_cap(calc_cap_amount(goal_quantity, hard_cap_percent), goal_quantity.symbol);
+    return calc_issue_amount(hard_cap, receipt_per_unit);
+}
+
 asset investrwa::_get_balance(const name& token_contract, const name& owner, const symbol& sym) {
     eosio::multi_index<"accounts"_n, flon::token::account> account_tbl(token_contract, owner.value);
     auto itr = account_tbl.find(sym.code().raw());
@@ -24,7 +46,7 @@ asset investrwa::_get_balance(const name& token_contract, const name& owner, con
 }
 
 asset investrwa::_get_investor_stake_balance(const name& investor, const uint64_t& plan_id) {
-    staker_t::tbl_t stakers(_gstate.stake_contract, plan_id);  // scope 是 plan_id
+    staker_t::tbl_t stakers(STAKE_POOL, plan_id);  // scope 是 plan_id
     auto itr = stakers.find(investor.value);
     CHECKC(itr != stakers.end(), err::RECORD_NOT_FOUND, "no stake record for plan: " + std::to_string(plan_id));
     return itr->avl_staked;   // ✅ 返回投资者可用质押余额
@@ -64,8 +86,11 @@ void investrwa::_process_investment(const name& from, const name&, const asset&
            err::TOKEN_NOT_ALLOWED,
            "token not allowed: " + quantity.symbol.code().to_string());
 
+    // === Step 3.5: 白名单计划校验投资人 ===
+    _check_allowlist(from, plan.id);
+
     // === Step 4: 计算可接受金额与硬顶 ===
-    const int64_t hard_cap = plan.goal_quantity.amount * plan.hard_cap_percent / 100;
+    const int64_t hard_cap = calc_cap_amount(plan.goal_quantity, plan.hard_cap_percent);
     const int64_t remaining = hard_cap - plan.total_raised_funds.amount;
     CHECKC(remaining > 0, err::INVALID_STATUS, "hard cap reached");
 
@@ -81,15 +106,7 @@ void investrwa::_process_investment(const name& from, const name&, const asset&
     CHECKC(plan.receipt_quantity_per_unit.symbol == plan.receipt_symbol, err::SYMBOL_MISMATCH, "receipt symbol mismatch");
 
     // === Step 6: 精度安全计算 ===
-    auto _pow10 = [](uint8_t p) -> int64_t {
-        int64_t v = 1;
-        while (p-- > 0) v *= 10;
-        return v;
-    };
-
-    __int128 raw = (__int128)accepted.amount * plan.receipt_quantity_per_unit.amount;
-    int64_t issue_amount = (int64_t)(raw / _pow10(plan.goal_quantity.symbol.precision()));
-
+    int64_t issue_amount = calc_issue_amount(accepted, plan.receipt_quantity_per_unit);
     CHECKC(issue_amount > 0, err::INVALID_FORMAT, "issued receipt amount too small");
     asset issued_receipt(issue_amount, plan.receipt_symbol);
 
@@ -99,8 +116,12 @@ void investrwa::_process_investment(const name& from, const name&, const asset&
 
     // === Step 8: 发放回执并转入 stake 池 ===
     ISSUE(plan.receipt_asset_contract, get_self(), issued_receipt, "plan:" + std::to_string(plan.id));
-    TRANSFER(plan.receipt_asset_contract, _gstate.stake_contract, issued_receipt,
+#ifdef RWAFI_HUB
+    rwahub::pools::stake_receipts(get_self(), plan.receipt_asset_contract, from, issued_receipt, plan.id);
+#else
+    TRANSFER(plan.receipt_asset_contract, STAKE_POOL, issued_receipt,
              "stake:" + std::to_string(plan.id) + ":" + from.to_string());
+#endif
 
     // === Step 9: 处理超额退款 ===
     if (refund.amount > 0) {
@@ -113,22 +134,27 @@ void investrwa::_process_investment(const name& from, const name&, const asset&
     _update_plan_status(plan);
 }
 
-void investrwa::_process_refund(const name& from,const name&,const asset& quantity,const string& memo,fundplan_t& plan) {
+// 无白名单的计划只多一次查表；有白名单时消耗 prove 留下的凭证（须为当前根下的证明）
+void investrwa::_check_allowlist(const name& investor, const uint64_t& plan_id) {
+    plan_allowlist_t::idx_t allowlists(_self, _self.value);
+    auto list_itr = allowlists.find(plan_id);
+    if (list_itr == allowlists.end()) return;
+
+    invest_pass_t::idx_t passes(_self, plan_id);
+    auto pass_itr = passes.find(investor.value);
+    CHECKC(pass_itr != passes.end(), err::NO_AUTH,
+           "investor not proven for allowlisted plan: " + investor.to_string());
+    CHECKC(pass_itr->merkle_root == list_itr->merkle_root, err::NO_AUTH,
+           "allowlist changed since proof, prove again: " + investor.to_string());
+    passes.erase(pass_itr);
+}
+
+void investrwa::_process_refund(const name& investor,const asset& quantity,fundplan_t& plan) {
     // ===  基础检查 ===
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "refund must be positive");
     CHECKC(plan.status == PlanStatus::CANCELLED || plan.status == PlanStatus::FAILED,
            err::INVALID_STATUS, "refund not allowed in current plan status");
     CHECKC(quantity.symbol == plan.receipt_symbol, err::SYMBOL_MISMATCH, "receipt symbol mismatch");
-
-    // ===  memo 解析: refund:<plan_id>:<investor> ===
-    auto parts = split(memo, ":");
-    CHECKC(parts.size() == 3 && parts[0] == "refund",
-           err::INVALID_FORMAT, "invalid memo format, expect refund:<plan_id>:<investor>");
-
-    uint64_t memo_plan_id = std::stoull(parts[1]);
-    CHECKC(memo_plan_id == plan.id, err::PARAM_ERROR, "plan_id mismatch in memo");
-
-    name investor = name(parts[2]);
     CHECKC(is_account(investor), err::ACCOUNT_INVALID, "invalid investor account");
 
     // ===  参数有效性校验 ===
@@ -136,21 +162,8 @@ void investrwa::_process_refund(const name& from,const name&,const asset& quanti
     CHECKC(plan.goal_quantity.amount > 0, err::INVALID_FORMAT, "invalid goal quantity");
 
     // ===  精度换算 ===
-    auto pow10 = [](int n)->int64_t { int64_t v = 1; while (n-- > 0) v *= 10; return v; };
-
-    const int goal_precision   = plan.goal_quantity.symbol.precision();
-    const int receipt_precision = plan.receipt_symbol.precision();
-
-    __int128 q_rcp_min    = (__int128)quantity.amount;
-    __int128 r_per_1g_min = (__int128)plan.receipt_quantity_per_unit.amount;
-    int64_t pow10G = pow10(goal_precision);
-
-    // refund_min = 用户RCP × 10^goal_precision / 每1SING对应RCP
-    __int128 refund_min128 = (q_rcp_min * (__int128)pow10G) / r_per_1g_min;
-    CHECKC(refund_min128 > 0 && refund_min128 <= std::numeric_limits<int64_t>::max(),
-           err::PARAM_ERROR, "refund overflow or invalid ratio");
-
-    asset refund_amount((int64_t)refund_min128, plan.goal_quantity.symbol);
+    asset refund_amount(calc_refund_amount(quantity, plan.receipt_quantity_per_unit, plan.goal_quantity.symbol),
+                        plan.goal_quantity.symbol);
 
     // ===  资金充足性验证 ===
     CHECKC(plan.total_raised_funds.amount >= refund_amount.amount,
@@ -162,15 +175,14 @@ void investrwa::_process_refund(const name& from,const name&,const asset& quanti
     BURN(plan.receipt_asset_contract, quantity,
          "burn receipt for refund, plan:" + std::to_string(plan.id));
 
-    // ===  返还本金 ===
-    TRANSFER(plan.goal_asset_contract, investor, refund_amount,
-             "refund principal for plan:" + std::to_string(plan.id));
+    // ===  返还本金（尘埃回执只销毁，不阻塞批量退款） ===
+    if (refund_amount.amount > 0)
+        TRANSFER(plan.goal_asset_contract, investor, refund_amount,
+                 "refund principal for plan:" + std::to_string(plan.id));
 
     // ===  更新统计 ===
-    plan.total_raised_funds.amount =
-        std::max<int64_t>(0, plan.total_raised_funds.amount - refund_amount.amount);
-    plan.total_issued_receipts.amount =
-        std::max<int64_t>(0, plan.total_issued_receipts.amount - quantity.amount);
+    plan.total_raised_funds.amount    = sub_floor0(plan.total_raised_funds.amount, refund_amount.amount);
+    plan.total_issued_receipts.amount = sub_floor0(plan.total_issued_receipts.amount, quantity.amount);
 
     // ===  若所有退款完成 ===
     if (plan.total_raised_funds.amount == 0 && plan.total_issued_receipts.amount == 0) {
@@ -183,8 +195,8 @@ void investrwa::_process_refund(const name& from,const name&,const asset& quanti
 void investrwa::_update_plan_status(fundplan_t& plan) {
     const time_point_sec now = time_point_sec(current_time_point());
     const int64_t raised    = plan.total_raised_funds.amount;
-    const int64_t soft_cap  = plan.goal_quantity.amount * plan.soft_cap_percent / 100;
-    const int64_t hard_cap  = plan.goal_quantity.amount * plan.hard_cap_percent / 100;
+    const int64_t soft_cap  = calc_cap_amount(plan.goal_quantity, plan.soft_cap_percent);
+    const int64_t hard_cap  = calc_cap_amount(plan.goal_quantity, plan.hard_cap_percent);
 
     // === Step 1: 待开始 → 募资中 ===
     if (plan.status == PlanStatus::PENDING && now >= plan.start_time) {
@@ -222,24 +234,18 @@ void investrwa::_update_plan_status(fundplan_t& plan) {
         }
     }
 
-    // === Step 4: 已完成（收益期结束） ===
-    if (plan.status == PlanStatus::COMPLETED) {
-        return;
-    }
-
-    // === Step 5: 失败、取消、退款状态 ===
-    if (plan.status == PlanStatus::FAILED ||
-        plan.status == PlanStatus::CANCELLED ||
-        plan.status == PlanStatus::REFUNDED) {
-        return;
-    }
-
-    // === Step 6: 持久化状态 ===
+    // === Step 4: 持久化状态（含 COMPLETED / FAILED 等终态迁移） ===
     _db.set(plan, get_self());
 }
 
+void investrwa::_pay_keeper(const name& keeper, const uint32_t& done) {
+    const asset reward = _gstate.mut().keeper.charge(done);
+    if (reward.amount > 0)
+        TRANSFER(SING_BANK, keeper, reward, "crank reward: " + std::to_string(done));
+}
+
 void investrwa::addtoken(const name& contract, const symbol& sym ) {
-    CHECKC( has_auth( _self) || has_auth( _gstate.admin ), err::NO_AUTH, "no auth to add token" )
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to add token" )
 
     auto token          = allow_token_t( sym );
     CHECKC( !_db.get( token ), err::RECORD_NOT_FOUND, "Token symbol already existing" )
@@ -251,7 +257,7 @@ void investrwa::addtoken(const name& contract, const symbol& sym ) {
 }
 
 void investrwa::deltoken( const symbol& sym ) {
-    CHECKC( has_auth( _self) || has_auth( _gstate.admin ), err::NO_AUTH, "no auth to add token" )
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to add token" )
 
     auto token = allow_token_t( sym );
     CHECKC( _db.get( token ), err::RECORD_NOT_FOUND, "no such token symbol" )
@@ -259,7 +265,7 @@ void investrwa::deltoken( const symbol& sym ) {
 }
 
 void investrwa::onshelf( const symbol& sym, const bool& onshelf ) {
-    CHECKC( has_auth( _self) || has_auth( _gstate.admin ), err::NO_AUTH, "no auth to add token" )
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to add token" )
 
     auto token = allow_token_t( sym );
     CHECKC( _db.get( token ), err::RECORD_NOT_FOUND, "no such token symbol" )
@@ -267,9 +273,10 @@ void investrwa::onshelf( const symbol& sym, const bool& onshelf ) {
     _db.set( token, _self );
 }
 
-// 支持两种格式：
+// 支持三种格式：
 // ① memo: plan:<plan_id>
 // ② memo: refund:<plan_id>:<investor>
+// ③ memo: keeper（SING，充值 keeper 预算）
 void investrwa::on_transfer(const name& from,const name& to,const asset& quantity,const string& memo) {
     if (from == _self || to != _self) return;
 
@@ -277,6 +284,14 @@ void investrwa::on_transfer(const name& from,const name& to,const asset& quantit
     CHECKC(!memo.empty(), err::INVALID_FORMAT, "memo required");
 
     const name bank = get_first_receiver();
+
+    // === keeper 预算充值 ===
+    if (memo == KEEPER_MEMO) {
+        CHECKC(bank == SING_BANK && quantity.symbol == SING_SYM, err::TOKEN_NOT_ALLOWED, "keeper budget must be SING");
+        _gstate.mut().keeper.budget += quantity;
+        return;
+    }
+
     auto parts = split(memo, ":");
     CHECKC(parts.size() >= 2, err::INVALID_FORMAT, "invalid memo format");
 
@@ -329,7 +344,7 @@ void investrwa::on_transfer(const name& from,const name& to,const asset& quantit
                "refund not allowed (plan status: " + plan.status.to_string() + ")");
 
         // --- 执行退款 ---
-        _process_refund(from, to, quantity, memo, plan);
+        _process_refund(investor, quantity, plan);
         return;
     }
 
@@ -373,7 +388,7 @@ void investrwa::createplan(
            "receipt symbol must start with 'ST' (e.g. STUSD)");
 
     // ===  生成 plan_id 并实例化 ===
-    auto plan_id = ++_gstate.last_plan_id;
+    auto plan_id = ++_gstate.mut().last_plan_id;
     fundplan_t plan(plan_id);
 
     // ===  确保回执代币不存在 ===
@@ -383,15 +398,7 @@ void investrwa::createplan(
            "receipt token already exists: " + sym_code);
 
     // ===  计算最大供应量（根据硬顶） ===
-    int64_t goal_unit = 1;
-    for (int i = 0; i < goal_quantity.symbol.precision(); ++i)
-        goal_unit *= 10;
-
-    __int128 G_hard = (__int128)goal_quantity.amount * hard_cap_percent / 100; // 募资硬顶
-    __int128 R = (__int128)receipt_quantity_per_unit.amount;                   // 每单位目标资产对应 receipt 单位
-    __int128 max_amt128 = (G_hard * R) / goal_unit;
-    int64_t max_amt = (int64_t)max_amt128;
-
+    int64_t max_amt = calc_max_supply(goal_quantity, hard_cap_percent, receipt_quantity_per_unit);
     CHECKC(max_amt > 0, err::INVALID_FORMAT, "computed max supply invalid");
 
     // ===  创建 Receipt Token ===
@@ -410,16 +417,17 @@ void investrwa::createplan(
     plan.start_time                = time_point_sec(start_time.sec_since_epoch());
     plan.end_time                  = time_point_sec(end_time.sec_since_epoch());
     plan.return_months             = return_months;
-    plan.return_end_time           = time_point_sec(start_time.sec_since_epoch() + return_months * seconds_per_month);
+    plan.return_end_time           = time_point_sec(calendar::add_months(start_time.sec_since_epoch(), return_months));
     plan.guaranteed_yield_apr      = guaranteed_yield_apr;
     plan.total_raised_funds        = asset(0, goal_quantity.symbol);
     plan.total_issued_receipts     = asset(0, receipt_quantity_per_unit.symbol);
     plan.status                    = PlanStatus::PENDING;
     plan.created_at                = time_point(current_time_point());
+    plan.version                   = fundplan_t::CURRENT_VERSION;
 
     // ===  通知 stake 合约同步创建计划 ===
     rwafi::stakerwa::addplan_action{
-        _gstate.stake_contract,
+        STAKE_POOL,
         { permission_level{ get_self(), "active"_n } }
     }.send(plan_id, receipt_quantity_per_unit.symbol);
 
@@ -453,8 +461,145 @@ void investrwa::cancelplan(const name& creator, const uint64_t& plan_id) {
 
     // === 触发 stake 合约执行批量退款 ===
     rwafi::stakerwa::batchunstake_action{
-        _gstate.stake_contract,
+        STAKE_POOL,
         { permission_level{ get_self(), "active"_n } }
     }.send(plan_id);
 
 }
+
+void investrwa::setallowlist(const name& submitter, const uint64_t& plan_id, const checksum256& merkle_root) {
+    require_auth(submitter);
+
+    fundplan_t plan(plan_id);
+    CHECKC(_db.get(plan), err::RECORD_NOT_FOUND, "no such fund plan id: " + std::to_string(plan_id));
+    CHECKC(submitter == plan.creator || submitter == _gstate->admin, err::NO_AUTH,
+           "no auth to set allowlist of this plan");
+
+    plan_allowlist_t::idx_t allowlists(_self, _self.value);
+    auto itr = allowlists.find(plan_id);
+
+    // === 全零根：取消白名单 ===
+    if (merkle_root == checksum256()) {
+        CHECKC(itr != allowlists.end(), err::RECORD_NOT_FOUND, "plan has no allowlist");
+        allowlists.erase(itr);
+        return;
+    }
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    if (itr == allowlists.end()) {
+        allowlists.emplace(submitter, [&](auto& a) {
+            a.plan_id     = plan_id;
+            a.merkle_root = merkle_root;
+            a.updated_at  = now;
+        });
+    } else {
+        allowlists.modify(itr, same_payer, [&](auto& a) {
+            a.merkle_root = merkle_root;
+            a.updated_at  = now;
+        });
+    }
+}
+
+void investrwa::prove(const name& investor, const uint64_t& plan_id, const std::vector<checksum256>& proof) {
+    require_auth(investor);
+    CHECKC(proof.size() <= MAX_MERKLE_PROOF, err::PARAM_ERROR,
+           "proof deeper than " + std::to_string(MAX_MERKLE_PROOF));
+
+    plan_allowlist_t::idx_t allowlists(_self, _self.value);
+    auto list_itr = allowlists.find(plan_id);
+    CHECKC(list_itr != allowlists.end(), err::RECORD_NOT_FOUND, "plan has no allowlist");
+    CHECKC(merkle_verify(list_itr->merkle_root, investor, proof), err::NO_AUTH,
+           "investor not in plan allowlist: " + investor.to_string());
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    invest_pass_t::idx_t passes(_self, plan_id);
+    auto pass_itr = passes.find(investor.value);
+    if (pass_itr == passes.end()) {
+        passes.emplace(investor, [&](auto& p) {
+            p.investor    = investor;
+            p.merkle_root = list_itr->merkle_root;
+            p.proved_at   = now;
+        });
+    } else if (pass_itr->merkle_root != list_itr->merkle_root) {
+        passes.modify(pass_itr, same_payer, [&](auto& p) {
+            p.merkle_root = list_itr->merkle_root;
+            p.proved_at   = now;
+        });
+    }
+}
+
+
+void investrwa::setkeeper(const asset& fee_per_work) {
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to set keeper fee" )
+    CHECKC( fee_per_work.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper fee must be SING" )
+    CHECKC( fee_per_work.amount >= 0, err::NOT_POSITIVE, "keeper fee must not be negative" )
+
+    _gstate.mut().keeper.fee_per_work = fee_per_work;
+}
+
+// 旧行读出时 keeper 取默认值，标记修改后由 _gstate 按新格式写回；重复执行无副作用
+void investrwa::migrateconf() {
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to migrate config" )
+    _gstate.mut();
+}
+
+// 旧版计划原地重写：删除后按原主键重新写入以建立 bydeadline 索引条目，行数受 max_rows 限制可分多次执行
+// 旧行的索引条目缺失，状态推进前的 modify 会失败，因此须在升级后、crank 之前执行完毕
+void investrwa::migrateplans(const uint16_t& max_rows) {
+    CHECKC( has_auth( _self) || has_auth( _gstate->admin ), err::NO_AUTH, "no auth to migrate plans" )
+    CHECKC( max_rows > 0, err::PARAM_ERROR, "max_rows must be positive" )
+
+    fundplan_t::idx_t plans( _self, _self.value );
+
+    uint16_t done = 0;
+    for (auto it = plans.begin(); it != plans.end() && done < max_rows; ) {
+        if (it->version == fundplan_t::CURRENT_VERSION) { ++it; continue; }
+
+        fundplan_t plan = *it;
+        plan.version    = fundplan_t::CURRENT_VERSION;
+        it = plans.erase(it);
+        plans.emplace( _self, [&](auto& p) { p = plan; } );
+        ++done;
+    }
+    CHECKC( done > 0, err::RECORD_NOT_FOUND, "no legacy plans to migrate" )
+}
+
+void investrwa::crank(const name& keeper, const uint16_t& max_work) {
+    require_auth(keeper);
+    CHECKC(max_work > 0 && max_work <= MAX_CRANK_WORK, err::PARAM_ERROR,
+           "max_work must be in [1, " + std::to_string(MAX_CRANK_WORK) + "]");
+
+    const uint64_t now = current_time_point().sec_since_epoch();
+    uint16_t steps = 0, done = 0;   // done 仅统计实际推进状态的计划
+    std::vector<uint64_t> stuck;    // 到期却未能推进的计划：本次跳过，不阻塞其后的计划
+
+    while (steps < max_work) {
+        // 每轮重新打开表：_update_plan_status 经 _db 写入，避免读到缓存的旧行
+        fundplan_t::idx_t plans(_self, _self.value);
+        auto deadlines = plans.get_index<"bydeadline"_n>();
+        auto itr = deadlines.begin();
+        while (itr != deadlines.end() && std::find(stuck.begin(), stuck.end(), itr->id) != stuck.end()) ++itr;
+        if (itr == deadlines.end() || itr->by_deadline() > now) break;
+
+        fundplan_t plan = *itr;
+        const name prev = plan.status;
+        _update_plan_status(plan);
+        ++steps;
+        if (plan.status == prev) {
+            stuck.push_back(plan.id);
+            continue;
+        }
+
+        // 募资失败：触发 stake 合约退回全部凭证
+        if (plan.status == PlanStatus::FAILED) {
+            rwafi::stakerwa::batchunstake_action{
+                STAKE_POOL,
+                { permission_level{ get_self(), "active"_n } }
+            }.send(plan.id);
+        }
+        ++done;
+    }
+
+    CHECKC(done > 0, err::NOT_EXPIRED, "no overdue plan to crank");
+    _pay_keeper(keeper, done);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+
+namespace flon {
+
+using namespace eosio;
+
+/**
+ * 不带符号的金额（8 字节，asset 为 16 字节）
+ * - 用于按计划存放、符号恒为计划 goal 符号的历史/统计表列
+ * - 符号由 action 从计划中解析一次，读取时用 of(sym) 还原为 asset
+ * - 可由 asset 隐式构造，+= / -= 与 asset 一样做溢出检查
+ */
+struct amount64 {
+    int64_t amount = 0;
+
+    amount64() = default;
+    amount64(const asset& a): amount(a.amount) {}
+
+    asset of(const symbol& sym) const { return asset(amount, sym); }
+
+    amount64& operator+=(const amount64& a) {
+        amount += a.amount;
+        check(-asset::max_amount <= amount, "subtraction underflow");
+        check(amount <= asset::max_amount, "addition overflow");
+        return *this;
+    }
+
+    amount64& operator-=(const amount64& a) {
+        amount -= a.amount;
+        check(-asset::max_amount <= amount, "subtraction underflow");
+        check(amount <= asset::max_amount, "addition overflow");
+        return *this;
+    }
+
+    EOSLIB_SERIALIZE(amount64, (amount))
+};
+
+} // namespace flon
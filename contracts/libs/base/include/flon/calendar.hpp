@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * constexpr proleptic-Gregorian calendar helpers (UTC only).
+ *
+ * Built on the days-from-civil / civil-from-days algorithms so period keys
+ * can be derived from a block timestamp with a handful of integer ops,
+ * without pulling libc time code (gmtime/tm) into the wasm binaries.
+ *
+ * Periods are encoded as YYYYMM (e.g. 202511) to stay compatible with the
+ * `period` primary keys of yieldhist / payments.
+ */
+namespace flon { namespace calendar {
+
+static constexpr int64_t SECONDS_PER_DAY    = 24 * 3600;
+static constexpr uint32_t MONTHS_PER_YEAR   = 12;
+
+struct civil_t {
+    int32_t     year;
+    uint32_t    month;      // 1..12
+    uint32_t    day;        // 1..31
+};
+
+inline constexpr bool is_leap(int32_t y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+inline constexpr uint32_t days_in_month(int32_t y, uint32_t m) {
+    return m == 2 ? (is_leap(y) ? 29 : 28)
+                  : ((m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31);
+}
+
+// days since 1970-01-01 of civil date y-m-d
+inline constexpr int64_t days_from_civil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    const int64_t  era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = (uint32_t)(y - era * 400);                            // [0, 399]
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;      // [0, 365]
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                // [0, 146096]
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+// civil date of the given number of days since 1970-01-01
+inline constexpr civil_t civil_from_days(int64_t z) {
+    z += 719468;
+    const int64_t  era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = (uint32_t)(z - era * 146097);                         // [0, 146096]
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);              // [0, 365]
+    const uint32_t mp  = (5 * doy + 2) / 153;                                  // [0, 11]
+    const uint32_t d   = doy - (153 * mp + 2) / 5 + 1;                         // [1, 31]
+    const uint32_t m   = mp < 10 ? mp + 3 : mp - 9;                            // [1, 12]
+    return { (int32_t)(yoe + era * 400 + (m <= 2)), m, d };
+}
+
+inline constexpr civil_t civil_from_seconds(uint32_t sec) {
+    return civil_from_days((int64_t)sec / SECONDS_PER_DAY);
+}
+
+inline constexpr uint64_t to_period(int32_t y, uint32_t m) {
+    return (uint64_t)y * 100 + m;
+}
+
+// YYYYMM of a UTC timestamp
+inline constexpr uint64_t to_period(uint32_t sec) {
+    const civil_t c = civil_from_seconds(sec);
+    return to_period(c.year, c.month);
+}
+
+// running month counter (year * 12 + month - 1), handy for month arithmetic
+inline constexpr int64_t month_ordinal(int32_t y, uint32_t m) {
+    return (int64_t)y * MONTHS_PER_YEAR + (m - 1);
+}
+
+inline constexpr int64_t period_ordinal(uint64_t period) {
+    return month_ordinal((int32_t)(period / 100), (uint32_t)(period % 100));
+}
+
+inline constexpr uint64_t period_from_ordinal(int64_t ord) {
+    return to_period((int32_t)(ord / MONTHS_PER_YEAR), (uint32_t)(ord % MONTHS_PER_YEAR) + 1);
+}
+
+inline constexpr uint64_t period_add_months(uint64_t period, int64_t months) {
+    return period_from_ordinal(period_ordinal(period) + months);
+}
+
+/**
+ * Shift a timestamp by whole calendar months, keeping the time of day.
+ * The day is clamped to the target month's length (Jan 31 + 1 => Feb 28/29).
+ */
+inline constexpr uint32_t add_months(uint32_t sec, int64_t months) {
+    const int64_t  days = (int64_t)sec / SECONDS_PER_DAY;
+    const int64_t  tod  = (int64_t)sec - days * SECONDS_PER_DAY;
+    const civil_t  c    = civil_from_days(days);
+    const int64_t  ord  = month_ordinal(c.year, c.month) + months;
+    const int32_t  y    = (int32_t)(ord / MONTHS_PER_YEAR);
+    const uint32_t m    = (uint32_t)(ord % MONTHS_PER_YEAR) + 1;
+    const uint32_t dim  = days_in_month(y, m);
+    const uint32_t d    = c.day > dim ? dim : c.day;
+    return (uint32_t)(days_from_civil(y, m, d) * SECONDS_PER_DAY + tod);
+}
+
+/**
+ * 0-based index of the calendar month containing `now`, counted from the
+ * calendar month containing `start` (same month => 0). Negative before start.
+ */
+inline constexpr int64_t plan_month_index(uint32_t start, uint32_t now) {
+    const civil_t s = civil_from_seconds(start);
+    const civil_t n = civil_from_seconds(now);
+    return month_ordinal(n.year, n.month) - month_ordinal(s.year, s.month);
+}
+
+// 1-based plan year containing `now` (0 before the plan starts)
+inline constexpr uint64_t plan_year_index(uint32_t start, uint32_t now) {
+    const int64_t mi = plan_month_index(start, now);
+    return mi < 0 ? 0 : (uint64_t)(mi / MONTHS_PER_YEAR) + 1;
+}
+
+// first YYYYMM period of the 1-based plan `year`
+inline constexpr uint64_t plan_year_first_period(uint32_t start, uint64_t year) {
+    return period_add_months(to_period(start), (int64_t)(year - 1) * MONTHS_PER_YEAR);
+}
+
+// one-past-last YYYYMM period of the 1-based plan `year`: [first, end)
+inline constexpr uint64_t plan_year_end_period(uint32_t start, uint64_t year) {
+    return period_add_months(to_period(start), (int64_t)year * MONTHS_PER_YEAR);
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(days_from_civil(2000, 3, 1) == 11017);
+static_assert(to_period(1767225599u) == 202512);          // 2025-12-31T23:59:59Z
+static_assert(to_period(1767225600u) == 202601);          // 2026-01-01T00:00:00Z
+static_assert(period_add_months(202511, 14) == 202701);
+static_assert(plan_year_end_period(1762746300u, 1) == 202611);
+
+} } // namespace flon::calendar
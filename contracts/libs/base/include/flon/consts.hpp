@@ -10,14 +10,30 @@ static constexpr eosio::name SING_BANK              {"sing.token"_n};    // SING
 
 static constexpr eosio::symbol SING_SYM             = eosio::symbol("SING", 8);
 
+#ifdef RWAFI_HUB
+// 单合约部署（rwafi.hub）：四个池模块同驻一个账户，池间转移为 hub 内部记账
+static constexpr eosio::name RWAFI_HUB_POOL         = "rwafi.hub"_n;
+static constexpr eosio::name STAKE_POOL             = RWAFI_HUB_POOL;
+static constexpr eosio::name INVEST_POOL            = RWAFI_HUB_POOL;
+static constexpr eosio::name GUARANTY_POOL          = RWAFI_HUB_POOL;
+static constexpr eosio::name YIELD_POOL             = RWAFI_HUB_POOL;
+static constexpr eosio::name VAULT_POOL             = RWAFI_HUB_POOL;
+#else
 static constexpr eosio::name STAKE_POOL             = "stake1111"_n;       //stake.rwa
 static constexpr eosio::name INVEST_POOL            = "investrwa112"_n;      //invest.rwa
 static constexpr eosio::name GUARANTY_POOL          = "guaranty1111"_n;    //guaranty.rwa
 static constexpr eosio::name YIELD_POOL             = "yieldrwa1111"_n;       //yield.rwa
+static constexpr eosio::name VAULT_POOL             = "vaultrwa1111"_n;    //vault.rwa：stake/yield/guaranty 的资金托管
+#endif
 static constexpr eosio::name SWAP_POOL              = "flon.swap"_n;
 
+// 池模块名：存入 vault / hub 的转账 memo 前缀 <pool>/<memo>
+static constexpr eosio::name INVEST_MODULE          = "invest"_n;
+static constexpr eosio::name STAKE_MODULE           = "stake"_n;
+static constexpr eosio::name YIELD_MODULE           = "yield"_n;
+static constexpr eosio::name GUARANTY_MODULE        = "guaranty"_n;
+
 
-static constexpr uint64_t seconds_per_month     = 30 *  24 * 3600;
 static constexpr uint64_t seconds_per_year      = 365 * 24 * 3600;
 static constexpr uint64_t DAY_SECONDS           = 24 * 3600;
 static constexpr uint32_t MAX_TITLE_SIZE        = 64;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <eosio/check.hpp>
+
+/**
+ * Checked fixed-point decimal math shared by every rwafi contract.
+ *
+ * All asset conversions go through muldiv: the product is formed in int128,
+ * the quotient rounds down (never pays out more than owed), and any result
+ * that leaves its range is rejected instead of being truncated by a cast.
+ * Operands are non-negative amounts; signed deltas stay with the callers.
+ */
+namespace flon {
+
+static constexpr uint8_t MAX_DECIMALS = 18;
+
+static constexpr int64_t POW10[MAX_DECIMALS + 1] = {
+    1LL,
+    10LL,
+    100LL,
+    1000LL,
+    10000LL,
+    100000LL,
+    1000000LL,
+    10000000LL,
+    100000000LL,
+    1000000000LL,
+    10000000000LL,
+    100000000000LL,
+    1000000000000LL,
+    10000000000000LL,
+    100000000000000LL,
+    1000000000000000LL,
+    10000000000000000LL,
+    100000000000000000LL,
+    1000000000000000000LL
+};
+
+inline int64_t pow10(uint8_t decimals) {
+    eosio::check(decimals <= MAX_DECIMALS, "decimals should be <= 18");
+    return POW10[decimals];
+}
+
+/**
+ * a × b / c, rounded down, checked to fit the result type
+ * products and quotients below 2^64 take the 64-bit divide instead of the int128 one
+ */
+inline __int128 muldiv_wide(__int128 a, __int128 b, __int128 c) {
+    eosio::check(a >= 0 && b >= 0 && c > 0, "muldiv: negative operand or zero divisor");
+    // two operands below 2^63 can never overflow the product
+    if ((a | b) >> 63)
+        eosio::check(a == 0 || b <= std::numeric_limits<__int128>::max() / a, "muldiv: product overflow");
+
+    const __int128 p = a * b;
+    if ((p >> 64) == 0 && (c >> 64) == 0)
+        return (uint64_t)p / (uint64_t)c;
+    return p / c;
+}
+
+inline int64_t muldiv(__int128 a, __int128 b, __int128 c) {
+    const __int128 q = muldiv_wide(a, b, c);
+    eosio::check(q <= std::numeric_limits<int64_t>::max(), "muldiv: result overflow");
+    return (int64_t)q;
+}
+
+// a - b，不足时为 0（余额与统计的下限保护）
+inline int64_t sub_floor0(int64_t a, int64_t b) {
+    return a > b ? a - b : 0;
+}
+
+} // namespace flon
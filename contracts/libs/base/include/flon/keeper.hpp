@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <eosio/asset.hpp>
+#include <flon/consts.hpp>
+
+namespace flon {
+
+using namespace eosio;
+
+static constexpr uint16_t MAX_CRANK_WORK        = 20;           // 单次 crank 最多执行的工作单元
+static constexpr const char* KEEPER_MEMO        = "keeper";     // keeper 预算充值 memo
+
+/**
+ * keeper 激励配置（嵌入各合约 global_t）
+ * - 预算通过 sing.token 转账 memo "keeper" 充值
+ * - 每完成一个工作单元支付 fee_per_work，预算不足时按余额支付
+ */
+struct keeper_conf_t {
+    asset           fee_per_work    = asset(0, SING_SYM);       // 每单位工作奖励
+    asset           budget          = asset(0, SING_SYM);       // 剩余预算
+    asset           paid            = asset(0, SING_SYM);       // 累计已支付
+
+    asset charge(const uint32_t& done) {
+        const __int128 due128 = (__int128)fee_per_work.amount * done;
+        const int64_t  due    = (int64_t)std::min<__int128>(due128, budget.amount);
+        budget.amount -= due;
+        paid.amount   += due;
+        return asset(due, budget.symbol);
+    }
+
+    EOSLIB_SERIALIZE(keeper_conf_t, (fee_per_work)(budget)(paid))
+};
+
+} // namespace flon
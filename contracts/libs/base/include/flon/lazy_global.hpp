@@ -0,0 +1,52 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+namespace flon {
+
+using namespace eosio;
+
+/**
+ * 按需加载的 global 单例（替代构造时读取、析构时回写的 _gstate）
+ * - 首次访问时才读表：未用到配置的 action / 直接返回的通知不产生数据库读写
+ * - 只读访问用 -> / *；修改前调用 mut()，析构时只回写被修改过的状态
+ * - 关联合约地址不放在这里，使用 consts.hpp 中按构建（独立部署 / RWAFI_HUB）选定的常量
+ */
+template<typename Singleton, typename T>
+class lazy_global {
+public:
+    explicit lazy_global(const name& self): _self(self), _tbl(self, self.value) {}
+
+    lazy_global(const lazy_global&)            = delete;
+    lazy_global& operator=(const lazy_global&) = delete;
+
+    ~lazy_global() {
+        if (_dirty) _tbl.set(_value, _self);
+    }
+
+    const T& operator*()  const { return _load(); }
+    const T* operator->() const { return &_load(); }
+
+    T& mut() {
+        _load();
+        _dirty = true;
+        return _value;
+    }
+
+private:
+    const T& _load() const {
+        if (!_loaded) {
+            _value  = _tbl.get_or_default(T{});
+            _loaded = true;
+        }
+        return _value;
+    }
+
+    name                _self;
+    mutable Singleton   _tbl;
+    mutable T           _value;
+    mutable bool        _loaded = false;
+    bool                _dirty  = false;
+};
+
+} // namespace flon
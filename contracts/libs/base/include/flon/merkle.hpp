@@ -0,0 +1,39 @@
+#pragma once
+
+#include <eosio/crypto.hpp>
+#include <eosio/name.hpp>
+#include <array>
+#include <vector>
+
+namespace flon {
+
+using namespace eosio;
+
+/**
+ * 账户白名单默克尔树
+ * - 叶子 = sha256(账户名 8 字节，小端，与 pack(name) 相同)
+ * - 父节点 = sha256(较小子节点 || 较大子节点)：子节点按字节序排序，证明只需兄弟节点、不需方向位
+ * - 校验为 O(log n) 次哈希，链上只存根，不为每个账户建行
+ */
+inline checksum256 merkle_leaf(const name& account) {
+    char buf[8];
+    for (int i = 0; i < 8; ++i) buf[i] = char(account.value >> (8 * i));
+    return sha256(buf, sizeof(buf));
+}
+
+inline checksum256 merkle_parent(const checksum256& a, const checksum256& b) {
+    const auto lo = (a < b ? a : b).extract_as_byte_array();
+    const auto hi = (a < b ? b : a).extract_as_byte_array();
+    std::array<uint8_t, 64> buf;
+    std::copy(lo.begin(), lo.end(), buf.begin());
+    std::copy(hi.begin(), hi.end(), buf.begin() + 32);
+    return sha256(reinterpret_cast<const char*>(buf.data()), buf.size());
+}
+
+inline bool merkle_verify(const checksum256& root, const name& account, const std::vector<checksum256>& proof) {
+    checksum256 node = merkle_leaf(account);
+    for (const auto& sibling : proof) node = merkle_parent(node, sibling);
+    return node == root;
+}
+
+} // namespace flon
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+
+namespace flon {
+
+using namespace eosio;
+
+/**
+ * 按计划拆分的一笔金额
+ * - 批量收益分配（yield distribute）的输入，以及 vault movebatch / guaranty addyields 的明细行
+ * - 一次转移只汇总一笔金额，收款池按明细逐计划入账
+ */
+struct plan_alloc_t {
+    uint64_t    plan_id = 0;
+    asset       quantity;
+
+    EOSLIB_SERIALIZE(plan_alloc_t, (plan_id)(quantity))
+};
+
+} // namespace flon
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <eosio/serialize.hpp>
+
+/**
+ * 已部署表追加列后原地兼容旧行（不换表名、不搬表）
+ * - MEMBERS 为旧版已有的列，EXT_MEMBERS 为追加在末尾的列
+ * - 读取时行数据已读完则跳过剩余追加列，保留其默认值；写回时总是写入完整的新格式
+ * - 追加列只能加在末尾、按版本顺序排列；ABI 中为普通字段，旧行须经对应的 migrate 动作重写后 RPC 才能解析
+ */
+#define FLON_READ_EXT_MEMBER(r, OP, elem) \
+    if (ds.remaining()) ds >> t.elem;
+
+#define FLON_SERIALIZE_EXT(TYPE, MEMBERS, EXT_MEMBERS)                                  \
+    template<typename DataStream>                                                       \
+    friend DataStream& operator<<(DataStream& ds, const TYPE& t) {                      \
+        ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, <<, MEMBERS);                \
+        return ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, <<, EXT_MEMBERS);     \
+    }                                                                                   \
+    template<typename DataStream>                                                       \
+    friend DataStream& operator>>(DataStream& ds, TYPE& t) {                            \
+        ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS);                \
+        BOOST_PP_SEQ_FOR_EACH(FLON_READ_EXT_MEMBER, _, EXT_MEMBERS)                     \
+        return ds;                                                                      \
+    }
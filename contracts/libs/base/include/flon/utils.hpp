@@ -7,6 +7,7 @@
 #include <eosio/asset.hpp>
 
 #include "safe.hpp"
+#include "decimal.hpp"
 #include "errno.h"
 
 using namespace std;
@@ -72,21 +73,23 @@ inline constexpr int64_t power(int64_t base, int64_t exp) {
     return ret;
 }
 
-inline constexpr int64_t power10(int64_t exp) {
-    return power(10, exp);
+// exp in [0, 18]: table lookup instead of a multiply loop
+inline int64_t power10(int64_t exp) {
+    CHECK(exp >= 0 && exp <= flon::MAX_DECIMALS, "power10 exponent should be in [0, 18]");
+    return flon::POW10[exp];
 }
 
-inline constexpr int64_t calc_precision(int64_t digit) {
+inline int64_t calc_precision(int64_t digit) {
     return power10(digit);
 }
 
-string_view trim(string_view sv) {
+inline string_view trim(string_view sv) {
     sv.remove_prefix(std::min(sv.find_first_not_of(" "), sv.size())); // left trim
     sv.remove_suffix(std::min(sv.size()-sv.find_last_not_of(" ")-1, sv.size())); // right trim
     return sv;
 }
 
-std::vector<std::string> split(const std::string& s, const std::string& delimiter) {
+inline std::vector<std::string> split(const std::string& s, const std::string& delimiter) {
     std::vector<std::string> result;
     size_t pos_start = 0, pos_end;
     auto delim_len = delimiter.length();
@@ -99,18 +102,18 @@ std::vector<std::string> split(const std::string& s, const std::string& delimite
 }
 
 
-bool starts_with(string_view sv, string_view s) {
+inline bool starts_with(string_view sv, string_view s) {
     return sv.size() >= s.size() && sv.compare(0, s.size(), s) == 0;
 }
 
-int64_t to_int64(string_view s, const char* err_title) {
+inline int64_t to_int64(string_view s, const char* err_title) {
     errno = 0;
     uint64_t ret = std::strtoll(s.data(), nullptr, 10);
     CHECK(errno == 0, string(err_title) + ": convert str to int64 error: " + std::strerror(errno));
     return ret;
 }
 
-uint64_t to_uint64(string_view s, const char* err_title) {
+inline uint64_t to_uint64(string_view s, const char* err_title) {
     errno = 0;
     uint64_t ret = std::strtoull(s.data(), nullptr, 10);
     CHECK(errno == 0, string(err_title) + ": convert str to uint64 error: " + std::strerror(errno));
@@ -120,12 +123,8 @@ uint64_t to_uint64(string_view s, const char* err_title) {
 template <class T>
 void precision_from_decimals(int8_t decimals, T& p10)
 {
-    CHECK(decimals <= 18, "symbol precision should be <= 18");
-    p10 = 1;
-    T p = decimals;
-    while( p > 0  ) {
-        p10 *= 10; --p;
-    }
+    CHECK(decimals >= 0 && decimals <= flon::MAX_DECIMALS, "symbol precision should be <= 18");
+    p10 = flon::POW10[decimals];
 }
 
 static symbol symbol_from_string(string_view from)
@@ -141,7 +140,7 @@ static symbol symbol_from_string(string_view from)
     return symbol(name_part, p);
 }
 
-asset asset_from_string(string_view from)
+inline asset asset_from_string(string_view from)
 {
     string_view s = trim(from);
 
@@ -183,12 +182,12 @@ asset asset_from_string(string_view from)
     return asset(amount.value, sym);
 }
 
-uint128_t make128key(uint64_t a, uint64_t b) {
+inline uint128_t make128key(uint64_t a, uint64_t b) {
     uint128_t aa = a;
     uint128_t bb = b;
     return (aa << 64) + bb;
 }
 
-checksum256 make256key(uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+inline checksum256 make256key(uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
     return checksum256::make_from_word_sequence<uint64_t>(a,b,c,d);
 }
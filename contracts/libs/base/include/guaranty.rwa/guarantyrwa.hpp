@@ -1,7 +1,8 @@
 #pragma once
 
 #include "guarantyrwadb.hpp"
-#include <investrwa/investrwadb.hpp>
+#include <flon/plan_alloc.hpp>
+#include <invest.rwa/investrwadb.hpp>
 namespace rwafi {
 
 using namespace eosio;
@@ -36,17 +37,16 @@ public:
     ACTION setgconf(const uint64_t& plan_id, const uint16_t& coverage_ratio_bp);
 
     /**
-     * @notice 担保收益支付（按月触发）
-     * @param submitter 发起者（管理员）
+     * @notice 担保收益补足（按计划年触发）
+     * @param submitter 发起者
      * @param plan_id RWA 计划ID
-     * @param months 支付月数（>=1）
+     * @param year 计划年（从 1 开始，须已结束）
      *
      * @details
-     * - 每月担保额 = goal_quantity × (APR / 10000) / 12
-     * - 实际支付 = 每月担保额 × months × (coverage_ratio_bp / 10000)
-     * - 从合约余额发放到 _gstate.stake_contract
+     * - 应付保底收益按 guaranteed_yield_apr 计提（guaranty_stats_t.accrued_obligation）
+     * - 实际支付 = 截至年末的计提额 - 已交付收益，从担保池发放到 STAKE_POOL
      */
-    ACTION guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& months);
+    ACTION guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& year);
 
     /**
      * @notice 担保人赎回质押资金
@@ -55,6 +55,19 @@ public:
      * @param quantity 要赎回的资金数量
      */
     ACTION redeem(const name& guarantor, const uint64_t& plan_id, const asset& quantity);
+
+    /**
+     * @notice 收益合约通知投资人收益已交付（仅 yield 合约可调用）
+     * @param plan_id RWA 计划ID
+     * @param quantity 本次交付给 stake 池的投资人收益
+     */
+    ACTION addyield(const uint64_t& plan_id, const asset& quantity);
+
+    // 批量收益分配时的 addyield，每个计划一条明细
+    ACTION addyields(const std::vector<plan_alloc_t>& allocs);
+
+    using addyield_action  = eosio::action_wrapper<"addyield"_n, &guarantyrwa::addyield>;
+    using addyields_action = eosio::action_wrapper<"addyields"_n, &guarantyrwa::addyields>;
 };
 
 } // namespace rwafi
\ No newline at end of file
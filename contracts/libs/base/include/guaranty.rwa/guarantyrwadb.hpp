@@ -11,6 +11,8 @@
 #include <flon/flon.token.hpp>
 #include <flon/utils.hpp>
 #include <flon/consts.hpp>
+#include <flon/decimal.hpp>
+#include <flon/amount.hpp>
 
 namespace rwafi {
 
@@ -24,55 +26,168 @@ static constexpr eosio::name active_perm{"active"_n};
 #define TBL struct [[eosio::table, eosio::contract("guaranty.rwa")]]
 #define NTBL(name) struct [[eosio::table(name), eosio::contract("guaranty.rwa")]]
 
+static constexpr int128_t APR_INDEX_PRECISION = 1'000'000'000'000'000'000; // 10^18
+
+// 担保分级：id 即瀑布顺序，id 越小越先承担保底补足（0 = 劣后 / first-loss）
+static constexpr uint8_t  FIRST_LOSS_TRANCHE    = 0;
+static constexpr uint8_t  SENIOR_TRANCHE        = 1;
+static constexpr uint8_t  MAX_TRANCHES          = 4;
+static constexpr uint16_t TRANCHE_WEIGHT_BASE   = 10000;  // 收益权重 1 倍
+
 /**
  * 担保统计（按计划）
+ * 金额均为计划 goal 符号，只存 amount，读取时用 of(plan.goal_quantity.symbol) 还原
  * scope: self
  */
 TBL guaranty_stats_t {
     uint64_t        plan_id;
-    asset           total_guarantee_funds;     // 担保池总额
-    asset           total_locked_funds;        // 当前应锁定的总担保额
-    asset           total_unlocked_funds;      // 已可解押但未取走总额
-    asset           used_guarantee_funds;      // 担保已使用
-    asset           cumulative_yield;          // 担保池累计分红（投资人部分）
+    amount64        total_guarantee_funds;     // 担保池总额
+    amount64        total_locked_funds;        // 当前应锁定的总担保额
+    amount64        total_unlocked_funds;      // 已可解押但未取走总额
+    amount64        used_guarantee_funds;      // 担保已使用
+    amount64        cumulative_yield;          // 担保池累计分红（投资人部分）
     time_point_sec created_at;
     time_point_sec updated_at;
 
+    // === 保底收益计提（guaranteed_yield_apr） ===
+    amount64        accrued_obligation;        // 截至 last_accrued_at 的累计应付保底收益
+    amount64        delivered_yield;           // 已交付投资人收益（收益分配 + 担保补足）
+    time_point_sec  last_accrued_at;           // 上次计提时间
+
+    // === 年度补足排期（crank） ===
+    uint16_t        next_pay_year = 1;         // 下一个待补足的计划年（从 1 开始）
+    time_point_sec  next_pay_at;               // 该计划年结束时间（0 表示无待补足年度）
+
+    // 当前计提点的保底缺口
+    int64_t shortfall() const {
+        return sub_floor0(accrued_obligation.amount, delivered_yield.amount);
+    }
+
     uint64_t primary_key() const { return plan_id; }
+    uint64_t by_next_pay() const {
+        return next_pay_at.sec_since_epoch() == 0 ? std::numeric_limits<uint64_t>::max()
+                                                  : next_pay_at.sec_since_epoch();
+    }
 
     guaranty_stats_t() {}
     guaranty_stats_t(const uint64_t& pid): plan_id(pid) {}
 
-    typedef eosio::multi_index<"guarantystat"_n, guaranty_stats_t> idx_t;
+    typedef eosio::multi_index<"guarstats"_n, guaranty_stats_t,
+        indexed_by<"bynextpay"_n, const_mem_fun<guaranty_stats_t, uint64_t, &guaranty_stats_t::by_next_pay>>
+    > idx_t;
 
     EOSLIB_SERIALIZE(guaranty_stats_t,
         (plan_id)(total_guarantee_funds)(total_locked_funds)(total_unlocked_funds)(used_guarantee_funds)(cumulative_yield)
-        (created_at)(updated_at))
+        (created_at)(updated_at)
+        (accrued_obligation)(delivered_yield)(last_accrued_at)
+        (next_pay_year)(next_pay_at))
+};
+
+/**
+ * 担保分级（按计划）
+ * 分级内的分红与补足扣减以每单位本金的累计指数记账；
+ * 收益按 本金 × 权重 在分级间分配，补足按 id 顺序逐级承担（先劣后、后优先）
+ * 金额为计划 goal 符号，只存 amount
+ * scope: plan_id
+ */
+TBL guaranty_tranche_t {
+    uint64_t        id;                        // 分级 id（瀑布顺序）
+    amount64        total_stake;               // 分级内担保人 total_stake 合计
+    amount64        capital;                   // 剩余可承担补足的本金（存入 - 已承担）
+    amount64        earned_yield;              // 分级累计分红
+    amount64        absorbed_loss;             // 分级累计承担的保底补足
+    int128_t        reward_index = 0;          // 每单位 total_stake 累计分红（×APR_INDEX_PRECISION）
+    int128_t        loss_index   = 0;          // 每单位 total_stake 累计扣减锁定（×APR_INDEX_PRECISION）
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return id; }
+
+    guaranty_tranche_t() {}
+    guaranty_tranche_t(const uint64_t& tid): id(tid) {}
+
+    typedef eosio::multi_index<"tranches"_n, guaranty_tranche_t> idx_t;
+
+    EOSLIB_SERIALIZE(guaranty_tranche_t,
+        (id)(total_stake)(capital)(earned_yield)(absorbed_loss)(reward_index)(loss_index)(updated_at))
 };
 
 /**
  * 担保人质押记录
+ * 分红 / 扣减按所在分级的累计指数在访问时结算（settle），不随担保人数遍历
+ * 金额为计划 goal 符号，只存 amount
  * scope: plan_id
  */
 TBL guarantor_stake_t {
     name       guarantor;            // 担保人账户
-    asset      total_stake;          // 总质押本金
-    asset      available_stake;      // 可赎回部分（动态更新）
-    asset      locked_stake;         // 已锁定（未可解押）
-    asset      earned_yield;         // 累计担保分红收益
-    asset      withdrawn;            // 已取走金额（总计）
+    amount64   total_stake;          // 总质押本金
+    amount64   available_stake;      // 可赎回部分（动态更新）
+    amount64   locked_stake;         // 已锁定（未可解押）
+    amount64   earned_yield;         // 累计担保分红收益
+    amount64   withdrawn;            // 已取走金额（总计）
     time_point_sec created_at;
     time_point_sec updated_at;
 
+    uint8_t    tranche       = FIRST_LOSS_TRANCHE;  // 所在分级
+    int128_t   reward_index  = 0;                   // 上次结算时的分级分红指数
+    int128_t   loss_index    = 0;                   // 上次结算时的分级扣减指数
+
     uint64_t primary_key() const { return guarantor.value; }
 
     guarantor_stake_t() {}
     guarantor_stake_t(const name& g): guarantor(g) {}
 
-    typedef eosio::multi_index<"stakes"_n, guarantor_stake_t> idx_t;
+    // 结算至分级当前指数：分红计入 earned_yield / available_stake，扣减从 locked_stake 中扣除
+    void settle(const guaranty_tranche_t& t) {
+        const int64_t reward = muldiv(total_stake.amount, t.reward_index - reward_index, APR_INDEX_PRECISION);
+        const int64_t loss   = muldiv(total_stake.amount, t.loss_index - loss_index, APR_INDEX_PRECISION);
+        earned_yield.amount    += reward;
+        available_stake.amount += reward;
+        locked_stake.amount     = sub_floor0(locked_stake.amount, loss);
+        reward_index = t.reward_index;
+        loss_index   = t.loss_index;
+    }
+
+    typedef eosio::multi_index<"guarantors"_n, guarantor_stake_t> idx_t;
 
     EOSLIB_SERIALIZE(guarantor_stake_t,
-        (guarantor)(total_stake)(available_stake)(locked_stake)(earned_yield)(withdrawn)(created_at)(updated_at))
+        (guarantor)(total_stake)(available_stake)(locked_stake)(earned_yield)(withdrawn)(created_at)(updated_at)
+        (tranche)(reward_index)(loss_index))
+};
+
+/**
+ * 担保份额池（按计划）
+ * 担保人持有 rwafi.token 发行的份额币，不再按人记账：分红与补足扣减只改 assets，
+ * 份额按 assets / shares 的汇率申购与赎回，可在担保人之间自由转让
+ * assets 为计划 goal 符号，shares 为 share_symbol，只存 amount
+ * scope: self
+ */
+TBL guaranty_share_t {
+    uint64_t        plan_id;
+    symbol          share_symbol;              // 份额币符号（精度同 goal，由本合约在 rwafi.token 创建并发行）
+    amount64        assets;                    // 份额池资产：申购本金 + 分红 - 承担补足 - 赎回
+    amount64        shares;                    // 流通份额
+    amount64        earned_yield;              // 累计分红
+    amount64        absorbed_loss;             // 累计承担的保底补足
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    // 按当前汇率折算：首笔申购 1:1；资产归零后份额不再可兑换
+    int64_t to_shares(const int64_t& amount) const {
+        if (shares.amount == 0) return amount;
+        return assets.amount == 0 ? 0 : muldiv(amount, shares.amount, assets.amount);
+    }
+    int64_t to_assets(const int64_t& share_amount) const {
+        return shares.amount == 0 ? 0 : muldiv(share_amount, assets.amount, shares.amount);
+    }
+
+    guaranty_share_t() {}
+    guaranty_share_t(const uint64_t& pid): plan_id(pid) {}
+
+    typedef eosio::multi_index<"sharepools"_n, guaranty_share_t> idx_t;
+
+    EOSLIB_SERIALIZE(guaranty_share_t,
+        (plan_id)(share_symbol)(assets)(shares)(earned_yield)(absorbed_loss)(updated_at))
 };
 
 /**
@@ -7,6 +7,7 @@
 #include <eosio/system.hpp>
 #include <eosio/time.hpp>
 #include <flon/wasm_db.hpp>
+#include <flon/serialize.hpp>
 #include "flon/consts.hpp"
 
 using namespace eosio;
@@ -17,12 +18,6 @@ using namespace flon;
 
 #define SYMBOL(sym_code, precision) symbol(symbol_code(sym_code), precision)
 
-static constexpr uint64_t seconds_per_month     = 30 *  24 * 3600;
-static constexpr uint64_t seconds_per_year      = 365 * 24 * 3600;
-static constexpr uint64_t DAY_SECONDS           = 24 * 36000;
-static constexpr uint32_t MAX_TITLE_SIZE        = 64;
-static constexpr uint8_t  EXPIRY_HOURS          = 12;
-
 namespace rwafi {
 
 #define TBL struct [[eosio::table, eosio::contract("invest.rwa")]]
@@ -92,21 +87,35 @@ TBL fundplan_t {                                    //scope: _self
     asset               total_raised_funds;        // 已募集数量
     asset               total_issued_receipts;     // 已发凭证数量
     name                status = PlanStatus::PENDING; //募资计划状态
+    uint8_t             version = 0;               // 行版本：0 为旧版行（缺 bydeadline 索引条目），新建计划写入 CURRENT_VERSION
+
+    static constexpr uint8_t CURRENT_VERSION = 1;
 
     uint64_t primary_key() const { return id; }
 
+    // 下一次按时间推进状态的时刻（crank 按此排序），终态为 max
+    uint64_t by_deadline() const {
+        if (status == PlanStatus::PENDING)      return start_time.sec_since_epoch();
+        if (status == PlanStatus::RAISEACTIVE)  return (uint64_t)end_time.sec_since_epoch() + 1;
+        if (status == PlanStatus::SUCCESS)      return return_end_time.sec_since_epoch();
+        return std::numeric_limits<uint64_t>::max();
+    }
+
     fundplan_t(){}
     fundplan_t( const uint64_t& i ): id(i){}
 
-    typedef eosio::multi_index<"fundplans"_n, fundplan_t> idx_t;
+    // 旧版行由 invest.rwa migrateplans 原地删除重写，补建 bydeadline 索引条目
+    typedef eosio::multi_index<"fundplans"_n, fundplan_t,
+        indexed_by<"bydeadline"_n, const_mem_fun<fundplan_t, uint64_t, &fundplan_t::by_deadline>>
+    > idx_t;
 
-    EOSLIB_SERIALIZE( fundplan_t, (id)(title)(creator)(goal_asset_contract)(goal_quantity)(created_at)
+    FLON_SERIALIZE_EXT( fundplan_t, (id)(title)(creator)(goal_asset_contract)(goal_quantity)(created_at)
                                         (receipt_asset_contract)(receipt_symbol)(receipt_quantity_per_unit)
                                         (soft_cap_percent)(hard_cap_percent)
                                         (start_time)(end_time)
                                         (return_months)(return_end_time)
                                         (guaranteed_yield_apr)
-                                        (total_raised_funds)(total_issued_receipts)(status) )
+                                        (total_raised_funds)(total_issued_receipts)(status), (version) )
 
 };
 
@@ -11,6 +11,7 @@
 #include <flon/consts.hpp>
 #include "flon/utils.hpp"
 #include "flon/wasm_db.hpp"
+#include "flon/serialize.hpp"
 
 namespace rwafi {
 
@@ -41,17 +42,31 @@ struct [[eosio::table, eosio::contract("stake.rwa")]] stake_plan_t {
     asset               total_staked;                               // 当前质押总额
     stake_reward_st     reward_state;                               // 奖励进度记录
     time_point_sec      created_at;                                 // 创建时间
+    time_point_sec      refund_started_at;                          // 批量退款开始时间（0 表示未退款）
+    uint8_t             version = 0;                                // 行版本：0 为旧版行（缺 byrefund 索引条目），新建计划写入 CURRENT_VERSION
+
+    static constexpr uint8_t CURRENT_VERSION = 1;
 
     stake_plan_t() {}
     stake_plan_t(const uint64_t& i): plan_id(i) {}
 
     uint64_t primary_key() const { return plan_id; }
+    // 待分页退款的计划按开始时间排序，未退款为 max
+    uint64_t by_refund() const {
+        return refund_started_at.sec_since_epoch() == 0 ? std::numeric_limits<uint64_t>::max()
+                                                        : refund_started_at.sec_since_epoch();
+    }
 
-    typedef eosio::multi_index<"stakeplans"_n, stake_plan_t> tbl_t;
+    // 旧版行由 stake.rwa migratepools 原地删除重写，补建 byrefund 索引条目
+    typedef eosio::multi_index<
+        "stakeplans"_n,
+        stake_plan_t,
+        indexed_by<"byrefund"_n, const_mem_fun<stake_plan_t, uint64_t, &stake_plan_t::by_refund>>
+    > tbl_t;
 
-    EOSLIB_SERIALIZE(stake_plan_t,
+    FLON_SERIALIZE_EXT(stake_plan_t,
         (plan_id)(receipt_symbol)(cum_staked)(total_staked)
-        (reward_state)(created_at))
+        (reward_state)(created_at), (refund_started_at)(version))
 };
 
 //Scope: code
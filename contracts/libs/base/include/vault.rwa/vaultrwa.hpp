@@ -0,0 +1,100 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/time.hpp>
+#include <string>
+#include "flon/consts.hpp"
+#include "flon/flon.token.hpp"
+#include "flon/plan_alloc.hpp"
+
+namespace rwafi {
+
+using namespace eosio;
+using std::string;
+using namespace flon;
+
+/**
+ * vault.rwa 的池合约侧接口
+ * stake / yield / guaranty 的资金托管在 vault：
+ *   - 用户存入：转账到 vault，memo <pool>/<memo>，vault 记账后把转账通知转发给池
+ *   - 池间转移：POOL_MOVE，只改 vault 子账，收款池通过 on_notify("vaultrwa1111::move") 入账
+ *     多个计划一次转移用 POOL_MOVE_BATCH，收款池通过 on_notify("vaultrwa1111::movebatch") 逐计划入账
+ *   - 转给用户：POOL_PAY，由 vault 从本池子账转出
+ *   - 升级导入：POOL_IMPORT，池合约升级前自己持有的余额整笔转入 vault（memo <pool>/migrate）记入本池子账
+ * hub 部署（RWAFI_HUB）下 VAULT_POOL 即 hub 自身：存入由 hub 路由，转给用户直接 TRANSFER
+ */
+// 池子账（scope = 池合约账户），与 vault.rwa/include/vaultrwadb.hpp 一致
+struct [[eosio::table, eosio::contract("vault.rwa")]] ledger_t {
+    extended_asset  balance;
+    time_point_sec  updated_at;
+
+    ledger_t() {}
+
+    uint64_t primary_key() const { return balance.quantity.symbol.code().raw(); }
+
+    typedef eosio::multi_index<"ledgers"_n, ledger_t> idx_t;
+
+    EOSLIB_SERIALIZE( ledger_t, (balance)(updated_at) )
+};
+
+class [[eosio::contract("vault.rwa")]] vaultrwa : public contract {
+public:
+    using contract::contract;
+
+    ACTION move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id);
+    ACTION movebatch(const name& from_pool, const name& to_pool, const name& bank, const std::vector<plan_alloc_t>& allocs);
+    ACTION withdraw(const name& pool, const name& to, const extended_asset& quantity, const string& memo);
+
+    using move_action       = eosio::action_wrapper<"move"_n, &vaultrwa::move>;
+    using movebatch_action  = eosio::action_wrapper<"movebatch"_n, &vaultrwa::movebatch>;
+    using withdraw_action   = eosio::action_wrapper<"withdraw"_n, &vaultrwa::withdraw>;
+};
+
+/**
+ * 池合约收到转账通知时判断是否是存入本池
+ * @param module 本池模块名（memo 前缀）
+ * @param inner  去掉 <pool>/ 前缀后的 memo
+ * @return false 表示与本池无关（转出、转给其他池的存入）
+ */
+inline bool vault_deposit(const name& self, [[maybe_unused]] const name& module, const name& from, const name& to,
+                          const string& memo, string& inner) {
+    if (from == VAULT_POOL || to != VAULT_POOL) {
+        check(to != self, "deposit through " + VAULT_POOL.to_string() + " with memo <pool>/<memo>");
+        return false;
+    }
+    if (from == self) return false;     // POOL_IMPORT：vault 已记入本池子账，池内无需记账
+#ifdef RWAFI_HUB
+    inner = memo;       // hub 已按前缀路由并去掉前缀
+    return true;
+#else
+    const string prefix = module.to_string() + "/";
+    if (memo.compare(0, prefix.size(), prefix) != 0) return false;
+    inner = memo.substr(prefix.size());
+    return true;
+#endif
+}
+
+} // namespace rwafi
+
+#ifdef RWAFI_HUB
+#define POOL_PAY(bank, to, quantity, memo) TRANSFER(bank, to, quantity, memo)
+
+#define POOL_IMPORT(bank, module, quantity) \
+    check(false, "hub holds pool balances itself");
+#else
+#define POOL_PAY(bank, to, quantity, memo) \
+    {	rwafi::vaultrwa::withdraw_action act{ VAULT_POOL, { {_self, active_perm} } };\
+			act.send( _self, to, extended_asset(quantity, bank), memo );}
+
+#define POOL_MOVE(to_pool, bank, quantity, plan_id) \
+    {	rwafi::vaultrwa::move_action act{ VAULT_POOL, { {_self, active_perm} } };\
+			act.send( _self, to_pool, extended_asset(quantity, bank), plan_id );}
+
+#define POOL_MOVE_BATCH(to_pool, bank, allocs) \
+    {	rwafi::vaultrwa::movebatch_action act{ VAULT_POOL, { {_self, active_perm} } };\
+			act.send( _self, to_pool, bank, allocs );}
+
+#define POOL_IMPORT(bank, module, quantity) \
+    TRANSFER(bank, VAULT_POOL, quantity, (module).to_string() + "/migrate")
+#endif
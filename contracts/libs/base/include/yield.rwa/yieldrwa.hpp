@@ -1,49 +1,27 @@
 #pragma once
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
-#include <flon/wasm_db.hpp>
 #include "yieldrwadb.hpp"
 
-using namespace eosio;
-using namespace std;
-
-#define CHECKC(exp, code, msg) \
-   { if (!(exp)) eosio::check(false, string("[[") + to_string((int)code) + string("]] ") + msg); }
-
-enum class err: uint8_t {
-   INVALID_FORMAT        = 0,
-   TYPE_INVALID          = 1,
-   QUANTITY_INSUFFICIENT = 3,
-   NOT_POSITIVE          = 4,
-   SYMBOL_MISMATCH       = 5,
-   EXPIRED               = 6,
-   PWHASH_INVALID        = 7,
-   RECORD_NOT_FOUND      = 8,
-   NOT_REPEAT_RECEIVE    = 9,
-   NOT_EXPIRED           = 10,
-   ACCOUNT_INVALID       = 11,
-   PARAM_ERROR           = 12,
-};
-
 namespace rwafi {
 
-class [[eosio::contract("yield.rwa")]] yieldrwa : public eosio::contract {
-private:
-    dbc                 _db;
-    global_singleton    _global;
-    global_t            _gstate;
+using namespace eosio;
+using std::string;
 
+class [[eosio::contract("yield.rwa")]] yieldrwa : public eosio::contract {
 public:
     using contract::contract;
 
     // ========== Actions ==========
     ACTION init(const name& admin);
-    ACTION updateconfig(const name& key, const uint8_t& value);
-
-    // === External Query ===
-    asset get_yearly_yield(const uint64_t& plan_id, const uint64_t& year, const string& type = "total") const;
 
+    /**
+     * 更新计划担保覆盖率缓存（仅 guaranty 合约可调用，担保池总额变化时推送）
+     * @param coverage_bps 担保资金 / (goal / 2)，封顶 10000
+     */
+    ACTION setcoverage(const uint64_t& plan_id, const uint16_t& coverage_bps);
 
+    using setcoverage_action = eosio::action_wrapper<"setcoverage"_n, &yieldrwa::setcoverage>;
 };
 
-} // namespace rwafi
\ No newline at end of file
+} // namespace rwafi
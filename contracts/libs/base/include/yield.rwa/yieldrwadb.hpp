@@ -6,6 +6,8 @@
 #include <eosio/time.hpp>
 #include <flon/wasm_db.hpp>
 #include <flon/consts.hpp>
+#include <flon/amount.hpp>
+#include <flon/decimal.hpp>
 using namespace eosio;
 using namespace std;
 using namespace wasm::db;
@@ -18,17 +20,45 @@ namespace rwafi {
 #define TBL struct [[eosio::table, eosio::contract("yield.rwa")]]
 #define NTBL(name) struct [[eosio::table(name), eosio::contract("yield.rwa")]]
 
+static constexpr uint16_t  YIELD_LOG_WINDOW = 24;                         // 收益日志保留的最近月份数
+
+// ----------------------------------------------------
+// 计划担保覆盖率缓存（guaranty 在担保池总额变化时推送，收益分配只读本表）
+// 无记录视为覆盖率 0
+// ----------------------------------------------------
+//self: self
+TBL plan_coverage_t {
+    uint64_t        plan_id;               // PK
+    uint16_t        coverage_bps = 0;      // 担保资金 / (goal / 2)，封顶 10000
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    // 担保池总额对应的覆盖率（bp）
+    static uint16_t bps_of(const int64_t& funds, const int64_t& goal) {
+        if (funds <= 0 || goal <= 0) return 0;
+        if ((__int128)2 * funds >= goal) return 10000;
+        return uint16_t(flon::muldiv((__int128)2 * funds, 10000, goal));
+    }
+
+    typedef eosio::multi_index<"coverages"_n, plan_coverage_t> idx_t;
+
+    EOSLIB_SERIALIZE(plan_coverage_t, (plan_id)(coverage_bps)(updated_at))
+};
+
 // ----------------------------------------------------
-// 收益日志表（按月）
+// 收益日志表（按月，只保留最近 YIELD_LOG_WINDOW 个月）
+// 更早的历史见 logyield 事件（action trace），全生命周期累计见 yield_total_t
+// 金额均为计划 goal 符号，只存 amount，读取时用 of(plan.goal_quantity.symbol) 还原
 // ----------------------------------------------------
 //self:plan_id
 TBL yield_log_t {
     uint64_t        period;               // 主键：YYYYMM
-    asset           period_yield;         // 当月总收益
-    asset           guarantor_yield;      // 担保人收益 (≈10%×覆盖率)
-    asset           investor_yield;       // 投资人收益 (≈80%)
-    asset           buyback_yield;        // 回购凭证收益 (剩余)
-    asset           cumulative_yield;     // 累计总收益
+    amount64        period_yield;         // 当月总收益
+    amount64        guarantor_yield;      // 担保人收益 (≈10%×覆盖率)
+    amount64        investor_yield;       // 投资人收益 (≈80%)
+    amount64        buyback_yield;        // 回购凭证收益 (剩余)
+    amount64        cumulative_yield;     // 累计总收益
     time_point_sec  created_at;
     time_point_sec  updated_at;
 
@@ -37,10 +67,31 @@ TBL yield_log_t {
     yield_log_t() {}
     yield_log_t(const uint64_t& p): period(p) {}
 
-    typedef eosio::multi_index<"yieldlogs"_n, yield_log_t> idx_t;
+    typedef eosio::multi_index<"yieldhist"_n, yield_log_t> idx_t;
 
     EOSLIB_SERIALIZE(yield_log_t,(period)(period_yield)(guarantor_yield)(investor_yield)
                     (buyback_yield)(cumulative_yield)(created_at)(updated_at))
 };
 
+// 计划收益全生命周期累计（每计划一行，不随月份增长）
+//self: self
+TBL yield_total_t {
+    uint64_t        plan_id;              // PK
+    amount64        total_yield;          // 累计总收益
+    amount64        investor_yield;       // 累计投资人收益
+    amount64        guarantor_yield;      // 累计担保人收益
+    amount64        buyback_yield;        // 累计回购收益
+    uint64_t        first_period = 0;     // 首个有收益的月份 YYYYMM
+    uint64_t        last_period  = 0;     // 最近有收益的月份 YYYYMM
+    uint32_t        periods      = 0;     // 有收益的月份数
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    typedef eosio::multi_index<"yieldtotals"_n, yield_total_t> idx_t;
+
+    EOSLIB_SERIALIZE(yield_total_t,(plan_id)(total_yield)(investor_yield)(guarantor_yield)(buyback_yield)
+                    (first_period)(last_period)(periods)(updated_at))
+};
+
 } // namespace rwafi
\ No newline at end of file
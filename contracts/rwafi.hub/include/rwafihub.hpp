@@ -0,0 +1,176 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/time.hpp>
+#include <eosio/crypto.hpp>
+#include <string>
+#include <flon/plan_alloc.hpp>
+
+#include "rwafihubdb.hpp"
+
+using namespace std;
+
+namespace rwahub {
+
+using namespace eosio;
+
+#define CHECKC(exp, code, msg) \
+   { if (!(exp)) eosio::check(false, string("[[") + to_string((int)code) + string("]] ") + msg); }
+
+enum class err: uint8_t {
+   INVALID_FORMAT       = 0,
+   NOT_POSITIVE         = 4,
+   RECORD_NOT_FOUND     = 8,
+   CONTRACT_MISMATCH    = 32,
+   PARAM_ERROR          = 33
+};
+
+/**
+ * 池模块入口
+ * 每个模块在自己的编译单元（src/<module>.cpp）中以独立命名空间编译，
+ * hub 与其他模块只通过这里的静态函数调用它，不直接引用模块类型
+ */
+struct pools {
+    // === invest 模块 ===
+    static void invest_init(const name& self, const name& admin);
+    static void invest_crank(const name& self, const name& keeper, const uint16_t& max_work);
+    static void invest_setkeeper(const name& self, const asset& fee_per_work);
+    static void invest_notify(const name& self, const name& bank, const name& from, const name& to,
+                              const asset& quantity, const string& memo);
+    // 回执退回 invest：销毁回执并退还投资人本金
+    static void invest_refund(const name& self, const name& bank, const name& investor,
+                              const asset& receipts, const uint64_t& plan_id);
+
+    // === stake 模块 ===
+    static void stake_init(const name& self, const name& admin);
+    static void stake_crank(const name& self, const name& keeper, const uint16_t& max_work);
+    static void stake_setkeeper(const name& self, const asset& fee_per_work);
+    static void stake_notify(const name& self, const name& bank, const name& from, const name& to,
+                             const asset& quantity, const string& memo);
+    // 投资回执入质押池，记在投资人名下
+    static void stake_receipts(const name& self, const name& bank, const name& investor,
+                               const asset& receipts, const uint64_t& plan_id);
+    // 质押奖励入池（yield 收益分配 / guaranty 保底补足）
+    static void stake_reward(const name& self, const name& route, const name& bank,
+                             const asset& quantity, const uint64_t& plan_id);
+    // 多计划奖励入池（yield 批量分配）：账本只记一笔合计
+    static void stake_rewards(const name& self, const name& route, const name& bank,
+                              const std::vector<flon::plan_alloc_t>& allocs);
+
+    // === yield 模块 ===
+    static void yield_init(const name& self, const name& admin);
+    static void yield_crank(const name& self, const name& keeper, const uint16_t& max_work);
+    static void yield_setkeeper(const name& self, const asset& fee_per_work);
+    static void yield_notify(const name& self, const name& bank, const name& from, const name& to,
+                             const asset& quantity, const string& memo);
+    // guaranty 担保池总额变化后更新计划覆盖率缓存
+    static void yield_coverage(const name& self, const uint64_t& plan_id, const uint16_t& coverage_bps);
+
+    // === guaranty 模块 ===
+    static void guaranty_init(const name& self, const name& admin);
+    static void guaranty_crank(const name& self, const name& keeper, const uint16_t& max_work);
+    static void guaranty_setkeeper(const name& self, const asset& fee_per_work);
+    static void guaranty_notify(const name& self, const name& bank, const name& from, const name& to,
+                                const asset& quantity, const string& memo);
+    // 担保人收益入担保池，按质押比例分给担保人
+    static void guaranty_reward(const name& self, const name& bank, const asset& quantity,
+                                const uint64_t& plan_id);
+    static void guaranty_rewards(const name& self, const name& bank, const std::vector<flon::plan_alloc_t>& allocs);
+
+    // === 账本（rwafihub.cpp）：池间转移记账 ===
+    static void book(const name& self, const name& route, const name& bank, const asset& quantity);
+};
+
+/**
+ * @contract rwafihub
+ * @brief invest / stake / yield / guaranty 四个池合并部署的单合约
+ *
+ * - 模块 action 同名转发，各模块的 init / crank / setkeeper 由 hub 统一入口按模块选择
+ * - 用户转账 memo 需带模块前缀：<pool>/<memo>，如 invest/plan:1、guaranty/guaranty:1
+ * - 池间资金转移（回执入池、收益分配、保底补足、退款）改为账本记账 + 直接调用
+ */
+class [[eosio::contract("rwafi.hub")]] rwafihub : public contract {
+public:
+    using contract::contract;
+
+    // 初始化四个模块（invest 地址即 hub 自身）
+    ACTION init(const name& admin);
+
+    /**
+     * keeper 维护入口，转发到指定模块的 crank
+     * @param pool 模块名：invest / stake / yield / guaranty
+     */
+    ACTION crank(const name& keeper, const name& pool, const uint16_t& max_work);
+
+    // 设置指定模块每单位工作的 keeper 奖励
+    ACTION setkeeper(const name& pool, const asset& fee_per_work);
+
+    // 按 memo 前缀把转入资金交给对应模块；flon.swap 兑回的凭证交给 yield
+    [[eosio::on_notify("*::transfer")]]
+    void on_transfer(const name& from, const name& to, const asset& quantity, const string& memo);
+
+    // === invest 模块（src/invest.cpp） ===
+    ACTION addtoken(const name& contract, const symbol& sym);
+    ACTION deltoken(const symbol& sym);
+    ACTION onshelf(const symbol& sym, const bool& onshelf);
+    ACTION createplan(const name& creator,
+                      const string& title,
+                      const name& goal_asset_contract,
+                      const asset& goal_quantity,
+                      const name& receipt_asset_contract,
+                      const asset& receipt_quantity_per_unit,
+                      const uint8_t& soft_cap_percent,
+                      const uint8_t& hard_cap_percent,
+                      const time_point& start_time,
+                      const time_point& end_time,
+                      const uint16_t& return_months,
+                      const uint32_t& guaranteed_yield_apr);
+    ACTION cancelplan(const name& creator, const uint64_t& plan_id);
+    ACTION setallowlist(const name& submitter, const uint64_t& plan_id, const checksum256& merkle_root);
+    ACTION prove(const name& investor, const uint64_t& plan_id, const std::vector<checksum256>& proof);
+
+    // === stake 模块（src/stake.cpp） ===
+    ACTION addplan(const uint64_t& plan_id, const symbol& receipt_sym);
+    ACTION delplan(const uint64_t& plan_id);
+    ACTION claim(const name& owner, const uint64_t& plan_id);
+    ACTION claimfor(const name& operator_, const uint64_t& plan_id, const std::vector<name>& owners);
+    ACTION setoperator(const name& operator_, const name& payout);
+    ACTION deloperator(const name& operator_);
+    ACTION grantclaim(const name& owner, const name& operator_);
+    ACTION revokeclaim(const name& owner, const name& operator_);
+    ACTION unstake(const name& owner, const uint64_t& plan_id, const asset& quantity);
+    ACTION batchunstake(const uint64_t& plan_id);
+
+    // === yield 模块（src/yield.cpp） ===
+    ACTION setsplit(const uint64_t& plan_id, const uint16_t& stake_bps, const uint16_t& guaranty_bps,
+                    const uint16_t& swap_bps);
+    ACTION delsplit(const uint64_t& plan_id);
+    ACTION buyback(const name& submitter, const uint64_t& plan_id);
+    ACTION setslippage(const name& submitter, const uint64_t& plan_id, const uint16_t& max_slippage);
+    ACTION setchunk(const name& submitter, const uint64_t& plan_id, const asset& chunk_size, const uint32_t& chunk_interval);
+    ACTION observe(const uint64_t& plan_id);
+    ACTION settwap(const uint32_t& twap_window, const uint16_t& max_twap_dev);
+    ACTION migratelogs(const uint64_t& plan_id, const uint16_t& max_rows);
+    ACTION migratebuys(const uint16_t& max_rows);
+    ACTION migrateconf();
+    ACTION distribute(const name& depositor, const std::vector<flon::plan_alloc_t>& allocs);
+    ACTION flush(const uint16_t& max_plans);
+    ACTION setflush(const uint32_t& flush_interval);
+    ACTION logyield(const uint64_t& plan_id, const uint64_t& period, const asset& total,
+                    const asset& to_stake, const asset& to_guaranty, const asset& to_swap,
+                    const asset& cumulative);
+
+    // === guaranty 模块（src/guaranty.cpp） ===
+    ACTION guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& year);
+    ACTION redeem(const name& guarantor, const uint64_t& plan_id, const asset& quantity);
+    ACTION addyield(const uint64_t& plan_id, const asset& quantity);
+    ACTION addyields(const std::vector<flon::plan_alloc_t>& allocs);
+    ACTION settranches(const std::vector<uint16_t>& weights);
+    ACTION migratestats(const uint16_t& max_rows);
+    ACTION migratestake(const uint64_t& plan_id, const uint16_t& max_rows);
+    ACTION synccover(const uint64_t& plan_id);
+    ACTION openshares(const name& submitter, const uint64_t& plan_id, const symbol_code& share_code);
+};
+
+} // namespace rwahub
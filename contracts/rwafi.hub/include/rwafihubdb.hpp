@@ -0,0 +1,43 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/time.hpp>
+#include <flon/consts.hpp>
+
+namespace rwahub {
+
+using namespace eosio;
+
+// 模块名：转账 memo 路由（<pool>/<memo>）以及 crank / setkeeper 的模块选择
+static constexpr name INVEST            = flon::INVEST_MODULE;
+static constexpr name STAKE             = flon::STAKE_MODULE;
+static constexpr name YIELD             = flon::YIELD_MODULE;
+static constexpr name GUARANTY          = flon::GUARANTY_MODULE;
+
+// 池间转移路线（账本 scope）
+static constexpr name INVEST_TO_STAKE   = "invest.stake"_n;     // 投资回执入质押池
+static constexpr name STAKE_TO_INVEST   = "stake.invest"_n;     // 失败/取消计划的回执退回
+static constexpr name YIELD_TO_STAKE    = "yield.stake"_n;      // 投资人收益
+static constexpr name YIELD_TO_GUARANTY = "yield.guar"_n;       // 担保人收益
+static constexpr name GUARANTY_TO_STAKE = "guar.stake"_n;       // 保底补足
+
+// ----------------------------------------------------
+// 池间转移账本（scope = 路线，如 invest.stake；按代币符号累计）
+// hub 内池间资金不再经过代币合约，每笔转移只在此处记一笔
+// ----------------------------------------------------
+struct [[eosio::table, eosio::contract("rwafi.hub")]] pool_move_t {
+    extended_asset  moved;                  // 累计转移
+    uint64_t        count       = 0;        // 转移笔数
+    time_point_sec  updated_at;
+
+    pool_move_t() {}
+
+    uint64_t primary_key() const { return moved.quantity.symbol.code().raw(); }
+
+    typedef eosio::multi_index<"moves"_n, pool_move_t> idx_t;
+
+    EOSLIB_SERIALIZE(pool_move_t, (moved)(count)(updated_at))
+};
+
+} // namespace rwahub
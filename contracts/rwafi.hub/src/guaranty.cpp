@@ -0,0 +1,93 @@
+/**
+ * rwafi.hub 的 guaranty 模块
+ * guaranty.rwa 源码在独立命名空间下编译，与其他模块同名的 global_t / err 等类型互不冲突
+ */
+#define rwafi rwafi_guaranty
+#include "../../guaranty.rwa/src/guarantyrwa.cpp"
+
+namespace rwahub {
+
+void pools::guaranty_init(const name& self, const name& admin) {
+    guarantyrwa(self, self, datastream<const char*>(nullptr, 0)).init(admin);
+}
+
+void pools::guaranty_crank(const name& self, const name& keeper, const uint16_t& max_work) {
+    guarantyrwa(self, self, datastream<const char*>(nullptr, 0)).crank(keeper, max_work);
+}
+
+void pools::guaranty_setkeeper(const name& self, const asset& fee_per_work) {
+    guarantyrwa(self, self, datastream<const char*>(nullptr, 0)).setkeeper(fee_per_work);
+}
+
+void pools::guaranty_notify(const name& self, const name& bank, const name& from, const name& to,
+                            const asset& quantity, const string& memo) {
+    guarantyrwa(self, bank, datastream<const char*>(nullptr, 0)).on_transfer(from, to, quantity, memo);
+}
+
+void pools::guaranty_reward(const name& self, const name& bank, const asset& quantity,
+                            const uint64_t& plan_id) {
+    book(self, YIELD_TO_GUARANTY, bank, quantity);
+
+    fundplan_t::idx_t fundplans(self, self.value);
+    auto itr = fundplans.find(plan_id);
+    CHECKC(itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    CHECKC(bank == itr->goal_asset_contract, err::CONTRACT_MISMATCH, "token contract mismatch");
+    CHECKC(quantity.symbol == itr->goal_quantity.symbol, err::PARAM_ERROR, "symbol mismatch");
+
+    guarantyrwa(self, bank, datastream<const char*>(nullptr, 0))._handle_reward_transfer(*itr, quantity);
+}
+
+void pools::guaranty_rewards(const name& self, const name& bank, const std::vector<plan_alloc_t>& allocs) {
+    asset total(0, allocs.front().quantity.symbol);
+    for (const auto& a : allocs) total += a.quantity;
+    book(self, YIELD_TO_GUARANTY, bank, total);
+
+    fundplan_t::idx_t fundplans(self, self.value);
+    guarantyrwa guaranty(self, bank, datastream<const char*>(nullptr, 0));
+    for (const auto& a : allocs) {
+        auto itr = fundplans.find(a.plan_id);
+        CHECKC(itr != fundplans.end(), err::RECORD_NOT_FOUND, "plan not found");
+        CHECKC(bank == itr->goal_asset_contract, err::CONTRACT_MISMATCH, "token contract mismatch");
+        CHECKC(a.quantity.symbol == itr->goal_quantity.symbol, err::PARAM_ERROR, "symbol mismatch");
+        guaranty._handle_reward_transfer(*itr, a.quantity);
+    }
+}
+
+// ------------------- action 转发 ------------------------------------------------------
+void rwafihub::guarantpay(const name& submitter, const uint64_t& plan_id, const uint64_t& year) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).guarantpay(submitter, plan_id, year);
+}
+
+void rwafihub::redeem(const name& guarantor, const uint64_t& plan_id, const asset& quantity) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).redeem(guarantor, plan_id, quantity);
+}
+
+void rwafihub::addyield(const uint64_t& plan_id, const asset& quantity) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).addyield(plan_id, quantity);
+}
+
+void rwafihub::addyields(const std::vector<plan_alloc_t>& allocs) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).addyields(allocs);
+}
+
+void rwafihub::settranches(const std::vector<uint16_t>& weights) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).settranches(weights);
+}
+
+void rwafihub::migratestats(const uint16_t& max_rows) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).migratestats(max_rows);
+}
+
+void rwafihub::migratestake(const uint64_t& plan_id, const uint16_t& max_rows) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).migratestake(plan_id, max_rows);
+}
+
+void rwafihub::synccover(const uint64_t& plan_id) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).synccover(plan_id);
+}
+
+void rwafihub::openshares(const name& submitter, const uint64_t& plan_id, const symbol_code& share_code) {
+    guarantyrwa(get_self(), get_first_receiver(), get_datastream()).openshares(submitter, plan_id, share_code);
+}
+
+} // namespace rwahub
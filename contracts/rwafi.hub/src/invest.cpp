@@ -0,0 +1,81 @@
+/**
+ * rwafi.hub 的 invest 模块
+ * invest.rwa 源码在独立命名空间下编译，与其他模块同名的 global_t / err 等类型互不冲突
+ */
+#define rwafi rwafi_invest
+#include "../../invest.rwa/src/investrwa.cpp"
+
+namespace rwahub {
+
+void pools::invest_init(const name& self, const name& admin) {
+    investrwa(self, self, datastream<const char*>(nullptr, 0)).init(admin);
+}
+
+void pools::invest_crank(const name& self, const name& keeper, const uint16_t& max_work) {
+    investrwa(self, self, datastream<const char*>(nullptr, 0)).crank(keeper, max_work);
+}
+
+void pools::invest_setkeeper(const name& self, const asset& fee_per_work) {
+    investrwa(self, self, datastream<const char*>(nullptr, 0)).setkeeper(fee_per_work);
+}
+
+void pools::invest_notify(const name& self, const name& bank, const name& from, const name& to,
+                          const asset& quantity, const string& memo) {
+    investrwa(self, bank, datastream<const char*>(nullptr, 0)).on_transfer(from, to, quantity, memo);
+}
+
+void pools::invest_refund(const name& self, const name& bank, const name& investor,
+                          const asset& receipts, const uint64_t& plan_id) {
+    book(self, STAKE_TO_INVEST, bank, receipts);
+
+    investrwa invest(self, bank, datastream<const char*>(nullptr, 0));
+    fundplan_t plan(plan_id);
+    CHECKC(invest._db.get(plan), err::RECORD_NOT_FOUND, "no such fund plan id: " + std::to_string(plan_id));
+    CHECKC(bank == plan.receipt_asset_contract, err::CONTRACT_MISMATCH, "refund must come from receipt contract");
+    invest._process_refund(investor, receipts, plan);
+}
+
+// ------------------- action 转发 ------------------------------------------------------
+void rwafihub::addtoken(const name& contract, const symbol& sym) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).addtoken(contract, sym);
+}
+
+void rwafihub::deltoken(const symbol& sym) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).deltoken(sym);
+}
+
+void rwafihub::onshelf(const symbol& sym, const bool& onshelf) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).onshelf(sym, onshelf);
+}
+
+void rwafihub::createplan(const name& creator,
+                          const string& title,
+                          const name& goal_asset_contract,
+                          const asset& goal_quantity,
+                          const name& receipt_asset_contract,
+                          const asset& receipt_quantity_per_unit,
+                          const uint8_t& soft_cap_percent,
+                          const uint8_t& hard_cap_percent,
+                          const time_point& start_time,
+                          const time_point& end_time,
+                          const uint16_t& return_months,
+                          const uint32_t& guaranteed_yield_apr) {
+    investrwa(get_self(), get_first_receiver(), get_datastream())
+        .createplan(creator, title, goal_asset_contract, goal_quantity, receipt_asset_contract,
+                    receipt_quantity_per_unit, soft_cap_percent, hard_cap_percent,
+                    start_time, end_time, return_months, guaranteed_yield_apr);
+}
+
+void rwafihub::cancelplan(const name& creator, const uint64_t& plan_id) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).cancelplan(creator, plan_id);
+}
+
+void rwafihub::setallowlist(const name& submitter, const uint64_t& plan_id, const checksum256& merkle_root) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).setallowlist(submitter, plan_id, merkle_root);
+}
+
+void rwafihub::prove(const name& investor, const uint64_t& plan_id, const std::vector<checksum256>& proof) {
+    investrwa(get_self(), get_first_receiver(), get_datastream()).prove(investor, plan_id, proof);
+}
+
+} // namespace rwahub
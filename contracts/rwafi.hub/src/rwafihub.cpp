@@ -0,0 +1,84 @@
+#include <rwafihub.hpp>
+#include <flon/consts.hpp>
+
+namespace rwahub {
+
+using namespace flon;
+
+void rwafihub::init(const name& admin) {
+    require_auth(get_self());
+
+    pools::invest_init(get_self(), admin);
+    pools::stake_init(get_self(), admin);
+    pools::yield_init(get_self(), admin);
+    pools::guaranty_init(get_self(), admin);
+}
+
+void rwafihub::crank(const name& keeper, const name& pool, const uint16_t& max_work) {
+    switch (pool.value) {
+        case INVEST.value:      return pools::invest_crank(get_self(), keeper, max_work);
+        case STAKE.value:       return pools::stake_crank(get_self(), keeper, max_work);
+        case YIELD.value:       return pools::yield_crank(get_self(), keeper, max_work);
+        case GUARANTY.value:    return pools::guaranty_crank(get_self(), keeper, max_work);
+    }
+    CHECKC(false, err::PARAM_ERROR, "unknown pool: " + pool.to_string());
+}
+
+void rwafihub::setkeeper(const name& pool, const asset& fee_per_work) {
+    switch (pool.value) {
+        case INVEST.value:      return pools::invest_setkeeper(get_self(), fee_per_work);
+        case STAKE.value:       return pools::stake_setkeeper(get_self(), fee_per_work);
+        case YIELD.value:       return pools::yield_setkeeper(get_self(), fee_per_work);
+        case GUARANTY.value:    return pools::guaranty_setkeeper(get_self(), fee_per_work);
+    }
+    CHECKC(false, err::PARAM_ERROR, "unknown pool: " + pool.to_string());
+}
+
+void rwafihub::on_transfer(const name& from, const name& to, const asset& quantity, const string& memo) {
+    if (from == get_self() || to != get_self()) return;
+
+    const name bank = get_first_receiver();
+
+    // flon.swap 兑回的凭证不带前缀，直接交给 yield
+    if (from == SWAP_POOL && bank == RECEIPT_BANK)
+        return pools::yield_notify(get_self(), bank, from, to, quantity, memo);
+
+    // memo 格式：<pool>/<memo>
+    const auto pos = memo.find('/');
+    CHECKC(pos != string::npos, err::INVALID_FORMAT, "memo must be <pool>/<memo>");
+    const name   pool(memo.substr(0, pos));
+    const string inner = memo.substr(pos + 1);
+
+    switch (pool.value) {
+        case INVEST.value:      return pools::invest_notify(get_self(), bank, from, to, quantity, inner);
+        case STAKE.value:       return pools::stake_notify(get_self(), bank, from, to, quantity, inner);
+        case YIELD.value:       return pools::yield_notify(get_self(), bank, from, to, quantity, inner);
+        case GUARANTY.value:    return pools::guaranty_notify(get_self(), bank, from, to, quantity, inner);
+    }
+    CHECKC(false, err::PARAM_ERROR, "unknown pool: " + pool.to_string());
+}
+
+void pools::book(const name& self, const name& route, const name& bank, const asset& quantity) {
+    CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "move quantity must be positive");
+
+    const auto now = time_point_sec(current_time_point());
+    pool_move_t::idx_t moves(self, route.value);
+    auto itr = moves.find(quantity.symbol.code().raw());
+    if (itr == moves.end()) {
+        moves.emplace(self, [&](auto& m) {
+            m.moved      = extended_asset(quantity, bank);
+            m.count      = 1;
+            m.updated_at = now;
+        });
+        return;
+    }
+
+    CHECKC(itr->moved.contract == bank, err::CONTRACT_MISMATCH, "token contract mismatch on route " + route.to_string());
+    moves.modify(itr, same_payer, [&](auto& m) {
+        m.moved.quantity += quantity;
+        m.count          += 1;
+        m.updated_at      = now;
+    });
+}
+
+} // namespace rwahub
@@ -0,0 +1,98 @@
+/**
+ * rwafi.hub 的 stake 模块
+ * stake.rwa 源码在独立命名空间下编译，与其他模块同名的 global_t / err 等类型互不冲突
+ */
+#define rwafi rwafi_stake
+#include "../../stake.rwa/src/stakerwa.cpp"
+
+using namespace rwafi;
+
+namespace rwahub {
+
+void pools::stake_init(const name& self, const name& admin) {
+    stakerwa(self, self, datastream<const char*>(nullptr, 0)).init(admin, self);
+}
+
+void pools::stake_crank(const name& self, const name& keeper, const uint16_t& max_work) {
+    stakerwa(self, self, datastream<const char*>(nullptr, 0)).crank(keeper, max_work);
+}
+
+void pools::stake_setkeeper(const name& self, const asset& fee_per_work) {
+    stakerwa(self, self, datastream<const char*>(nullptr, 0)).setkeeper(fee_per_work);
+}
+
+void pools::stake_notify(const name& self, const name& bank, const name& from, const name& to,
+                         const asset& quantity, const string& memo) {
+    stakerwa stake(self, bank, datastream<const char*>(nullptr, 0));
+    if (bank == RECEIPT_BANK)   return stake.on_transfer_rwafi(from, to, quantity, memo);
+    if (bank == SING_BANK)      return stake.on_transfer_reward(from, to, quantity, memo);
+
+    CHECKC(false, err::CONTRACT_MISMATCH, "unsupported token contract for stake: " + bank.to_string());
+}
+
+void pools::stake_receipts(const name& self, const name& bank, const name& investor,
+                           const asset& receipts, const uint64_t& plan_id) {
+    CHECKC(bank == RECEIPT_BANK, err::CONTRACT_MISMATCH, "receipts must come from " + RECEIPT_BANK.to_string());
+    book(self, INVEST_TO_STAKE, bank, receipts);
+    stakerwa(self, bank, datastream<const char*>(nullptr, 0))._on_stake(investor, receipts, plan_id);
+}
+
+void pools::stake_reward(const name& self, const name& route, const name& bank,
+                         const asset& quantity, const uint64_t& plan_id) {
+    book(self, route, bank, quantity);
+    stakerwa(self, bank, datastream<const char*>(nullptr, 0))._on_reward_in(self, quantity, plan_id);
+}
+
+void pools::stake_rewards(const name& self, const name& route, const name& bank,
+                          const std::vector<plan_alloc_t>& allocs) {
+    asset total(0, allocs.front().quantity.symbol);
+    for (const auto& a : allocs) total += a.quantity;
+    book(self, route, bank, total);
+
+    stakerwa stake(self, bank, datastream<const char*>(nullptr, 0));
+    for (const auto& a : allocs)
+        stake._on_reward_in(self, a.quantity, a.plan_id);
+}
+
+// ------------------- action 转发 ------------------------------------------------------
+void rwafihub::addplan(const uint64_t& plan_id, const symbol& receipt_sym) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).addplan(plan_id, receipt_sym);
+}
+
+void rwafihub::delplan(const uint64_t& plan_id) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).delplan(plan_id);
+}
+
+void rwafihub::claim(const name& owner, const uint64_t& plan_id) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).claim(owner, plan_id);
+}
+
+void rwafihub::claimfor(const name& operator_, const uint64_t& plan_id, const std::vector<name>& owners) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).claimfor(operator_, plan_id, owners);
+}
+
+void rwafihub::setoperator(const name& operator_, const name& payout) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).setoperator(operator_, payout);
+}
+
+void rwafihub::deloperator(const name& operator_) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).deloperator(operator_);
+}
+
+void rwafihub::grantclaim(const name& owner, const name& operator_) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).grantclaim(owner, operator_);
+}
+
+void rwafihub::revokeclaim(const name& owner, const name& operator_) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).revokeclaim(owner, operator_);
+}
+
+void rwafihub::unstake(const name& owner, const uint64_t& plan_id, const asset& quantity) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).unstake(owner, plan_id, quantity);
+}
+
+void rwafihub::batchunstake(const uint64_t& plan_id) {
+    stakerwa(get_self(), get_first_receiver(), get_datastream()).batchunstake(plan_id);
+}
+
+} // namespace rwahub
@@ -0,0 +1,96 @@
+/**
+ * rwafi.hub 的 yield 模块
+ * yield.rwa 源码在独立命名空间下编译，与其他模块同名的 global_t / err 等类型互不冲突
+ */
+#define rwafi rwafi_yield
+#include "../../yield.rwa/src/yieldrwa.cpp"
+
+namespace rwahub {
+
+void pools::yield_init(const name& self, const name& admin) {
+    yieldrwa(self, self, datastream<const char*>(nullptr, 0)).init(admin);
+}
+
+void pools::yield_crank(const name& self, const name& keeper, const uint16_t& max_work) {
+    yieldrwa(self, self, datastream<const char*>(nullptr, 0)).crank(keeper, max_work);
+}
+
+void pools::yield_setkeeper(const name& self, const asset& fee_per_work) {
+    yieldrwa(self, self, datastream<const char*>(nullptr, 0)).setkeeper(fee_per_work);
+}
+
+void pools::yield_notify(const name& self, const name& bank, const name& from, const name& to,
+                         const asset& quantity, const string& memo) {
+    yieldrwa yield(self, bank, datastream<const char*>(nullptr, 0));
+    if (bank == SING_BANK)      return yield.on_transfer(from, to, quantity, memo);
+    if (bank == RECEIPT_BANK)   return yield.on_voucher(from, to, quantity, memo);
+
+    CHECKC(false, err::CONTRACT_MISMATCH, "unsupported token contract for yield: " + bank.to_string());
+}
+
+void pools::yield_coverage(const name& self, const uint64_t& plan_id, const uint16_t& coverage_bps) {
+    yieldrwa(self, self, datastream<const char*>(nullptr, 0))._set_coverage(plan_id, coverage_bps);
+}
+
+// ------------------- action 转发 ------------------------------------------------------
+void rwafihub::setsplit(const uint64_t& plan_id, const uint16_t& stake_bps, const uint16_t& guaranty_bps,
+                        const uint16_t& swap_bps) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).setsplit(plan_id, stake_bps, guaranty_bps, swap_bps);
+}
+
+void rwafihub::delsplit(const uint64_t& plan_id) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).delsplit(plan_id);
+}
+
+void rwafihub::buyback(const name& submitter, const uint64_t& plan_id) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).buyback(submitter, plan_id);
+}
+
+void rwafihub::setslippage(const name& submitter, const uint64_t& plan_id, const uint16_t& max_slippage) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).setslippage(submitter, plan_id, max_slippage);
+}
+
+void rwafihub::setchunk(const name& submitter, const uint64_t& plan_id, const asset& chunk_size, const uint32_t& chunk_interval) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).setchunk(submitter, plan_id, chunk_size, chunk_interval);
+}
+
+void rwafihub::observe(const uint64_t& plan_id) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).observe(plan_id);
+}
+
+void rwafihub::settwap(const uint32_t& twap_window, const uint16_t& max_twap_dev) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).settwap(twap_window, max_twap_dev);
+}
+
+void rwafihub::migratelogs(const uint64_t& plan_id, const uint16_t& max_rows) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).migratelogs(plan_id, max_rows);
+}
+
+void rwafihub::migratebuys(const uint16_t& max_rows) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).migratebuys(max_rows);
+}
+
+void rwafihub::distribute(const name& depositor, const std::vector<plan_alloc_t>& allocs) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).distribute(depositor, allocs);
+}
+
+void rwafihub::flush(const uint16_t& max_plans) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).flush(max_plans);
+}
+
+void rwafihub::setflush(const uint32_t& flush_interval) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).setflush(flush_interval);
+}
+
+void rwafihub::migrateconf() {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream()).migrateconf();
+}
+
+void rwafihub::logyield(const uint64_t& plan_id, const uint64_t& period, const asset& total,
+                        const asset& to_stake, const asset& to_guaranty, const asset& to_swap,
+                        const asset& cumulative) {
+    yieldrwa(get_self(), get_first_receiver(), get_datastream())
+        .logyield(plan_id, period, total, to_stake, to_guaranty, to_swap, cumulative);
+}
+
+} // namespace rwahub
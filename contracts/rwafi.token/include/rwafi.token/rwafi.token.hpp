@@ -2,8 +2,11 @@
 
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
+#include <eosio/time.hpp>
 
+#include <map>
 #include <string>
+#include <vector>
 
 namespace eosiosystem {
    class system_contract;
@@ -32,6 +35,7 @@ namespace eosio {
           * @param issuer - the account that creates the token,
           * @param maximum_supply - the maximum supply set for the token created.
           *
+          * @pre Only invest.rwa (plan receipts) or guaranty.rwa (guarantor shares) may create tokens,
           * @pre Token symbol has to be valid,
           * @pre Token symbol must not be already created,
           * @pre maximum_supply has to be smaller than the maximum supply allowed by the system: 1^62 - 1.
@@ -74,6 +78,26 @@ namespace eosio {
                         const name&    to,
                         const asset&   quantity,
                         const string&  memo );
+
+         /**
+          * Allows `from` account to pay many recipients of one token in a single action.
+          * The `stat` row is loaded and `from` is debited once for the batch total,
+          * then every recipient is credited in one loop.
+          *
+          * @param from - the account to transfer from,
+          * @param transfers - the recipients and the quantity each one receives, all of the same symbol,
+          * @param memo - the memo string shared by every transfer of the batch.
+          *
+          * @pre At most `max_batch_transfers` recipients, none of them equal to `from`,
+          * @pre No recipient is a pool account: pools only act on `transfer` notifications,
+          * @pre When `from` is a pool account, recipients are not notified;
+          *      otherwise every recipient is notified as with `transfer`.
+          */
+         [[eosio::action]]
+         void transferbatch( const name&                                 from,
+                             const std::vector<std::pair<name, asset>>&  transfers,
+                             const string&                               memo );
+
          /**
           * Allows `ram_payer` to create an account `owner` with zero balance for
           * token `symbol` at the expense of `ram_payer`.
@@ -99,6 +123,19 @@ namespace eosio {
          [[eosio::action]]
          void close( const name& owner, const symbol& symbol );
 
+         /**
+          * Allows the issuer of `sym` to turn on balance checkpoints for that token.
+          * From then on every balance change appends (block time, balance) for the holder
+          * and every issue / retire appends (block time, supply), so `balance_at` and
+          * `supply_at` can answer for any time since. Checkpointing cannot be turned off.
+          *
+          * @param sym - the symbol code of the token to checkpoint.
+          *
+          * @pre The token has to exist and must not be checkpointed already.
+          */
+         [[eosio::action]]
+         void checkpoint( const symbol_code& sym );
+
          static asset get_supply( const name& token_contract_account, const symbol_code& sym_code )
          {
             stats statstable( token_contract_account, sym_code.raw() );
@@ -123,12 +160,58 @@ namespace eosio {
             return accountstable.get( sym_code.raw(), "no balance with specified symbol" ).balance;
          }
 
+         /**
+          * Balance of `owner` at the end of second `at`, read from the checkpoints in O(log k).
+          *
+          * @pre Checkpointing of `sym_code` has to be enabled no later than `at`.
+          */
+         static asset balance_at( const name& token_contract_account, const name& owner,
+                                  const symbol_code& sym_code, const time_point_sec& at )
+         {
+            ckptsyms conf( token_contract_account, token_contract_account.value );
+            check( at >= conf.get( sym_code.raw(), "symbol is not checkpointed" ).since, "no checkpoints before that time" );
+
+            balckpts ckpts( token_contract_account, sym_code.raw() );
+            auto idx = ckpts.get_index<"byownerat"_n>();
+            const uint128_t owner_key = (uint128_t)owner.value << 64;
+            auto it = idx.upper_bound( owner_key | at.sec_since_epoch() );
+            if( it != idx.begin() && std::prev(it)->owner == owner )
+               return std::prev(it)->balance;
+
+            // no checkpoint up to `at`: zero if the holder changed later, else the current balance held all along
+            const asset zero( 0, get_supply( token_contract_account, sym_code ).symbol );
+            if( it != idx.end() && it->owner == owner )
+               return zero;
+            accounts accountstable( token_contract_account, owner.value );
+            auto acnt = accountstable.find( sym_code.raw() );
+            return acnt == accountstable.end() ? zero : acnt->balance;
+         }
+
+         /**
+          * Total supply of `sym_code` at the end of second `at`.
+          *
+          * @pre Checkpointing of `sym_code` has to be enabled no later than `at`.
+          */
+         static asset supply_at( const name& token_contract_account, const symbol_code& sym_code,
+                                 const time_point_sec& at )
+         {
+            ckptsyms conf( token_contract_account, token_contract_account.value );
+            check( at >= conf.get( sym_code.raw(), "symbol is not checkpointed" ).since, "no checkpoints before that time" );
+
+            // enabling records the supply at `since`, so a checkpoint at or before `at` exists
+            supplyckpts ckpts( token_contract_account, sym_code.raw() );
+            auto it = ckpts.upper_bound( at.sec_since_epoch() );
+            return std::prev(it)->supply;
+         }
+
          using create_action = eosio::action_wrapper<"create"_n, &token::create>;
          using issue_action = eosio::action_wrapper<"issue"_n, &token::issue>;
          using retire_action = eosio::action_wrapper<"retire"_n, &token::retire>;
          using transfer_action = eosio::action_wrapper<"transfer"_n, &token::transfer>;
+         using transferbatch_action = eosio::action_wrapper<"transferbatch"_n, &token::transferbatch>;
          using open_action = eosio::action_wrapper<"open"_n, &token::open>;
          using close_action = eosio::action_wrapper<"close"_n, &token::close>;
+         using checkpoint_action = eosio::action_wrapper<"checkpoint"_n, &token::checkpoint>;
 
          struct [[eosio::table]] account {
             asset    balance;
@@ -147,9 +230,50 @@ namespace eosio {
          typedef eosio::multi_index< "accounts"_n, account > accounts;
          typedef eosio::multi_index< "stat"_n, currency_stats > stats;
 
+         // symbols with checkpointing enabled, scope = self
+         struct [[eosio::table]] checkpoint_conf {
+            symbol_code    sym;
+            time_point_sec since;
+
+            uint64_t primary_key()const { return sym.raw(); }
+         };
+
+         // balance of a holder after its last change within one second, scope = symbol code
+         struct [[eosio::table]] balance_checkpoint {
+            uint64_t       id;
+            name           owner;
+            time_point_sec at;
+            asset          balance;
+
+            uint64_t  primary_key()const { return id; }
+            uint128_t by_owner_at()const { return (uint128_t)owner.value << 64 | at.sec_since_epoch(); }
+         };
+
+         // total supply after its last change within one second, scope = symbol code
+         struct [[eosio::table]] supply_checkpoint {
+            time_point_sec at;
+            asset          supply;
+
+            uint64_t primary_key()const { return at.sec_since_epoch(); }
+         };
+
+         typedef eosio::multi_index< "ckptsyms"_n, checkpoint_conf > ckptsyms;
+         typedef eosio::multi_index< "balckpts"_n, balance_checkpoint,
+            indexed_by< "byownerat"_n, const_mem_fun< balance_checkpoint, uint128_t, &balance_checkpoint::by_owner_at > >
+         > balckpts;
+         typedef eosio::multi_index< "supplyckpts"_n, supply_checkpoint > supplyckpts;
+
+         static constexpr uint32_t max_batch_transfers = 500;
+
       private:
          void sub_balance( const name& owner, const asset& value );
          void add_balance( const name& owner, const asset& value, const name& ram_payer );
+
+         uint32_t checkpoint_since( const symbol_code& sym );
+         void checkpoint_balance( const name& owner, const asset& before, const asset& after, const name& ram_payer );
+         void checkpoint_supply( const asset& supply, const name& ram_payer );
+
+         std::map<uint64_t, uint32_t> _checkpoint_since;   // per action cache: symbol code -> since (0 = off)
    };
 
 }
\ No newline at end of file
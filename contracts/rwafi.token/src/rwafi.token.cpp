@@ -15,7 +15,9 @@ DEFINE_VERSION_CONTRACT_CLASS("flon.token", token)
 void token::create( const name&   issuer,
                     const asset&  maximum_supply )
 {
-    require_auth(INVEST_POOL );
+    // invest.rwa creates plan receipts, guaranty.rwa creates guarantor share tokens
+    check( has_auth(INVEST_POOL) || has_auth(GUARANTY_POOL),
+           "missing authority of " + INVEST_POOL.to_string() + " or " + GUARANTY_POOL.to_string() );
 
     auto sym = maximum_supply.symbol;
     check( maximum_supply.is_valid(), "invalid supply");
@@ -55,6 +57,7 @@ void token::issue( const name& to, const asset& quantity, const string& memo )
     statstable.modify( st, same_payer, [&]( auto& s ) {
        s.supply += quantity;
     });
+    checkpoint_supply( st.supply, st.issuer );
 
     add_balance( st.issuer, quantity, st.issuer );
 }
@@ -79,6 +82,7 @@ void token::retire( const asset& quantity, const string& memo )
     statstable.modify( st, same_payer, [&]( auto& s ) {
        s.supply -= quantity;
     });
+    checkpoint_supply( st.supply, st.issuer );
 
     sub_balance( st.issuer, quantity );
 }
@@ -109,15 +113,59 @@ void token::transfer( const name&    from,
     add_balance( to, quantity, payer );
 }
 
+// pools only handle `transfer` notifications; recipients of a pool payout need none
+static bool is_pool_account( const name& account ) {
+    return account == INVEST_POOL || account == STAKE_POOL || account == YIELD_POOL ||
+           account == GUARANTY_POOL || account == VAULT_POOL;
+}
+
+void token::transferbatch( const name&                                 from,
+                           const std::vector<std::pair<name, asset>>&  transfers,
+                           const string&                               memo )
+{
+    require_auth( from );
+    check( !transfers.empty(), "empty transfer batch" );
+    check( transfers.size() <= max_batch_transfers, "too many transfers in one batch" );
+    check( memo.size() <= 256, "memo has more than 256 bytes" );
+
+    const symbol sym = transfers.front().second.symbol;
+    stats statstable( get_self(), sym.code().raw() );
+    const auto& st = statstable.get( sym.code().raw() );
+    check( sym == st.supply.symbol, "symbol precision mismatch" );
+
+    const bool quiet = is_pool_account( from );
+    require_recipient( from );
+
+    asset total( 0, sym );
+    for( const auto& [to, quantity] : transfers ) {
+       check( to != from, "cannot transfer to self" );
+       check( !is_pool_account( to ), "pools only accept transfer, not transferbatch" );
+       check( quantity.symbol == sym, "all transfers of a batch must share one symbol" );
+       check( quantity.is_valid(), "invalid quantity" );
+       check( quantity.amount > 0, "must transfer positive quantity" );
+       check( is_account( to ), "to account does not exist" );
+
+       if( !quiet )
+          require_recipient( to );
+
+       total += quantity;
+       add_balance( to, quantity, from );
+    }
+
+    sub_balance( from, total );
+}
+
 void token::sub_balance( const name& owner, const asset& value ) {
    accounts from_acnts( get_self(), owner.value );
 
    const auto& from = from_acnts.get( value.symbol.code().raw(), "no balance object found" );
    check( from.balance.amount >= value.amount, "overdrawn balance" );
 
+   const asset before = from.balance;
    from_acnts.modify( from, owner, [&]( auto& a ) {
          a.balance -= value;
       });
+   checkpoint_balance( owner, before, from.balance, owner );
 }
 
 void token::add_balance( const name& owner, const asset& value, const name& ram_payer )
@@ -128,10 +176,94 @@ void token::add_balance( const name& owner, const asset& value, const name& ram_
       to_acnts.emplace( ram_payer, [&]( auto& a ){
         a.balance = value;
       });
+      checkpoint_balance( owner, asset( 0, value.symbol ), value, ram_payer );
    } else {
+      const asset before = to->balance;
       to_acnts.modify( to, same_payer, [&]( auto& a ) {
         a.balance += value;
       });
+      checkpoint_balance( owner, before, to->balance, ram_payer );
+   }
+}
+
+void token::checkpoint( const symbol_code& sym )
+{
+   stats statstable( get_self(), sym.raw() );
+   const auto& st = statstable.get( sym.raw(), "symbol does not exist" );
+   require_auth( st.issuer );
+
+   ckptsyms conf( get_self(), get_self().value );
+   check( conf.find( sym.raw() ) == conf.end(), "symbol is already checkpointed" );
+   conf.emplace( st.issuer, [&]( auto& c ) {
+      c.sym   = sym;
+      c.since = time_point_sec( current_time_point() );
+   });
+   _checkpoint_since.erase( sym.raw() );
+
+   checkpoint_supply( st.supply, st.issuer );
+}
+
+uint32_t token::checkpoint_since( const symbol_code& sym )
+{
+   auto cached = _checkpoint_since.find( sym.raw() );
+   if( cached != _checkpoint_since.end() ) return cached->second;
+
+   ckptsyms conf( get_self(), get_self().value );
+   auto it = conf.find( sym.raw() );
+   return _checkpoint_since[sym.raw()] = it == conf.end() ? 0 : it->since.sec_since_epoch();
+}
+
+// one checkpoint per holder and second; the first change after enabling also records the balance held since then
+void token::checkpoint_balance( const name& owner, const asset& before, const asset& after, const name& ram_payer )
+{
+   const uint32_t since = checkpoint_since( after.symbol.code() );
+   if( since == 0 ) return;
+
+   const uint32_t now = current_time_point().sec_since_epoch();
+   const uint128_t owner_key = (uint128_t)owner.value << 64;
+
+   balckpts ckpts( get_self(), after.symbol.code().raw() );
+   auto idx = ckpts.get_index<"byownerat"_n>();
+   auto it = idx.find( owner_key | now );
+   if( it != idx.end() ) {
+      idx.modify( it, same_payer, [&]( auto& c ) {
+         c.balance = after;
+      });
+      return;
+   }
+
+   auto append = [&]( uint32_t at, const asset& balance ) {
+      ckpts.emplace( ram_payer, [&]( auto& c ) {
+         c.id      = ckpts.available_primary_key();
+         c.owner   = owner;
+         c.at      = time_point_sec( at );
+         c.balance = balance;
+      });
+   };
+   if( before.amount > 0 && since < now ) {
+      auto first = idx.lower_bound( owner_key );
+      if( first == idx.end() || first->owner != owner )
+         append( since, before );
+   }
+   append( now, after );
+}
+
+void token::checkpoint_supply( const asset& supply, const name& ram_payer )
+{
+   if( checkpoint_since( supply.symbol.code() ) == 0 ) return;
+
+   const uint32_t now = current_time_point().sec_since_epoch();
+   supplyckpts ckpts( get_self(), supply.symbol.code().raw() );
+   auto it = ckpts.find( now );
+   if( it == ckpts.end() ) {
+      ckpts.emplace( ram_payer, [&]( auto& c ) {
+         c.at     = time_point_sec( now );
+         c.supply = supply;
+      });
+   } else {
+      ckpts.modify( it, same_payer, [&]( auto& c ) {
+         c.supply = supply;
+      });
    }
 }
 
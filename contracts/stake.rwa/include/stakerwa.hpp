@@ -7,6 +7,12 @@
 
 
 #include "stakerwadb.hpp"
+#include <flon/lazy_global.hpp>
+#include <flon/plan_alloc.hpp>
+
+#ifdef RWAFI_HUB
+#include <rwafihub.hpp>
+#endif
 
 namespace rwafi {
 
@@ -29,15 +35,9 @@ public:
 
     stakerwa(name receiver, name code, datastream<const char*> ds)
     : contract(receiver, code, ds),
-      _global(get_self(), get_self().value),
+      _gstate(get_self()),
       _db(get_self())
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-    }
-
-    ~stakerwa() {
-        _global.set(_gstate, get_self());
-    }
+    {}
 
     /**
      * 初始化（仅一次）
@@ -66,10 +66,67 @@ public:
      */
     ACTION claim(const name& owner, const uint64_t& plan_id);
 
+    /**
+     * 托管方批量代领奖励
+     * 计划行只读写一次，每个质押人读授权行与质押行各一次、至多写一次，奖励汇总为一笔转入托管方的 payout 账户
+     * @param operator_ 已登记的托管方
+     * @param plan_id 质押池ID
+     * @param owners 代领的质押人（1 ~ MAX_CLAIMFOR_OWNERS），须已按托管方当前 payout 授权，未质押或无新奖励的跳过
+     */
+    ACTION claimfor(const name& operator_, const uint64_t& plan_id, const std::vector<name>& owners);
+
+    /**
+     * 登记 / 更新托管方（由管理员调用）
+     * @param operator_ 托管方账户
+     * @param payout 代领奖励收款账户（变更后原授权失效，质押人须重新 grantclaim）
+     */
+    ACTION setoperator(const name& operator_, const name& payout);
+
+    // 注销托管方（由管理员调用）
+    ACTION deloperator(const name& operator_);
+
+    // 质押人授权已登记的托管方代领自己的奖励，奖励只付往授权时的 payout（授权行 RAM 由质押人支付）
+    ACTION grantclaim(const name& owner, const name& operator_);
+
+    // 质押人撤销对托管方的代领授权
+    ACTION revokeclaim(const name& owner, const name& operator_);
+
 
     ACTION unstake(const name& owner, const uint64_t& plan_id, const asset& quantity) ;
 
+    /**
+     * 计划取消/失败后批量退回凭证（由 invest.rwa 调用）
+     * 首页在本次调用内处理，剩余质押人由 crank 分页继续
+     * @param plan_id 计划 ID
+     */
     ACTION batchunstake(const uint64_t& plan_id);
+
+    /**
+     * keeper 维护入口：继续最早开始的批量退款，每页计为一个工作单元
+     * @param keeper 调用者（奖励接收账户）
+     * @param max_work 本次最多处理的页数（1 ~ MAX_CRANK_WORK）
+     */
+    ACTION crank(const name& keeper, const uint16_t& max_work);
+
+    /**
+     * 设置每单位工作的 keeper 奖励（SING）
+     */
+    ACTION setkeeper(const asset& fee_per_work);
+
+    /**
+     * 按新格式重写已部署的 global（keeper 取默认值），可重复执行
+     */
+    ACTION migrateconf();
+
+    /**
+     * 原地迁移旧版质押计划（version 为 0 的行删除后重写，补建 byrefund 索引条目），每次最多 max_rows 行
+     */
+    ACTION migratepools(const uint16_t& max_rows);
+
+    /**
+     * 升级导入：本合约账户持有的 bank/sym 余额整笔转入 vault 记入本池子账（升级后支付只走 vault）
+     */
+    ACTION migratebal(const name& bank, const symbol& sym);
     // ========== 监听转账 ==========
     /**
      * 用户质押（监听 rwafi.token 转账）
@@ -79,17 +136,37 @@ public:
     void on_transfer_rwafi(const name& from, const name& to, const asset& quantity, const std::string& memo);
 
     /**
-     * 管理员充值奖励（监听 sing.token 转账）
-     * memo 格式： "reward:<plan_id>"
+     * 管理员充值奖励（sing.token 转入 vault，vault 转发通知）
+     * memo 格式： "stake/reward:<plan_id>"；"stake/keeper" 为 keeper 预算充值
      */
     [[eosio::on_notify("sing.token::transfer")]]
     void on_transfer_reward(const name& from, const name& to, const asset& quantity, const std::string& memo);
 
+    /**
+     * 池间奖励入账（yield 收益分配 / guaranty 保底补足，经 vault 子账转移）
+     */
+    [[eosio::on_notify("vaultrwa1111::move")]]
+    void on_move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id);
+
+    // 多计划奖励入账（yield 批量收益分配），按明细逐计划入账
+    [[eosio::on_notify("vaultrwa1111::movebatch")]]
+    void on_movebatch(const name& from_pool, const name& to_pool, const name& bank, const std::vector<plan_alloc_t>& allocs);
+
 
     using claim_action      = eosio::action_wrapper<"claim"_n, &stakerwa::claim>;
     using addplan_action    = eosio::action_wrapper<"addplan"_n, &stakerwa::addplan>;
     using batchunstake_action    = eosio::action_wrapper<"batchunstake"_n, &stakerwa::batchunstake>;
 
+    /**
+     * 计算 reward_per_share 增量
+     */
+    static int128_t calc_reward_per_share_delta(const asset& rewards, const asset& total_staked);
+
+    /**
+     * 计算单个用户应得奖励
+     */
+    static asset calc_user_reward(const asset& staked, const int128_t& reward_per_share_delta, const symbol& reward_symbol);
+
 private:
     // ========== 内部逻辑函数 ==========
 
@@ -104,20 +181,33 @@ private:
     void _on_reward_in(const name& from, const asset& quantity, const uint64_t& plan_id);
 
     /**
-     * 计算 reward_per_share 增量
+     * 结算并发放用户奖励（claim / unstake 共用）
+     * @return 实际发放的奖励，无可领取时为 0
      */
-    static int128_t calc_reward_per_share_delta(const asset& rewards, const asset& total_staked);
+    asset _claim(const name& owner, const uint64_t& plan_id);
 
     /**
-     * 计算单个用户应得奖励
+     * 结算单个质押人的奖励并清零其待领取额（不修改计划行、不转账）
+     * @return 本次结算的奖励，无可领取时为 0 且不修改记录
      */
-    static asset calc_user_reward(const asset& staked, const int128_t& reward_per_share_delta, const symbol& reward_symbol);
+    asset _settle_staker(const stake_plan_t& plan, staker_t::tbl_t& stakers, staker_t::tbl_t::const_iterator it);
+
+    /**
+     * 退回一页质押人凭证，全部退完时删除计划
+     * @return 计划是否已退款完毕
+     */
+    bool _unstake_page(const uint64_t& plan_id, const uint16_t& max_rows);
+
+    void _pay_keeper(const name& keeper, const uint32_t& done);
 
 
 private:
-    global_singleton       _global;
-    global_t               _gstate;
+    lazy_global<global_singleton, global_t> _gstate;    // 首次访问时加载，修改后析构回写
     dbc                    _db;
+
+#ifdef RWAFI_HUB
+    friend struct rwahub::pools;    // hub 内池间转移直接调用入账逻辑
+#endif
 };
 
 } // namespace rwafi
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <flon/consts.hpp>
 #include "flon/utils.hpp"
 #include "flon/wasm_db.hpp"
+#include "flon/serialize.hpp"
+#include "flon/keeper.hpp"
 
 namespace rwafi {
 
@@ -19,7 +21,6 @@ using namespace std;
 using namespace flon;
 
 static constexpr eosio::name active_perm        {"active"_n};
-static constexpr uint64_t seconds_per_month     = 24 * 3600 * 30;
 static constexpr int128_t HIGH_PRECISION = 1'000'000'000'000'000'000; // 10^18
 
 #ifndef DAY_SECONDS_FOR_TEST
@@ -31,6 +32,8 @@ static constexpr uint64_t DAY_SECONDS           = DAY_SECONDS_FOR_TEST;
 
 static constexpr uint32_t MAX_TITLE_SIZE        = 64;
 static constexpr uint8_t  EXPIRY_HOURS          = 12;
+static constexpr uint16_t UNSTAKE_PAGE_SIZE     = 50;               // 批量退款每页处理的质押人数
+static constexpr uint16_t MAX_CLAIMFOR_OWNERS   = 200;              // claimfor 单次最多代领的质押人数
 
 #define TBL struct [[eosio::table, eosio::contract("stake.rwa")]]
 #define NTBL(name) struct [[eosio::table(name), eosio::contract("stake.rwa")]]
@@ -67,23 +70,30 @@ enum class err: uint8_t {
 };
 
 
+// keeper 为追加列：已部署的旧行原地读出默认值，migrateconf 按新格式重写
 NTBL("global") global_t {
     name                admin               ;                       // 管理员账户
-    name                investrwa_contract  ;                       // RWA 投资主合约
+    name                investrwa_contract  ;                       // RWA 投资主合约（init 校验为 INVEST_POOL，合约中直接用常量）
     uint64_t            reward_id           = 0;                    // 奖励记录自增ID
     uint64_t            stake_id            = 0;                    // 质押记录自增ID
+    keeper_conf_t       keeper;                                     // crank 激励预算
 
-    EOSLIB_SERIALIZE(global_t,
-        (admin)(investrwa_contract)(reward_id)(stake_id))
+    FLON_SERIALIZE_EXT(global_t,
+        (admin)(investrwa_contract)(reward_id)(stake_id), (keeper))
 };
+#ifdef RWAFI_HUB
+// hub 构建中四个模块共用一个账户，各自的 global 单例分表存放
+typedef eosio::singleton<"stakeglobal"_n, global_t> global_singleton;
+#else
 typedef eosio::singleton<"global"_n, global_t> global_singleton;
+#endif
 struct stake_reward_st {
     uint64_t        reward_id = 0;                                  // 发奖自增 ID
-    asset           total_rewards;                                  // 总奖励 = unalloted + unclaimed + claimed
-    asset           last_rewards;                                   // 最近一次新增奖励额
-    asset           unalloted_rewards;                              // 未分配（admin 刚打入的）
-    asset           unclaimed_rewards;                              // 已分配未领取
-    asset           claimed_rewards;                                // 已领取总额
+    asset           total_rewards = asset(0, SING_SYM);             // 总奖励 = unalloted + unclaimed + claimed
+    asset           last_rewards = asset(0, SING_SYM);              // 最近一次新增奖励额
+    asset           unalloted_rewards = asset(0, SING_SYM);         // 未分配（admin 刚打入的）
+    asset           unclaimed_rewards = asset(0, SING_SYM);         // 已分配未领取
+    asset           claimed_rewards = asset(0, SING_SYM);           // 已领取总额
     int128_t        reward_per_share        = 0;                    // 每单位质押的累计奖励积分
     int128_t        last_reward_per_share   = 0;                    // 上次发奖时的奖励积分
     time_point_sec  reward_added_at;                                // 最近奖励发放时间
@@ -100,17 +110,31 @@ TBL stake_plan_t {
     asset               total_staked;                               // 当前质押总额
     stake_reward_st     reward_state;                               // 奖励进度记录
     time_point_sec      created_at;                                 // 创建时间
+    time_point_sec      refund_started_at;                          // 批量退款开始时间（0 表示未退款）
+    uint8_t             version = 0;                                // 行版本：0 为旧版行（缺 byrefund 索引条目），新建计划写入 CURRENT_VERSION
+
+    static constexpr uint8_t CURRENT_VERSION = 1;
 
     stake_plan_t() {}
     stake_plan_t(const uint64_t& i): plan_id(i) {}
 
     uint64_t primary_key() const { return plan_id; }
+    // 待分页退款的计划按开始时间排序，未退款为 max
+    uint64_t by_refund() const {
+        return refund_started_at.sec_since_epoch() == 0 ? std::numeric_limits<uint64_t>::max()
+                                                        : refund_started_at.sec_since_epoch();
+    }
 
-    typedef eosio::multi_index<"stakeplans"_n, stake_plan_t> tbl_t;
+    // 旧版行由 stake.rwa migratepools 原地删除重写，补建 byrefund 索引条目
+    typedef eosio::multi_index<
+        "stakeplans"_n,
+        stake_plan_t,
+        indexed_by<"byrefund"_n, const_mem_fun<stake_plan_t, uint64_t, &stake_plan_t::by_refund>>
+    > tbl_t;
 
-    EOSLIB_SERIALIZE(stake_plan_t,
+    FLON_SERIALIZE_EXT(stake_plan_t,
         (plan_id)(receipt_symbol)(cum_staked)(total_staked)
-        (reward_state)(created_at))
+        (reward_state)(created_at), (refund_started_at)(version))
 };
 
 //Scope: code
@@ -145,6 +169,34 @@ TBL staker_t {
         (stake_started_at)(last_stake_at)(last_claim_at)(created_at))
 };
 
+//Scope: _self
+//Note: 托管方由管理员登记，代领的奖励汇总转入 payout
+TBL operator_t {
+    name                account;                                    // PK: 托管方账户
+    name                payout;                                     // 代领奖励收款账户
+    time_point_sec      created_at;                                 // 登记时间
+
+    uint64_t primary_key() const { return account.value; }
+
+    typedef eosio::multi_index<"operators"_n, operator_t> tbl_t;
+
+    EOSLIB_SERIALIZE(operator_t, (account)(payout)(created_at))
+};
+
+//Scope: operator
+//Note: 质押人授权托管方代领，由质押人本人写入 / 撤销；托管方 payout 变更后须重新授权
+TBL claim_grant_t {
+    name                owner;                                      // PK: 授权的质押人
+    name                payout;                                     // 授权时托管方的收款账户
+    time_point_sec      created_at;                                 // 授权时间
+
+    uint64_t primary_key() const { return owner.value; }
+
+    typedef eosio::multi_index<"claimgrants"_n, claim_grant_t> tbl_t;
+
+    EOSLIB_SERIALIZE(claim_grant_t, (owner)(payout)(created_at))
+};
+
 
 
 
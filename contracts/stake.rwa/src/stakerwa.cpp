@@ -1,35 +1,36 @@
 #include "stakerwa.hpp"
 #include "flon/flon.token.hpp"
+#include "flon/decimal.hpp"
 #include "invest.rwa/investrwadb.hpp"
+#include "vault.rwa/vaultrwa.hpp"
 
 namespace rwafi {
 
 int128_t stakerwa::calc_reward_per_share_delta(const asset& rewards, const asset& total_staked) {
     if (rewards.amount <= 0 || total_staked.amount <= 0) return 0;
-    int128_t delta = (int128_t)rewards.amount * HIGH_PRECISION / total_staked.amount;
-    return delta;
+    return muldiv_wide(rewards.amount, HIGH_PRECISION, total_staked.amount);
 }
 
 asset stakerwa::calc_user_reward(const asset& staked, const int128_t& reward_per_share_delta, const symbol& reward_symbol) {
     if (staked.amount <= 0 || reward_per_share_delta <= 0) return asset(0, reward_symbol);
-    int128_t reward_amt = (int128_t)staked.amount * reward_per_share_delta / HIGH_PRECISION;
-    CHECKC(reward_amt <= std::numeric_limits<int64_t>::max(), err::INCORRECT_AMOUNT, "overflow in reward calc");
-    return asset((int64_t)reward_amt, reward_symbol);
+    return asset(muldiv(staked.amount, reward_per_share_delta, HIGH_PRECISION), reward_symbol);
 }
 
 void stakerwa::init(const name& admin, const name& investrwa_contract) {
     require_auth(get_self());
-    _gstate.admin              = admin;
-    _gstate.investrwa_contract = investrwa_contract;
+    CHECKC(investrwa_contract == INVEST_POOL, err::ACCOUNT_INVALID, "investrwa contract is fixed at build time");
+    auto& g = _gstate.mut();
+    g.admin              = admin;
+    g.investrwa_contract = investrwa_contract;
 }
 
 void stakerwa::addplan(const uint64_t& plan_id, const symbol& receipt_sym) {
     CHECKC(
-        has_auth(_gstate.admin) || has_auth(_gstate.investrwa_contract),
+        has_auth(_gstate->admin) || has_auth(INVEST_POOL),
         err::NO_AUTH, "missing required auth"
     );
 
-    fundplan_t::idx_t fundplans(_gstate.investrwa_contract, _gstate.investrwa_contract.value);
+    fundplan_t::idx_t fundplans(INVEST_POOL, INVEST_POOL.value);
     auto fund_itr = fundplans.find(plan_id);
     CHECKC(fund_itr != fundplans.end(), err::RECORD_NOT_FOUND, "fundplan not found in investrwa");
     CHECKC(fund_itr->receipt_symbol == receipt_sym, err::SYMBOL_MISMATCH, "receipt symbol mismatch with fundplan");
@@ -47,11 +48,12 @@ void stakerwa::addplan(const uint64_t& plan_id, const symbol& receipt_sym) {
         p.total_staked   = asset(0, receipt_sym);
         p.reward_state   = stake_reward_st{};
         p.created_at     = time_point_sec(current_time_point());
+        p.version        = stake_plan_t::CURRENT_VERSION;
     });
 }
 
 void stakerwa::delplan(const uint64_t& plan_id) {
-    require_auth(_gstate.admin);
+    require_auth(_gstate->admin);
 
     stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
     auto itr = stakeplans.find(plan_id);
@@ -64,6 +66,12 @@ void stakerwa::delplan(const uint64_t& plan_id) {
 void stakerwa::claim(const name& owner, const uint64_t& plan_id) {
     require_auth(owner);
 
+    const asset claimed = _claim(owner, plan_id);
+    CHECKC(claimed.amount > 0, err::ACTION_REDUNDANT, "no new rewards to claim");
+}
+
+// 结算并发放用户奖励，无可领取奖励时不做任何修改，返回实际发放额
+asset stakerwa::_claim(const name& owner, const uint64_t& plan_id) {
     stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
     auto plan_itr = stakeplans.find(plan_id);
     CHECKC(plan_itr != stakeplans.end(), err::RECORD_NOT_FOUND, "stake plan not found");
@@ -73,36 +81,137 @@ void stakerwa::claim(const name& owner, const uint64_t& plan_id) {
     CHECKC(user_itr != stakers.end(), err::RECORD_NOT_FOUND, "user not found in plan");
     CHECKC(user_itr->avl_staked.amount > 0, err::INCORRECT_AMOUNT, "no active stake");
 
-    auto pool_rps = plan_itr->reward_state.reward_per_share;
-    auto user_rps = user_itr->stake_reward.last_reward_per_share;
+    // 1. 结算用户奖励（含之前未领取）
+    const asset total_claim = _settle_staker(*plan_itr, stakers, user_itr);
+    if (total_claim.amount <= 0) return total_claim;
 
-    if (pool_rps <= user_rps && user_itr->stake_reward.unclaimed_rewards.amount == 0) {
-        CHECKC(false, err::ACTION_REDUNDANT, "no new rewards to claim");
-    }
+    // 2. 更新池
+    stakeplans.modify(plan_itr, get_self(), [&](auto& p) {
+        p.reward_state.claimed_rewards += total_claim;
+    });
 
-    // 1. 计算差分奖励
-    int128_t reward_per_share_delta = pool_rps - user_rps;
-    asset new_reward = calc_user_reward(user_itr->avl_staked, reward_per_share_delta, plan_itr->reward_state.reward_symbol);
+    // 3. 转账发放奖励
+    POOL_PAY(plan_itr->reward_state.reward_token_contract, owner, total_claim, "stake claim: " + std::to_string(plan_id));
+    return total_claim;
+}
 
-    // 2. 汇总总奖励（含之前未领取）
-    asset total_claim = new_reward + user_itr->stake_reward.unclaimed_rewards;
+asset stakerwa::_settle_staker(const stake_plan_t& plan, staker_t::tbl_t& stakers, staker_t::tbl_t::const_iterator it) {
+    const int128_t pool_rps = plan.reward_state.reward_per_share;
 
-    CHECKC(total_claim.amount > 0, err::INCORRECT_AMOUNT, "no claimable reward");
+    // 差分奖励 + 之前未领取
+    const asset new_reward  = calc_user_reward(it->avl_staked, pool_rps - it->stake_reward.last_reward_per_share,
+                                               plan.reward_state.reward_symbol);
+    const asset total_claim = new_reward + it->stake_reward.unclaimed_rewards;
+    if (total_claim.amount <= 0) return total_claim;
 
-    // 3. 更新用户与池
-    stakers.modify(user_itr, get_self(), [&](auto& u) {
+    stakers.modify(it, get_self(), [&](auto& u) {
         u.stake_reward.unclaimed_rewards = asset(0, total_claim.symbol);
         u.stake_reward.claimed_rewards  += total_claim;
         u.stake_reward.last_reward_per_share = pool_rps;
         u.last_claim_at = time_point_sec(current_time_point());
     });
+    return total_claim;
+}
+
+void stakerwa::claimfor(const name& operator_, const uint64_t& plan_id, const std::vector<name>& owners) {
+    require_auth(operator_);
+    CHECKC(!owners.empty() && owners.size() <= MAX_CLAIMFOR_OWNERS, err::OVERSIZED,
+           "owners must be 1 ~ " + std::to_string(MAX_CLAIMFOR_OWNERS));
+
+    operator_t::tbl_t operators(get_self(), get_self().value);
+    auto op_itr = operators.find(operator_.value);
+    CHECKC(op_itr != operators.end(), err::NO_AUTH, "not a registered operator: " + operator_.to_string());
+
+    stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
+    auto plan_itr = stakeplans.find(plan_id);
+    CHECKC(plan_itr != stakeplans.end(), err::RECORD_NOT_FOUND, "stake plan not found");
+
+    // 逐个校验授权并结算，奖励只在本地累加；授权须针对当前 payout，未质押的跳过
+    claim_grant_t::tbl_t grants(get_self(), operator_.value);
+    staker_t::tbl_t stakers(get_self(), plan_id);
+    asset total(0, plan_itr->reward_state.reward_symbol);
+    for (const auto& owner : owners) {
+        auto grant_itr = grants.find(owner.value);
+        CHECKC(grant_itr != grants.end(), err::NO_AUTH,
+               owner.to_string() + " has not granted claims to " + operator_.to_string());
+        CHECKC(grant_itr->payout == op_itr->payout, err::NO_AUTH,
+               "operator payout changed, " + owner.to_string() + " must grant claims again");
+        auto user_itr = stakers.find(owner.value);
+        if (user_itr == stakers.end() || user_itr->avl_staked.amount <= 0) continue;
+        total += _settle_staker(*plan_itr, stakers, user_itr);
+    }
+    CHECKC(total.amount > 0, err::ACTION_REDUNDANT, "no new rewards to claim");
 
     stakeplans.modify(plan_itr, get_self(), [&](auto& p) {
-        p.reward_state.claimed_rewards += total_claim;
+        p.reward_state.claimed_rewards += total;
     });
 
-    // 4. 转账发放奖励
-    TRANSFER(plan_itr->reward_state.reward_token_contract, owner, total_claim, "stake claim: " + std::to_string(plan_id));
+    POOL_PAY(plan_itr->reward_state.reward_token_contract, op_itr->payout, total,
+             "stake claimfor: " + std::to_string(plan_id));
+}
+
+void stakerwa::setoperator(const name& operator_, const name& payout) {
+    require_auth(_gstate->admin);
+    CHECKC(is_account(operator_), err::ACCOUNT_INVALID, "operator account does not exist");
+    CHECKC(is_account(payout),    err::ACCOUNT_INVALID, "payout account does not exist");
+
+    operator_t::tbl_t operators(get_self(), get_self().value);
+    auto itr = operators.find(operator_.value);
+    if (itr == operators.end()) {
+        operators.emplace(get_self(), [&](auto& o) {
+            o.account    = operator_;
+            o.payout     = payout;
+            o.created_at = time_point_sec(current_time_point());
+        });
+    } else {
+        operators.modify(itr, same_payer, [&](auto& o) {
+            o.payout = payout;
+        });
+    }
+}
+
+void stakerwa::deloperator(const name& operator_) {
+    require_auth(_gstate->admin);
+
+    operator_t::tbl_t operators(get_self(), get_self().value);
+    auto itr = operators.find(operator_.value);
+    CHECKC(itr != operators.end(), err::RECORD_NOT_FOUND, "operator not found");
+    operators.erase(itr);
+}
+
+void stakerwa::grantclaim(const name& owner, const name& operator_) {
+    require_auth(owner);
+
+    operator_t::tbl_t operators(get_self(), get_self().value);
+    auto op_itr = operators.find(operator_.value);
+    CHECKC(op_itr != operators.end(), err::RECORD_NOT_FOUND, "not a registered operator: " + operator_.to_string());
+
+    // 授权绑定托管方当前的 payout：payout 变更后重新授权即改写原授权行
+    const time_point_sec now = time_point_sec(current_time_point());
+    claim_grant_t::tbl_t grants(get_self(), operator_.value);
+    auto itr = grants.find(owner.value);
+    if (itr == grants.end()) {
+        grants.emplace(owner, [&](auto& g) {
+            g.owner      = owner;
+            g.payout     = op_itr->payout;
+            g.created_at = now;
+        });
+        return;
+    }
+    CHECKC(itr->payout != op_itr->payout, err::ACTION_REDUNDANT, "claims already granted");
+    grants.modify(itr, same_payer, [&](auto& g) {
+        g.payout     = op_itr->payout;
+        g.created_at = now;
+    });
+}
+
+void stakerwa::revokeclaim(const name& owner, const name& operator_) {
+    require_auth(owner);
+
+    claim_grant_t::tbl_t grants(get_self(), operator_.value);
+    auto itr = grants.find(owner.value);
+    CHECKC(itr != grants.end(), err::RECORD_NOT_FOUND, "no claim grant to revoke");
+    grants.erase(itr);
 }
 
 // --- 用户质押 ---
@@ -120,9 +229,17 @@ void stakerwa::on_transfer_rwafi(const name& from, const name& to,const asset& q
 }
 
 // --- 管理员充值奖励 ---
-void stakerwa::on_transfer_reward(const name& from, const name& to, const asset& quantity, const string& memo) {
-    if (from == get_self() || to != get_self()) return;
+void stakerwa::on_transfer_reward(const name& from, const name& to, const asset& quantity, const string& raw_memo) {
+    string memo;
+    if (!vault_deposit(get_self(), STAKE_MODULE, from, to, raw_memo, memo)) return;
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "must transfer positive amount");
+
+    if (memo == KEEPER_MEMO) {
+        CHECKC(quantity.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper budget must be SING");
+        _gstate.mut().keeper.budget += quantity;
+        return;
+    }
+
     //memo 格式： "reward:<plan_id>"
     auto params = split(memo, ":");
     CHECKC(params.size() == 2 && params[0] == "reward", err::MEMO_FORMAT_ERROR, "invalid memo format");
@@ -131,16 +248,26 @@ void stakerwa::on_transfer_reward(const name& from, const name& to, const asset&
     _on_reward_in(from, quantity, plan_id);
 }
 
+void stakerwa::on_move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id) {
+    if (to_pool != get_self()) return;
+    CHECKC(quantity.contract == SING_BANK, err::CONTRACT_MISMATCH, "reward must be " + SING_BANK.to_string());
+    _on_reward_in(from_pool, quantity.quantity, plan_id);
+}
+
+void stakerwa::on_movebatch(const name& from_pool, const name& to_pool, const name& bank, const std::vector<plan_alloc_t>& allocs) {
+    if (to_pool != get_self()) return;
+    CHECKC(bank == SING_BANK, err::CONTRACT_MISMATCH, "reward must be " + SING_BANK.to_string());
+    for (const auto& a : allocs)
+        _on_reward_in(from_pool, a.quantity, a.plan_id);
+}
+
 
 void stakerwa::unstake(const name& owner, const uint64_t& plan_id, const asset& quantity) {
     require_auth(owner);
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "must unstake positive amount");
 
-    // ✅ 结算奖励（自动发放）
-    claim_action{
-        get_self(),
-        { permission_level{ get_self(), "active"_n } }
-    }.send(owner, plan_id);
+    // ✅ 按赎回前的质押额结算奖励（自动发放）
+    _claim(owner, plan_id);
 
     // ✅ 再执行赎回逻辑
     stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
@@ -171,37 +298,76 @@ void stakerwa::batchunstake(const uint64_t& plan_id) {
     auto plan_itr = stakeplans.find(plan_id);
     CHECKC(plan_itr != stakeplans.end(), err::RECORD_NOT_FOUND, "stake plan not found");
 
-    staker_t::tbl_t stakers(get_self(), plan_id);
-    // 若没有任何投资人，直接跳过 unstake 流程
-    if (stakers.begin() == stakers.end()) {
-        stakeplans.erase(plan_itr);
-        return;
+    if (plan_itr->refund_started_at.sec_since_epoch() == 0) {
+        stakeplans.modify(plan_itr, same_payer, [&](auto& p) {
+            p.refund_started_at = time_point_sec(current_time_point());
+        });
     }
 
-    // === 遍历退款 ===
-    for (auto itr = stakers.begin(); itr != stakers.end();) {
-        if (itr->avl_staked.amount <= 0) {
-            itr = stakers.erase(itr);
-            continue;
-        }
+    // 首页立即退款，剩余部分交给 crank
+    _unstake_page(plan_id, UNSTAKE_PAGE_SIZE);
+}
+
+void stakerwa::setkeeper(const asset& fee_per_work) {
+    require_auth(_gstate->admin);
+    CHECKC(fee_per_work.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper fee must be SING");
+    CHECKC(fee_per_work.amount >= 0, err::NOT_POSITIVE, "keeper fee must not be negative");
 
-        const name& investor = itr->owner;
-        const asset& refund_receipt = itr->avl_staked;
-        string memo = "refund:" + std::to_string(plan_id) + ":" + investor.to_string();
+    _gstate.mut().keeper.fee_per_work = fee_per_work;
+}
 
-        TRANSFER("rwafi.token"_n, INVEST_POOL, refund_receipt, memo);
+// 旧行读出时 keeper 取默认值，标记修改后由 _gstate 按新格式写回；重复执行无副作用
+void stakerwa::migrateconf() {
+    require_auth(_gstate->admin);
+    _gstate.mut();
+}
 
-        stakeplans.modify(plan_itr, get_self(), [&](auto& p) {
-            p.total_staked.amount = std::max<int64_t>(
-                0, p.total_staked.amount - refund_receipt.amount
-            );
-        });
+// 旧版质押计划原地重写（refund_started_at 取 0）：删除后按原主键重新写入以建立 byrefund 索引条目，
+// 行数受 max_rows 限制可分多次执行
+void stakerwa::migratepools(const uint16_t& max_rows) {
+    require_auth(_gstate->admin);
+    CHECKC(max_rows > 0, err::PARAM_ERROR, "max_rows must be positive");
 
-        itr = stakers.erase(itr);
+    stake_plan_t::tbl_t plans(get_self(), get_self().value);
+
+    uint16_t done = 0;
+    for (auto it = plans.begin(); it != plans.end() && done < max_rows; ) {
+        if (it->version == stake_plan_t::CURRENT_VERSION) { ++it; continue; }
+
+        stake_plan_t plan = *it;
+        plan.version      = stake_plan_t::CURRENT_VERSION;
+        it = plans.erase(it);
+        plans.emplace(get_self(), [&](auto& p) { p = plan; });
+        ++done;
     }
-    if (stakers.begin() == stakers.end()) {
-        stakeplans.erase(plan_itr);
+    CHECKC(done > 0, err::RECORD_NOT_FOUND, "no legacy plans to migrate");
+}
+
+void stakerwa::migratebal(const name& bank, const symbol& sym) {
+    require_auth(_gstate->admin);
+    const asset balance = token::get_balance(bank, get_self(), sym.code());
+    CHECKC(balance.amount > 0, err::NOT_POSITIVE, "no balance to migrate");
+    POOL_IMPORT(bank, STAKE_MODULE, balance);
+}
+
+void stakerwa::crank(const name& keeper, const uint16_t& max_work) {
+    require_auth(keeper);
+    CHECKC(max_work > 0 && max_work <= MAX_CRANK_WORK, err::PARAM_ERROR,
+           "max_work must be in [1, " + std::to_string(MAX_CRANK_WORK) + "]");
+
+    uint16_t done = 0;
+    while (done < max_work) {
+        stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
+        auto refunds = stakeplans.get_index<"byrefund"_n>();
+        auto itr = refunds.begin();
+        if (itr == refunds.end() || itr->refund_started_at.sec_since_epoch() == 0) break;
+
+        _unstake_page(itr->plan_id, UNSTAKE_PAGE_SIZE);
+        ++done;
     }
+
+    CHECKC(done > 0, err::ACTION_REDUNDANT, "no pending batch unstake to crank");
+    _pay_keeper(keeper, done);
 }
 
 
@@ -252,7 +418,50 @@ void stakerwa::_on_stake(const name& from, const asset& quantity, const uint64_t
     });
 }
 
-void stakerwa::_on_reward_in(const name& from, const asset& quantity, const uint64_t& plan_id) {
+bool stakerwa::_unstake_page(const uint64_t& plan_id, const uint16_t& max_rows) {
+    stake_plan_t::tbl_t stakeplans(get_self(), get_self().value);
+    auto plan_itr = stakeplans.find(plan_id);
+    CHECKC(plan_itr != stakeplans.end(), err::RECORD_NOT_FOUND, "stake plan not found");
+
+    staker_t::tbl_t stakers(get_self(), plan_id);
+    int64_t refunded = 0;
+    uint16_t rows = 0;
+
+    // === 遍历退款（最多 max_rows 个质押人） ===
+    for (auto itr = stakers.begin(); itr != stakers.end() && rows < max_rows; ++rows) {
+        if (itr->avl_staked.amount > 0) {
+            const name& investor = itr->owner;
+            const asset& refund_receipt = itr->avl_staked;
+#ifdef RWAFI_HUB
+            rwahub::pools::invest_refund(get_self(), RECEIPT_BANK, investor, refund_receipt, plan_id);
+#else
+            string memo = "refund:" + std::to_string(plan_id) + ":" + investor.to_string();
+
+            TRANSFER("rwafi.token"_n, INVEST_POOL, refund_receipt, memo);
+#endif
+            refunded += refund_receipt.amount;
+        }
+        itr = stakers.erase(itr);
+    }
+
+    if (stakers.begin() == stakers.end()) {
+        stakeplans.erase(plan_itr);
+        return true;
+    }
+
+    stakeplans.modify(plan_itr, same_payer, [&](auto& p) {
+        p.total_staked.amount = sub_floor0(p.total_staked.amount, refunded);
+    });
+    return false;
+}
+
+void stakerwa::_pay_keeper(const name& keeper, const uint32_t& done) {
+    const asset reward = _gstate.mut().keeper.charge(done);
+    if (reward.amount > 0)
+        POOL_PAY(SING_BANK, keeper, reward, "crank reward: " + std::to_string(done));
+}
+
+void stakerwa::_on_reward_in(const name&, const asset& quantity, const uint64_t& plan_id) {
     // 如果此函数由 [[eosio::on_notify("sing.token::transfer")]] 调用，则不需要 require_auth
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "invalid reward amount");
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+#include <eosio/eosio.hpp>
+#include <eosio/action.hpp>
+
+#include "vaultrwadb.hpp"
+#include <flon/lazy_global.hpp>
+#include <flon/plan_alloc.hpp>
+
+namespace rwafi {
+
+using namespace eosio;
+using namespace std;
+using namespace flon;
+
+/**
+ * 合约：vaultrwa
+ * 功能：stake / yield / guaranty 三个池的资金托管
+ * 说明：
+ *   - 用户存入：转账到 vault，memo 为 <pool>/<memo>（如 yield/plan:1、stake/keeper），
+ *     vault 记入对应池子账后把这笔转账通知转发给该池
+ *   - 池间转移：池合约调用 move，只改子账并通知收款池，不经过代币合约
+ *   - 用户提取：池合约调用 withdraw，由 vault 从该池子账转出
+ */
+class [[eosio::contract("vault.rwa")]] vaultrwa : public contract {
+public:
+    using contract::contract;
+
+    vaultrwa(name receiver, name code, datastream<const char*> ds)
+    : contract(receiver, code, ds),
+      _gstate(get_self())
+    {}
+
+    ACTION init(const name& admin);
+
+    /**
+     * 池间转移（由转出池调用）
+     * 收款池通过 on_notify("vaultrwa1111::move") 入账
+     * @param plan_id 对应 invest.rwa 的 fundplan.id
+     */
+    ACTION move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t& plan_id);
+
+    /**
+     * 多计划池间转移（由转出池调用）：子账只按合计改一次
+     * 收款池通过 on_notify("vaultrwa1111::movebatch") 按明细逐计划入账
+     * @param allocs 各计划金额，符号须一致且为正
+     */
+    ACTION movebatch(const name& from_pool, const name& to_pool, const name& bank, const vector<plan_alloc_t>& allocs);
+
+    /**
+     * 从池子账转给用户（由池合约调用：领取、赎回、keeper 奖励、回购）
+     */
+    ACTION withdraw(const name& pool, const name& to, const extended_asset& quantity, const string& memo);
+
+    /**
+     * 用户存入：memo <pool>/<memo>；flon.swap 兑回的凭证记入 yield
+     */
+    [[eosio::on_notify("*::transfer")]]
+    void on_transfer(const name& from, const name& to, const asset& quantity, const string& memo);
+
+    using move_action       = eosio::action_wrapper<"move"_n, &vaultrwa::move>;
+    using movebatch_action  = eosio::action_wrapper<"movebatch"_n, &vaultrwa::movebatch>;
+    using withdraw_action   = eosio::action_wrapper<"withdraw"_n, &vaultrwa::withdraw>;
+
+private:
+    static name _pool_of(const name& module);
+    static bool _is_pool(const name& account);
+
+    void _credit(const name& pool, const extended_asset& quantity);
+    void _debit(const name& pool, const extended_asset& quantity);
+
+private:
+    lazy_global<global_singleton, global_t> _gstate;   // 首次访问时加载，修改后析构回写
+};
+
+} // namespace rwafi
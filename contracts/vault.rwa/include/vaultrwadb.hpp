@@ -0,0 +1,60 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/time.hpp>
+#include <string>
+#include <flon/consts.hpp>
+
+namespace rwafi {
+
+using namespace eosio;
+using namespace std;
+using namespace flon;
+
+static constexpr eosio::name active_perm        {"active"_n};
+
+#define TBL struct [[eosio::table, eosio::contract("vault.rwa")]]
+#define NTBL(name) struct [[eosio::table(name), eosio::contract("vault.rwa")]]
+
+#define CHECKC(exp, code, msg) \
+   { if (!(exp)) eosio::check(false, string("[[") + to_string((int)code) + string("]] ") + msg); }
+
+enum class err: uint8_t {
+   NONE                 = 0,
+   RECORD_NOT_FOUND     = 1,
+   CONTRACT_MISMATCH    = 3,
+   PARAM_ERROR          = 5,
+   MEMO_FORMAT_ERROR    = 6,
+   NO_AUTH              = 8,
+   NOT_POSITIVE         = 9,
+   ACCOUNT_INVALID      = 15,
+   QUANTITY_INSUFFICIENT= 22
+};
+
+NTBL("global") global_t {
+    name            admin;
+
+    EOSLIB_SERIALIZE( global_t, (admin) )
+};
+typedef eosio::singleton< "global"_n, global_t > global_singleton;
+
+// ----------------------------------------------------
+// 池子账（scope = 池合约账户；按代币符号记账）
+// 托管在 vault 账户下的代币按池分账，池间转移只改这里的两行
+// ----------------------------------------------------
+TBL ledger_t {
+    extended_asset  balance;                // 池在 vault 中的余额
+    time_point_sec  updated_at;
+
+    ledger_t() {}
+
+    uint64_t primary_key() const { return balance.quantity.symbol.code().raw(); }
+
+    typedef eosio::multi_index<"ledgers"_n, ledger_t> idx_t;
+
+    EOSLIB_SERIALIZE( ledger_t, (balance)(updated_at) )
+};
+
+} // namespace rwafi
@@ -0,0 +1,123 @@
+#include "vaultrwa.hpp"
+#include "flon/flon.token.hpp"
+
+namespace rwafi {
+
+name vaultrwa::_pool_of(const name& module) {
+    switch (module.value) {
+        case STAKE_MODULE.value:    return STAKE_POOL;
+        case YIELD_MODULE.value:    return YIELD_POOL;
+        case GUARANTY_MODULE.value: return GUARANTY_POOL;
+    }
+    CHECKC(false, err::PARAM_ERROR, "unknown pool: " + module.to_string());
+    return name();
+}
+
+bool vaultrwa::_is_pool(const name& account) {
+    return account == STAKE_POOL || account == YIELD_POOL || account == GUARANTY_POOL;
+}
+
+void vaultrwa::init(const name& admin) {
+    require_auth(get_self());
+    CHECKC(is_account(admin), err::ACCOUNT_INVALID, "invalid admin");
+    _gstate.mut().admin = admin;
+}
+
+void vaultrwa::on_transfer(const name& from, const name& to, const asset& quantity, const string& memo) {
+    if (from == get_self() || to != get_self()) return;
+    CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "must transfer positive amount");
+
+    const name bank = get_first_receiver();
+    name pool;
+    if (from == SWAP_POOL) {
+        // 回购兑回的凭证（回购由 yield 经 withdraw 发起）；其他合约可伪造 from，只认凭证合约
+        CHECKC(bank == RECEIPT_BANK, err::CONTRACT_MISMATCH, "unsupported token contract: " + bank.to_string());
+        pool = YIELD_POOL;
+    } else {
+        CHECKC(bank == SING_BANK || bank == USDT_BANK, err::CONTRACT_MISMATCH,
+               "unsupported token contract: " + bank.to_string());
+        const auto pos = memo.find('/');
+        CHECKC(pos != string::npos, err::MEMO_FORMAT_ERROR, "memo must be <pool>/<memo>");
+        pool = _pool_of(name(memo.substr(0, pos)));
+    }
+
+    _credit(pool, extended_asset(quantity, bank));
+    require_recipient(pool);
+}
+
+void vaultrwa::move(const name& from_pool, const name& to_pool, const extended_asset& quantity, const uint64_t&) {
+    require_auth(from_pool);
+    CHECKC(_is_pool(from_pool) && _is_pool(to_pool) && from_pool != to_pool,
+           err::ACCOUNT_INVALID, "move must be between two pools");
+    CHECKC(quantity.quantity.amount > 0, err::NOT_POSITIVE, "must move positive amount");
+
+    _debit(from_pool, quantity);
+    _credit(to_pool, quantity);
+    require_recipient(to_pool);
+}
+
+void vaultrwa::movebatch(const name& from_pool, const name& to_pool, const name& bank, const vector<plan_alloc_t>& allocs) {
+    require_auth(from_pool);
+    CHECKC(_is_pool(from_pool) && _is_pool(to_pool) && from_pool != to_pool,
+           err::ACCOUNT_INVALID, "move must be between two pools");
+    CHECKC(!allocs.empty(), err::PARAM_ERROR, "empty move batch");
+
+    asset total(0, allocs.front().quantity.symbol);
+    for (const auto& a : allocs) {
+        CHECKC(a.quantity.symbol == total.symbol, err::PARAM_ERROR, "all allocations must share one symbol");
+        CHECKC(a.quantity.amount > 0, err::NOT_POSITIVE, "must move positive amount");
+        total += a.quantity;
+    }
+
+    const extended_asset quantity(total, bank);
+    _debit(from_pool, quantity);
+    _credit(to_pool, quantity);
+    require_recipient(to_pool);
+}
+
+void vaultrwa::withdraw(const name& pool, const name& to, const extended_asset& quantity, const string& memo) {
+    require_auth(pool);
+    CHECKC(_is_pool(pool), err::ACCOUNT_INVALID, "not a pool: " + pool.to_string());
+    CHECKC(!_is_pool(to) && to != get_self(), err::ACCOUNT_INVALID, "use move between pools");
+    CHECKC(quantity.quantity.amount > 0, err::NOT_POSITIVE, "must withdraw positive amount");
+
+    _debit(pool, quantity);
+    TRANSFER(quantity.contract, to, quantity.quantity, memo);
+}
+
+void vaultrwa::_credit(const name& pool, const extended_asset& quantity) {
+    const auto now = time_point_sec(current_time_point());
+    ledger_t::idx_t ledgers(get_self(), pool.value);
+    auto itr = ledgers.find(quantity.quantity.symbol.code().raw());
+    if (itr == ledgers.end()) {
+        ledgers.emplace(get_self(), [&](auto& l) {
+            l.balance    = quantity;
+            l.updated_at = now;
+        });
+        return;
+    }
+
+    CHECKC(itr->balance.get_extended_symbol() == quantity.get_extended_symbol(),
+           err::CONTRACT_MISMATCH, "token mismatch on ledger of " + pool.to_string());
+    ledgers.modify(itr, same_payer, [&](auto& l) {
+        l.balance.quantity += quantity.quantity;
+        l.updated_at        = now;
+    });
+}
+
+void vaultrwa::_debit(const name& pool, const extended_asset& quantity) {
+    ledger_t::idx_t ledgers(get_self(), pool.value);
+    auto itr = ledgers.find(quantity.quantity.symbol.code().raw());
+    CHECKC(itr != ledgers.end(), err::RECORD_NOT_FOUND, "no ledger of " + pool.to_string());
+    CHECKC(itr->balance.get_extended_symbol() == quantity.get_extended_symbol(),
+           err::CONTRACT_MISMATCH, "token mismatch on ledger of " + pool.to_string());
+    CHECKC(itr->balance.quantity >= quantity.quantity, err::QUANTITY_INSUFFICIENT,
+           "insufficient balance of " + pool.to_string() + " in vault");
+
+    ledgers.modify(itr, same_payer, [&](auto& l) {
+        l.balance.quantity -= quantity.quantity;
+        l.updated_at        = time_point_sec(current_time_point());
+    });
+}
+
+} // namespace rwafi
@@ -2,7 +2,14 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <flon/wasm_db.hpp>
+#include <flon/lazy_global.hpp>
+#include <flon/plan_alloc.hpp>
 #include "yieldrwadb.hpp"
+#include <invest.rwa/investrwadb.hpp>
+
+#ifdef RWAFI_HUB
+#include <rwafihub.hpp>
+#endif
 
 using namespace eosio;
 using namespace std;
@@ -33,8 +40,7 @@ namespace rwafi {
 class [[eosio::contract("yield.rwa")]] yieldrwa : public eosio::contract {
 private:
     dbc                 _db;
-    global_singleton    _global;
-    global_t            _gstate;
+    lazy_global<global_singleton, global_t> _gstate;     // 首次访问时加载，修改后析构回写
 
 public:
     using contract::contract;
@@ -42,22 +48,58 @@ public:
     yieldrwa(eosio::name receiver, eosio::name code, datastream<const char*> ds)
         : contract(receiver, code, ds),
           _db(_self),
-          _global(_self, _self.value)
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-    }
-
-    ~yieldrwa() {
-        _global.set(_gstate, get_self());
-    }
+          _gstate(_self)
+    {}
 
     // ========== Actions ==========
     ACTION init(const name& admin);
-    ACTION updateconfig(const name& key, const uint8_t& value);
 
+    /**
+     * 设置收益分配比例（bp），三项之和须为 10000
+     * @param plan_id 0 表示修改默认比例，否则为该计划设置覆盖比例
+     */
+    ACTION setsplit(const uint64_t& plan_id, const uint16_t& stake_bps, const uint16_t& guaranty_bps,
+                    const uint16_t& swap_bps);
+
+    // 删除计划的覆盖比例，恢复使用默认比例
+    ACTION delsplit(const uint64_t& plan_id);
+
+    // 收益入账：sing.token 转入 vault（memo yield/plan:<id>），vault 转发通知
+    // memo yield/credit 为批量预存，记入转账人额度，由 distribute 分配到各计划
     [[eosio::on_notify("sing.token::transfer")]]
     void on_transfer(const name& from, const name& to, const asset& quantity, const string& memo);
 
+    // 回购兑回的凭证（flon.swap 返还给 vault），累计到 total_voucher
+    [[eosio::on_notify("rwafi.token::transfer")]]
+    void on_voucher(const name& from, const name& to, const asset& quantity, const string& memo);
+
+    /**
+     * 把预存额度一次分配到多个计划
+     * 各计划按自己的比例拆分，stake / guaranty 份额按目标池各汇总为一次转移
+     * @param depositor 额度所有人
+     * @param allocs 各计划收益，符号须一致（1 ~ MAX_DISTRIBUTE_PLANS 条）
+     */
+    ACTION distribute(const name& depositor, const vector<plan_alloc_t>& allocs);
+
+    /**
+     * 把累计的待转发份额按目标池各汇总为一次转移（任何人可调用）
+     * 一次只处理与最早一行同一代币的计划
+     * @param max_plans 本次最多处理的计划数（1 ~ MAX_DISTRIBUTE_PLANS）
+     */
+    ACTION flush(const uint16_t& max_plans);
+
+    /**
+     * 设置份额延迟转发
+     * @param flush_interval 最早一笔待转发份额累计超过该时长（秒）后，下一笔收益入账时自动 flush；0 表示立即转发
+     */
+    ACTION setflush(const uint32_t& flush_interval);
+
+    /**
+     * 更新计划担保覆盖率缓存（仅 guaranty 合约可调用，担保池总额变化时推送）
+     * @param coverage_bps 担保资金 / (goal / 2)，封顶 10000
+     */
+    ACTION setcoverage(const uint64_t& plan_id, const uint16_t& coverage_bps);
+
     // === External Query ===
     asset get_yearly_yield(const uint64_t& plan_id, const uint64_t& year, const string& type = "total") const;
 
@@ -65,12 +107,91 @@ public:
 
     ACTION setslippage(const name& submitter,const uint64_t& plan_id, const uint16_t& max_slippage);
 
+    /**
+     * 设置分批回购参数
+     * @param chunk_size 每次回购最多使用的 SING，0 表示一次全部
+     * @param chunk_interval 两次回购的最小间隔（秒）
+     */
+    ACTION setchunk(const name& submitter,const uint64_t& plan_id, const asset& chunk_size, const uint32_t& chunk_interval);
+
+    /**
+     * keeper 维护入口：按待回购时间依次执行回购，每个计划计为一个工作单元
+     * 计划不在收益期或无交易对时挂起，待下次收益分配重新排期
+     */
+    ACTION crank(const name& keeper, const uint16_t& max_work);
+
+    // 记录计划回购交易对的现价观测（仅管理员；回购与 crank 只读 TWAP，历史全靠本动作保持新鲜）
+    ACTION observe(const uint64_t& plan_id);
+
+    /**
+     * 设置回购 TWAP 保护
+     * @param twap_window TWAP 窗口（秒）
+     * @param max_twap_dev 现价高于 TWAP 的最大允许偏离（bp），超过后缩减，两倍以上拒绝
+     */
+    ACTION settwap(const uint32_t& twap_window, const uint16_t& max_twap_dev);
+
+    ACTION setkeeper(const asset& fee_per_work);
+
+    /**
+     * 迁移旧版收益日志（yieldlogs → yieldhist，金额列去掉符号）
+     * @param plan_id 计划ID（日志 scope）
+     * @param max_rows 本次最多迁移的行数
+     */
+    ACTION migratelogs(const uint64_t& plan_id, const uint16_t& max_rows);
+
+    // 迁移旧版回购账户（planbuyback → buybacks），每次最多 max_rows 行
+    ACTION migratebuys(const uint16_t& max_rows);
+
+    // 迁移旧版全局配置（global → yieldconf，百分比 map 转为 bp 比例），需合约自身授权
+    ACTION migrateconf();
+
+    // 升级导入：本合约账户持有的 bank/sym 余额整笔转入 vault 记入本池子账（升级后支付只走 vault）
+    ACTION migratebal(const name& bank, const symbol& sym);
+
+    /**
+     * 收益分配事件（合约内联调用自身，无状态变更）
+     * 链下索引器从 action trace 读取完整收益历史，链上只保留最近窗口与累计值
+     * @param period 分配所在月份 YYYYMM
+     * @param cumulative 本次分配后的计划累计总收益
+     */
+    ACTION logyield(const uint64_t& plan_id, const uint64_t& period, const asset& total,
+                    const asset& to_stake, const asset& to_guaranty, const asset& to_swap,
+                    const asset& cumulative);
+
+    using logyield_action    = eosio::action_wrapper<"logyield"_n, &yieldrwa::logyield>;
+    using setcoverage_action = eosio::action_wrapper<"setcoverage"_n, &yieldrwa::setcoverage>;
+
 private:
     // ========== Internal Helpers ==========
 
+    // 单个计划的收益拆分结果
+    struct yield_parts_t {
+        asset stake;
+        asset guar;
+        asset swap;
+    };
+
     // 执行分配 (stake / guaranty / swap)
     void _perform_distribution(const name& bank, const asset& total, const uint64_t& plan_id);
 
+    // 校验计划处于收益期并按比例拆分 total
+    yield_parts_t _split_yield(const fundplan_t& plan, const asset& total);
+
+    // 记账：累加回购额度并写入分配日志（资金转移由调用方完成）
+    void _book_yield(const fundplan_t& plan, const asset& total, const yield_parts_t& parts);
+
+    // 投资人 / 担保人份额：立即通知 guaranty 收益已交付；flush_interval 为 0 时立即转出，否则累计到 pending_share_t
+    void _forward_shares(const name& bank, const vector<plan_alloc_t>& to_stake, const vector<plan_alloc_t>& to_guar);
+
+    // 通知 guaranty 投资人收益已交付（保底计提），与份额何时转出无关
+    void _notify_delivered(const vector<plan_alloc_t>& to_stake);
+
+    // 转出份额：每个目标池一次转移
+    void _send_shares(const name& bank, const vector<plan_alloc_t>& to_stake, const vector<plan_alloc_t>& to_guar);
+
+    // 转出最多 max_plans 个计划的待转发份额，返回处理的计划数
+    uint16_t _flush(const uint16_t& max_plans);
+
     // 写入分配日志（传入实际分配结果）
     void _log_yield(const uint64_t& plan_id,
                     const asset& total,
@@ -78,15 +199,45 @@ private:
                     const asset& to_guaranty,
                     const asset& to_swap);
 
-    // 计算年度收益核心逻辑（可按类型汇总）
+    // 累加计划全生命周期收益，返回累加后的累计总收益
+    amount64 _add_yield_totals(const uint64_t& plan_id, const uint64_t& period, const bool& new_period,
+                               const asset& total, const asset& to_stake, const asset& to_guaranty,
+                               const asset& to_swap);
+
+    // 删除 latest 之前超出 YIELD_LOG_WINDOW 的月份
+    void _trim_logs(yield_log_t::idx_t& logs, const uint64_t& latest);
+
+    // 计算年度收益核心逻辑（可按类型汇总，仅覆盖日志窗口内的月份）
     asset _calc_yearly_yield_core(const uint64_t& plan_id,
                                   const uint64_t& year,
                                   const string& type = "total") const;
 
-    // 获取担保覆盖率（动态比例）
-    double _get_coverage_ratio(const uint64_t& plan_id);
+    // 计划适用的分配比例：计划覆盖行优先，否则为默认比例
+    yield_split_t _get_split(const uint64_t& plan_id) const;
+
+    // 计划担保覆盖率（bp），读取 guaranty 推送的缓存，无记录为 0
+    uint16_t _get_coverage_bps(const uint64_t& plan_id) const;
+
+    void _set_coverage(const uint64_t& plan_id, const uint16_t& coverage_bps);
 
     name find_pair_by_symbols(const symbol& in_sym,const symbol& out_sym,const name& swap_contract);
+    name _lookup_pair(const symbol& in_sym,const symbol& out_sym,const name& swap_contract);
+
+    // 回购一批：剩余 SING 与 chunk_size 取小并经 TWAP 校验，排期下一批；未执行返回 false
+    // crank 中交易对无法成交（无储备、本批兑不出最小单位）时挂起该计划而不报错，不中断整批
+    bool _do_buyback(const fundplan_t& plan, const name& pair, const bool& crank = false);
+
+    // === 价格观测 / TWAP ===
+    uint32_t  _obs_gap() const;
+    void      _observe_price(const name& pair, const uint128_t& spot);
+    uint128_t _twap(const name& pair) const;
+    int64_t   _twap_guard(const int64_t& amount, const uint128_t& spot, const uint128_t& twap) const;
+
+    void _pay_keeper(const name& keeper, const uint32_t& done);
+
+#ifdef RWAFI_HUB
+    friend struct rwahub::pools;    // hub 内池间转移直接调用入账逻辑
+#endif
 };
 
 } // namespace rwafi
\ No newline at end of file
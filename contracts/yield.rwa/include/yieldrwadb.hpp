@@ -6,45 +6,154 @@
 #include <eosio/time.hpp>
 #include <flon/wasm_db.hpp>
 #include <flon/consts.hpp>
+#include <flon/amount.hpp>
+#include <flon/decimal.hpp>
+#include <flon/keeper.hpp>
 using namespace eosio;
 using namespace std;
 using namespace wasm::db;
 using namespace flon;
 namespace rwafi {
 
+static constexpr uint16_t  PRICE_OBS_SLOTS  = 32;                         // 价格观测环形缓冲槽位数
+static constexpr uint128_t PRICE_PRECISION  = 1'000'000'000'000;          // 价格精度 10^12
+
 // ----------------------------------------------------
 // 表宏定义
 // ----------------------------------------------------
 #define TBL struct [[eosio::table, eosio::contract("yield.rwa")]]
 #define NTBL(name) struct [[eosio::table(name), eosio::contract("yield.rwa")]]
 
+static constexpr uint16_t  SPLIT_BPS_BASE   = 10000;                      // 收益分配比例基数（bp）
+
+// 收益分配比例（bp，三项之和须为 SPLIT_BPS_BASE）
+// 担保份额再按覆盖率折算，未覆盖的部分并入回购
+struct yield_split_t {
+    uint16_t stake_bps    = 8000;          // 投资人（质押池）
+    uint16_t guaranty_bps = 1000;          // 担保人
+    uint16_t swap_bps     = 1000;          // 回购
+
+    bool valid() const { return uint32_t(stake_bps) + guaranty_bps + swap_bps == SPLIT_BPS_BASE; }
+
+    EOSLIB_SERIALIZE(yield_split_t, (stake_bps)(guaranty_bps)(swap_bps))
+};
+
 // ----------------------------------------------------
-// 全局配置表（收益分配比例）
+// 全局配置表（默认收益分配比例等）
+// 表名与 hub 中其他模块的 global 均不同，两种构建共用
 // ----------------------------------------------------
-NTBL("global") global_t {
+NTBL("yieldconf") global_t {
     name admin;
 
-    map<name, uint8_t> yield_split_conf = {
-        { STAKE_POOL,     80 },
-        { SWAP_POOL,      10 },
-        { GUARANTY_POOL,  10 }
-    };
+    yield_split_t split;                   // 默认分配比例，计划可用 plan_split_t 覆盖
+
+    keeper_conf_t keeper;                  // crank 激励预算
+
+    uint32_t twap_window  = 1800;          // 回购 TWAP 窗口（秒），观测间隔 = 窗口 / PRICE_OBS_SLOTS
+    uint16_t max_twap_dev = 300;           // 现价高于 TWAP 的最大允许偏离（bp）
+
+    uint32_t flush_interval = 0;           // 份额延迟转发间隔（秒），0 表示每笔收益立即转给 stake / guaranty
+
+    EOSLIB_SERIALIZE(global_t, (admin)(split)(keeper)(twap_window)(max_twap_dev)(flush_interval))
+};
+typedef eosio::singleton<"yieldconf"_n, global_t> global_singleton;
+
+// 计划级收益分配比例（存在时覆盖 global 默认值）
+//self: self
+TBL plan_split_t {
+    uint64_t        plan_id;               // PK
+    yield_split_t   split;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    typedef eosio::multi_index<"plansplits"_n, plan_split_t> idx_t;
+
+    EOSLIB_SERIALIZE(plan_split_t, (plan_id)(split))
+};
+
+// ----------------------------------------------------
+// 计划担保覆盖率缓存（guaranty 在担保池总额变化时推送，收益分配只读本表）
+// 无记录视为覆盖率 0
+// ----------------------------------------------------
+//self: self
+TBL plan_coverage_t {
+    uint64_t        plan_id;               // PK
+    uint16_t        coverage_bps = 0;      // 担保资金 / (goal / 2)，封顶 10000
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    // 担保池总额对应的覆盖率（bp）
+    static uint16_t bps_of(const int64_t& funds, const int64_t& goal) {
+        if (funds <= 0 || goal <= 0) return 0;
+        if ((__int128)2 * funds >= goal) return 10000;
+        return uint16_t(flon::muldiv((__int128)2 * funds, 10000, goal));
+    }
+
+    typedef eosio::multi_index<"coverages"_n, plan_coverage_t> idx_t;
+
+    EOSLIB_SERIALIZE(plan_coverage_t, (plan_id)(coverage_bps)(updated_at))
+};
+
+static constexpr uint16_t  YIELD_LOG_WINDOW = 24;                         // 收益日志保留的最近月份数
+static constexpr uint16_t  MAX_DISTRIBUTE_PLANS = 50;                     // distribute 单次最多分配的计划数
+static constexpr const char* CREDIT_MEMO    = "credit";                   // 批量收益预存 memo（yield/credit）
+
+// ----------------------------------------------------
+// 待转发的投资人 / 担保人份额（flush_interval > 0 时按计划累计，flush 按目标池汇总转出）
+// ----------------------------------------------------
+//self: self
+TBL pending_share_t {
+    uint64_t        plan_id;              // PK
+    extended_symbol token;                // 计划 goal 代币
+    amount64        stake;                // 待转 stake 池
+    amount64        guaranty;             // 待转 guaranty 池
+    time_point_sec  since;                // 首笔累计时间
+
+    uint64_t primary_key() const { return plan_id; }
+    uint64_t by_since() const { return since.sec_since_epoch(); }
+    uint128_t by_token() const { return token_key(token); }
+
+    static uint128_t token_key(const extended_symbol& t) {
+        return ((uint128_t)t.get_contract().value << 64) | t.get_symbol().raw();
+    }
+
+    typedef eosio::multi_index<"pendshares"_n, pending_share_t,
+        indexed_by<"bysince"_n, const_mem_fun<pending_share_t, uint64_t, &pending_share_t::by_since>>,
+        indexed_by<"bytoken"_n, const_mem_fun<pending_share_t, uint128_t, &pending_share_t::by_token>>
+    > idx_t;
+
+    EOSLIB_SERIALIZE(pending_share_t, (plan_id)(token)(stake)(guaranty)(since))
+};
+
+// ----------------------------------------------------
+// 批量收益预存额度（一笔转账预存多个计划的收益，distribute 按计划拆分）
+// ----------------------------------------------------
+//self: depositor
+TBL yield_credit_t {
+    extended_asset  balance;              // 未分配的预存收益
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return balance.quantity.symbol.code().raw(); }
+
+    typedef eosio::multi_index<"yieldcredit"_n, yield_credit_t> idx_t;
 
-    EOSLIB_SERIALIZE(global_t, (admin)(yield_split_conf))
+    EOSLIB_SERIALIZE(yield_credit_t, (balance)(updated_at))
 };
-typedef eosio::singleton<"global"_n, global_t> global_singleton;
 
 // ----------------------------------------------------
-// 收益日志表（按月）
+// 收益日志表（按月，只保留最近 YIELD_LOG_WINDOW 个月）
+// 更早的历史见 logyield 事件（action trace），全生命周期累计见 yield_total_t
+// 金额均为计划 goal 符号，只存 amount，读取时用 of(plan.goal_quantity.symbol) 还原
 // ----------------------------------------------------
 //self:plan_id
 TBL yield_log_t {
     uint64_t        period;               // 主键：YYYYMM
-    asset           period_yield;         // 当月总收益
-    asset           guarantor_yield;      // 担保人收益 (≈10%×覆盖率)
-    asset           investor_yield;       // 投资人收益 (≈80%)
-    asset           buyback_yield;        // 回购凭证收益 (剩余)
-    asset           cumulative_yield;     // 累计总收益
+    amount64        period_yield;         // 当月总收益
+    amount64        guarantor_yield;      // 担保人收益 (≈10%×覆盖率)
+    amount64        investor_yield;       // 投资人收益 (≈80%)
+    amount64        buyback_yield;        // 回购凭证收益 (剩余)
+    amount64        cumulative_yield;     // 累计总收益
     time_point_sec  created_at;
     time_point_sec  updated_at;
 
@@ -53,38 +162,163 @@ TBL yield_log_t {
     yield_log_t() {}
     yield_log_t(const uint64_t& p): period(p) {}
 
-    typedef eosio::multi_index<"yieldlogs"_n, yield_log_t> idx_t;
+    typedef eosio::multi_index<"yieldhist"_n, yield_log_t> idx_t;
 
     EOSLIB_SERIALIZE(yield_log_t,(period)(period_yield)(guarantor_yield)(investor_yield)
                     (buyback_yield)(cumulative_yield)(created_at)(updated_at))
 };
+
+// 计划收益全生命周期累计（每计划一行，不随月份增长）
+//self: self
+TBL yield_total_t {
+    uint64_t        plan_id;              // PK
+    amount64        total_yield;          // 累计总收益
+    amount64        investor_yield;       // 累计投资人收益
+    amount64        guarantor_yield;      // 累计担保人收益
+    amount64        buyback_yield;        // 累计回购收益
+    uint64_t        first_period = 0;     // 首个有收益的月份 YYYYMM
+    uint64_t        last_period  = 0;     // 最近有收益的月份 YYYYMM
+    uint32_t        periods      = 0;     // 有收益的月份数
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    typedef eosio::multi_index<"yieldtotals"_n, yield_total_t> idx_t;
+
+    EOSLIB_SERIALIZE(yield_total_t,(plan_id)(total_yield)(investor_yield)(guarantor_yield)(buyback_yield)
+                    (first_period)(last_period)(periods)(updated_at))
+};
+// 计划回购账户（SING 金额为计划 goal 符号，只存 amount；凭证带符号，供 byvoucher 索引）
 //self: self
 TBL plan_buyback_t {
     uint64_t    plan_id;               // PK
 
-    asset       total_buyback;         // 累计 buyback_yield（从收益分配累积）
-    asset       used_buyback;          // 已用于回购的 SING 数量
+    amount64    total_buyback;         // 累计 buyback_yield（从收益分配累积）
+    amount64    used_buyback;          // 已用于回购的 SING 数量
 
     asset       total_voucher;         // 累计回购到的凭证资产
 
     uint16_t    max_slippage = 100;    // 1% = 100 bp
 
     time_point_sec updated_at;
+    time_point_sec next_buyback_at;        // 下次可回购的时间（maximum 表示挂起）
+
+    amount64    chunk_size;            // 分批回购：每次最多使用的 SING（0 表示一次全部）
+    uint32_t    chunk_interval = 0;    // 分批回购：两次回购的最小间隔（秒）
 
     uint64_t primary_key() const { return plan_id; }
 
     // 动态计算剩余 SING
-    asset remaining() const {
-        return asset(
-            total_buyback.amount - used_buyback.amount,
-            total_buyback.symbol
-        );
+    int64_t remaining() const { return total_buyback.amount - used_buyback.amount; }
+    // 有待回购余额的计划按回购时间排序，无余额为 max
+    uint64_t by_next_buyback() const {
+        return remaining() > 0 ? next_buyback_at.sec_since_epoch() : std::numeric_limits<uint64_t>::max();
     }
-    typedef eosio::multi_index<"planbuyback"_n, plan_buyback_t> pl_tbl;
+    // 凭证符号 → 计划（凭证符号按计划唯一）
+    uint64_t by_voucher() const { return total_voucher.symbol.code().raw(); }
+
+    typedef eosio::multi_index<"buybacks"_n, plan_buyback_t,
+        indexed_by<"bynextbuy"_n, const_mem_fun<plan_buyback_t, uint64_t, &plan_buyback_t::by_next_buyback>>,
+        indexed_by<"byvoucher"_n, const_mem_fun<plan_buyback_t, uint64_t, &plan_buyback_t::by_voucher>>
+    > pl_tbl;
+
+    EOSLIB_SERIALIZE(plan_buyback_t,(plan_id)(total_buyback)(used_buyback)(total_voucher)(max_slippage)(updated_at)(next_buyback_at)
+                    (chunk_size)(chunk_interval))
+};
+
+// ----------------------------------------------------
+// 已部署旧版的行格式（与升级前合约的 EOSLIB_SERIALIZE 逐列一致，金额带符号，无二级索引），
+// 仅供 migratelogs / migratebuys / migrateconf 读取后删除
+// ----------------------------------------------------
+// 旧版全局配置（分配比例为按键查找的百分比 map）
+NTBL("global") legacy_global_t {
+#ifdef RWAFI_HUB
+    static constexpr name stake_key    = "stake"_n;
+    static constexpr name guaranty_key = "guaranty"_n;
+#else
+    static constexpr name stake_key    = STAKE_POOL;
+    static constexpr name guaranty_key = GUARANTY_POOL;
+#endif
+
+    name                admin;
+    map<name, uint8_t>  yield_split_conf;
+
+    EOSLIB_SERIALIZE(legacy_global_t, (admin)(yield_split_conf))
+};
+#ifdef RWAFI_HUB
+typedef eosio::singleton<"yieldglobal"_n, legacy_global_t> legacy_global_singleton;
+#else
+typedef eosio::singleton<"global"_n, legacy_global_t> legacy_global_singleton;
+#endif
+
+//self:plan_id
+TBL legacy_yield_log_t {
+    uint64_t        period;
+    asset           period_yield;
+    asset           guarantor_yield;
+    asset           investor_yield;
+    asset           buyback_yield;
+    asset           cumulative_yield;
+    time_point_sec  created_at;
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return period; }
+
+    typedef eosio::multi_index<"yieldlogs"_n, legacy_yield_log_t> idx_t;
+
+    EOSLIB_SERIALIZE(legacy_yield_log_t,(period)(period_yield)(guarantor_yield)(investor_yield)
+                    (buyback_yield)(cumulative_yield)(created_at)(updated_at))
+};
+//self: self
+TBL legacy_buyback_t {
+    uint64_t        plan_id;
+    asset           total_buyback;
+    asset           used_buyback;
+    asset           total_voucher;
+    uint16_t        max_slippage = 100;
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    typedef eosio::multi_index<"planbuyback"_n, legacy_buyback_t> pl_tbl;
 
-    EOSLIB_SERIALIZE(plan_buyback_t,(plan_id)(total_buyback)(used_buyback)(total_voucher)(max_slippage)(updated_at))
+    EOSLIB_SERIALIZE(legacy_buyback_t,(plan_id)(total_buyback)(used_buyback)(total_voucher)(max_slippage)(updated_at))
 };
 
 
 
+// 交易对价格预言机头部（最新累计值与环形游标）
+//self: self
+TBL price_oracle_t {
+    name        pair;                  // PK: flon.swap 交易对
+    uint16_t    cursor = 0;            // 最新槽位
+    uint16_t    filled = 0;            // 已写入槽位数（≤ PRICE_OBS_SLOTS）
+    uint32_t    last_slot_at = 0;      // 最新槽位写入时间
+    uint32_t    last_observed_at = 0;  // 最近一次观测时间
+    uint128_t   last_price = 0;        // 最近一次观测的现价（× PRICE_PRECISION）
+    uint128_t   price_cumulative = 0;  // 截至 last_observed_at 的 Σ price × dt
+    uint64_t    time_cumulative = 0;   // 截至 last_observed_at 的 Σ dt（单个观测的 dt 封顶为观测间隔）
+
+    uint64_t primary_key() const { return pair.value; }
+
+    typedef eosio::multi_index<"priceoracle"_n, price_oracle_t> idx_t;
+
+    EOSLIB_SERIALIZE(price_oracle_t,(pair)(cursor)(filled)(last_slot_at)(last_observed_at)(last_price)(price_cumulative)(time_cumulative))
+};
+
+// 价格观测环形缓冲槽位
+//self: pair
+TBL price_obs_t {
+    uint64_t    slot;                  // PK: 0 .. PRICE_OBS_SLOTS-1
+    uint32_t    observed_at = 0;       // 写入时间
+    uint128_t   price_cumulative = 0;  // 写入时的累计价格
+    uint64_t    time_cumulative = 0;   // 写入时的累计权重时间
+
+    uint64_t primary_key() const { return slot; }
+
+    typedef eosio::multi_index<"priceobs"_n, price_obs_t> idx_t;
+
+    EOSLIB_SERIALIZE(price_obs_t,(slot)(observed_at)(price_cumulative)(time_cumulative))
+};
+
 } // namespace rwafi
\ No newline at end of file
@@ -2,14 +2,16 @@
 #include "yieldrwa.hpp"
 #include <flon/utils.hpp>
 #include <flon/consts.hpp>
+#include <flon/calendar.hpp>
 
 #include <algorithm>
 #include <chrono>
 #include <eosio/transaction.hpp>
 #include <eosio/crypto.hpp>
 #include <invest.rwa/investrwadb.hpp>
-#include <guaranty.rwa/guarantyrwadb.hpp>
+#include <guaranty.rwa/guarantyrwa.hpp>
 #include <flon.swap/flon.swap.db.hpp>
+#include <vault.rwa/vaultrwa.hpp>
 
 using namespace eosio;
 using namespace rwafi;
@@ -18,35 +20,18 @@ using namespace flon;
 static constexpr eosio::name active_perm{"active"_n};
 
 static uint64_t current_period_yyyymm() {
-    time_t t = (time_t) current_time_point().sec_since_epoch();
-    tm* g = gmtime(&t);
-    return (uint64_t)((g->tm_year + 1900) * 100 + (g->tm_mon + 1));
+    return calendar::to_period(current_time_point().sec_since_epoch());
 }
 
-double get_amm_price(const asset& in_pool, const asset& out_pool)
-{
-    int64_t in_amount = in_pool.amount;
-    int64_t out_amount = out_pool.amount;
-
-    int64_t in_boost = power10(in_pool.symbol.precision());
-    int64_t out_boost = power10(out_pool.symbol.precision());
-
-    return (double)out_amount * in_boost / (in_amount * out_boost);
-}
-
-int64_t calc_min_received(double min_price, const asset& input, const symbol& output_symbol)
-{
-    int64_t in_boost  = power10(input.symbol.precision());
-    int64_t out_boost = power10(output_symbol.precision());
-
-    double out = (double)input.amount * min_price * out_boost / in_boost;
-    return (int64_t)out;
-}
+// 交易对按输入方向整理后的实时储备
+struct swap_pools_t {
+    extended_asset  in_pool;
+    extended_asset  out_pool;
+    int64_t         fee_bp;         // 取最高手续费率（bp）
+};
 
-string build_swap_memo(const extended_asset& input,const name& pair_name,double slippage,const name& swap_contract)
+swap_pools_t load_swap_pools(const extended_symbol& input,const name& pair_name,const name& swap_contract)
 {
-    CHECKC(slippage >= 0 && slippage <= 1, err::PARAM_ERROR, "invalid slippage");
-
     flon::market_t::idx_t markets(swap_contract, swap_contract.value);
     auto itr = markets.find(pair_name.value);
     CHECKC(itr != markets.end(), err::RECORD_NOT_FOUND, "swap market not found");
@@ -55,28 +40,71 @@ string build_swap_memo(const extended_asset& input,const name& pair_name,double
     extended_asset right = itr->right_pool_quant;
 
     bool is_left_input =
-        (input.contract == left.contract &&
-         input.quantity.symbol == left.quantity.symbol);
+        (input.get_contract() == left.contract &&
+         input.get_symbol() == left.quantity.symbol);
 
     bool is_right_input =
-        (input.contract == right.contract &&
-         input.quantity.symbol == right.quantity.symbol);
+        (input.get_contract() == right.contract &&
+         input.get_symbol() == right.quantity.symbol);
 
     CHECKC(is_left_input || is_right_input, err::SYMBOL_MISMATCH, "input not in pair");
 
-    extended_asset in_pool  = is_left_input ? left  : right;
-    extended_asset out_pool = is_left_input ? right : left;
+    swap_pools_t pools;
+    pools.in_pool  = is_left_input ? left  : right;
+    pools.out_pool = is_left_input ? right : left;
+    pools.fee_bp   = std::min<int64_t>(10000,
+        std::max<int64_t>({ itr->sys_fee_ratio, itr->buy_fee_ratio, itr->sell_fee_ratio }));
+    CHECKC(pools.in_pool.quantity.amount > 0 && pools.out_pool.quantity.amount > 0,
+           err::INCORRECT_AMOUNT, "empty swap pool");
+    return pools;
+}
+
+// 交易对是否包含输入资产且双边有储备（crank 先行检查，避免 load_swap_pools 报错中断整批）
+bool swap_has_liquidity(const extended_symbol& input,const name& pair_name,const name& swap_contract)
+{
+    flon::market_t::idx_t markets(swap_contract, swap_contract.value);
+    auto itr = markets.find(pair_name.value);
+    if (itr == markets.end()) return false;
+
+    const extended_asset& left  = itr->left_pool_quant;
+    const extended_asset& right = itr->right_pool_quant;
+    const bool in_pair = left.get_extended_symbol() == input || right.get_extended_symbol() == input;
+    return in_pair && left.quantity.amount > 0 && right.quantity.amount > 0;
+}
+
+// 现价：每单位输出资产折合的输入资产（最小单位比值 × PRICE_PRECISION）
+uint128_t spot_price(const swap_pools_t& pools)
+{
+    return (uint128_t)pools.in_pool.quantity.amount * PRICE_PRECISION / (uint64_t)pools.out_pool.quantity.amount;
+}
 
-    double price = get_amm_price(in_pool.quantity, out_pool.quantity);
-    double min_price = price * (1.0 - slippage);
+// 按储备计算本次兑换的最少得到数量（整数运算），兑不出最小单位时为 0：
+// out = in' × R_out / (R_in + in')，in' 为扣除手续费后的输入，再扣除 max_slippage
+int64_t min_swap_out(const asset& input,const swap_pools_t& pools,const uint16_t& max_slippage)
+{
+    CHECKC(max_slippage <= 10000, err::PARAM_ERROR, "invalid slippage");
 
-    int64_t min_amt = calc_min_received(min_price, input.quantity, out_pool.quantity.symbol);
+    const int64_t in_net  = muldiv(input.amount, 10000 - pools.fee_bp, 10000);
+    const int64_t out     = muldiv(in_net, pools.out_pool.quantity.amount, (__int128)pools.in_pool.quantity.amount + in_net);
+    return muldiv(out, 10000 - max_slippage, 10000);
+}
 
-    return string("swap:") + asset(min_amt, out_pool.quantity.symbol).to_string()
+string build_swap_memo(const int64_t& min_amt,const swap_pools_t& pools,const name& pair_name)
+{
+    return string("swap:") + asset(min_amt, pools.out_pool.quantity.symbol).to_string()
            + ":" + pair_name.to_string();
 }
 
 name yieldrwa::find_pair_by_symbols(const symbol& in_sym,const symbol& out_sym,const name& swap_contract)
+{
+    const name pair = _lookup_pair(in_sym, out_sym, swap_contract);
+    CHECKC(pair.value != 0, err::RECORD_NOT_FOUND,
+           "swap pair not found for symbols: "
+           + in_sym.code().to_string() + " <-> " + out_sym.code().to_string());
+    return pair;
+}
+
+name yieldrwa::_lookup_pair(const symbol& in_sym,const symbol& out_sym,const name& swap_contract)
 {
     flon::market_t::idx_t markets(swap_contract, swap_contract.value);
 
@@ -90,32 +118,86 @@ name yieldrwa::find_pair_by_symbols(const symbol& in_sym,const symbol& out_sym,c
             return itr->tpcode;
         }
     }
-
-    CHECKC(false, err::RECORD_NOT_FOUND,
-           "swap pair not found for symbols: "
-           + in_sym.code().to_string() + " <-> " + out_sym.code().to_string());
     return name{0};
 }
 
 void yieldrwa::init(const name& admin) {
     require_auth(get_self());
     CHECKC(is_account(admin), err::ACCOUNT_INVALID, "invalid admin account");
-    _gstate.admin = admin;
-    _global.set(_gstate, get_self());
+    _gstate.mut().admin = admin;
 }
 
-void yieldrwa::updateconfig(const name& key, const uint8_t& value) {
-    require_auth(_gstate.admin);
-    CHECKC(_gstate.yield_split_conf.count(key), err::PARAM_ERROR, "invalid yield key");
-    _gstate.yield_split_conf[key] = value;
-    _global.set(_gstate, get_self());
+void yieldrwa::setsplit(const uint64_t& plan_id, const uint16_t& stake_bps, const uint16_t& guaranty_bps,
+                        const uint16_t& swap_bps) {
+    require_auth(_gstate->admin);
+
+    yield_split_t split;
+    split.stake_bps    = stake_bps;
+    split.guaranty_bps = guaranty_bps;
+    split.swap_bps     = swap_bps;
+    CHECKC(split.valid(), err::PARAM_ERROR, "yield split must sum to " + std::to_string(SPLIT_BPS_BASE) + " bp");
+
+    if (plan_id == 0) {
+        _gstate.mut().split = split;
+        return;
+    }
+
+    fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
+    CHECKC(plans.find(plan_id) != plans.end(), err::RECORD_NOT_FOUND, "plan not found");
+
+    plan_split_t::idx_t splits(get_self(), get_self().value);
+    auto it = splits.find(plan_id);
+    if (it == splits.end()) {
+        splits.emplace(get_self(), [&](auto& s){
+            s.plan_id = plan_id;
+            s.split   = split;
+        });
+    } else {
+        splits.modify(it, same_payer, [&](auto& s){ s.split = split; });
+    }
 }
 
-void yieldrwa::on_transfer(const name& from, const name& to,const asset& quantity, const string& memo)
+void yieldrwa::delsplit(const uint64_t& plan_id) {
+    require_auth(_gstate->admin);
+
+    plan_split_t::idx_t splits(get_self(), get_self().value);
+    auto it = splits.find(plan_id);
+    CHECKC(it != splits.end(), err::RECORD_NOT_FOUND, "plan has no split override");
+    splits.erase(it);
+}
+
+void yieldrwa::on_transfer(const name& from, const name& to,const asset& quantity, const string& raw_memo)
 {
-    if (from == get_self() || to != get_self()) return;
+    string memo;
+    if (!vault_deposit(get_self(), YIELD_MODULE, from, to, raw_memo, memo)) return;
     CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "quantity must be positive");
 
+    if (memo == KEEPER_MEMO) {
+        CHECKC(quantity.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper budget must be SING");
+        _gstate.mut().keeper.budget += quantity;
+        return;
+    }
+
+    if (memo == CREDIT_MEMO) {
+        const extended_asset deposit(quantity, get_first_receiver());
+        yield_credit_t::idx_t credits(get_self(), from.value);
+        auto it = credits.find(quantity.symbol.code().raw());
+        if (it == credits.end()) {
+            credits.emplace(get_self(), [&](auto& c){
+                c.balance    = deposit;
+                c.updated_at = time_point_sec(current_time_point());
+            });
+        } else {
+            CHECKC(it->balance.get_extended_symbol() == deposit.get_extended_symbol(),
+                   err::SYMBOL_MISMATCH, "token mismatch on yield credit");
+            credits.modify(it, same_payer, [&](auto& c){
+                c.balance   += deposit;
+                c.updated_at = time_point_sec(current_time_point());
+            });
+        }
+        return;
+    }
+
     auto parts = split(memo, ":");
     CHECKC(parts.size() == 2 && parts[0] == "plan",
            err::INVALID_FORMAT, "memo must be plan:<id>");
@@ -147,36 +229,352 @@ void yieldrwa::buyback(const name& submitter,const uint64_t& plan_id)
     CHECKC(it != tbl.end(), err::RECORD_NOT_FOUND,
            "planbuyback record missing");
 
-    asset remaining = it->remaining();
-    CHECKC(remaining.amount > 0, err::INCORRECT_AMOUNT, "no buyback balance");
+    CHECKC(it->remaining() > 0, err::INCORRECT_AMOUNT, "no buyback balance");
+    CHECKC(it->next_buyback_at == time_point_sec::maximum() ||
+           time_point_sec(current_time_point()) >= it->next_buyback_at,
+           err::NOT_EXPIRED, "next buyback chunk not due yet");
 
-    symbol sing = p->goal_quantity.symbol;
-    symbol voucher = p->receipt_symbol;
-    name   bank = p->goal_asset_contract;
+    name pair = find_pair_by_symbols(p->goal_quantity.symbol, p->receipt_symbol, SWAP_POOL);
+    CHECKC(_do_buyback(*p, pair), err::STATUS_ERROR, "spot price deviates from twap or twap not ready");
+}
 
-    name pair = find_pair_by_symbols(sing, voucher, SWAP_POOL);
+void yieldrwa::observe(const uint64_t& plan_id)
+{
+    // 开放调用时可在同一交易内先拉盘再观测，把操纵价写入 TWAP
+    require_auth(_gstate->admin);
 
-    double slip_rate = (double)it->max_slippage / 10000.0;
+    fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
+    auto p = plans.find(plan_id);
+    CHECKC(p != plans.end(), err::RECORD_NOT_FOUND, "plan not found");
 
-    string memo = build_swap_memo(
-        extended_asset(remaining, bank),
-        pair,
-        slip_rate,
-        SWAP_POOL
-    );
+    const name pair = find_pair_by_symbols(p->goal_quantity.symbol, p->receipt_symbol, SWAP_POOL);
+    const swap_pools_t pools = load_swap_pools(extended_symbol(p->goal_quantity.symbol, p->goal_asset_contract), pair, SWAP_POOL);
+    _observe_price(pair, spot_price(pools));
+}
 
-    TRANSFER(bank, SWAP_POOL, remaining, memo);
+void yieldrwa::settwap(const uint32_t& twap_window, const uint16_t& max_twap_dev)
+{
+    require_auth(_gstate->admin);
+    CHECKC(twap_window >= PRICE_OBS_SLOTS, err::PARAM_ERROR, "twap window too short");
+    CHECKC(max_twap_dev > 0 && max_twap_dev <= 5000, err::PARAM_ERROR, "invalid twap deviation");
+
+    _gstate.mut().twap_window  = twap_window;
+    _gstate.mut().max_twap_dev = max_twap_dev;
+}
+
+bool yieldrwa::_do_buyback(const fundplan_t& plan, const name& pair, const bool& crank)
+{
+    plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
+    auto it = tbl.find(plan.id);
+    CHECKC(it != tbl.end(), err::RECORD_NOT_FOUND, "planbuyback record missing");
+
+    // 挂起至下次收益入账（分配时把 next_buyback_at 拉回当前时间）
+    auto park = [&]() {
+        tbl.modify(it, same_payer, [&](auto& row){
+            row.next_buyback_at = time_point_sec::maximum();
+        });
+        return false;
+    };
+
+    const name bank = plan.goal_asset_contract;
+    const extended_symbol input(plan.goal_quantity.symbol, bank);
+    if (crank && !swap_has_liquidity(input, pair, SWAP_POOL)) return park();
+    const swap_pools_t pools = load_swap_pools(input, pair, SWAP_POOL);
+
+    // 回购路径只读 TWAP、不记录观测：crank 无需授权，同一交易内拉盘后的现价不能写入历史
+    const uint128_t spot = spot_price(pools);
+    const uint128_t twap = _twap(pair);
+
+    // 分批模式下每次最多回购 chunk_size，再按现价偏离 TWAP 的程度缩减
+    asset chunk(it->remaining(), plan.goal_quantity.symbol);
+    if (it->chunk_size.amount > 0 && it->chunk_size.amount < chunk.amount)
+        chunk.amount = it->chunk_size.amount;
+    chunk.amount = _twap_guard(chunk.amount, spot, twap);
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    if (chunk.amount <= 0) {
+        // 价格异常或历史不足：顺延一个观测间隔后重试
+        tbl.modify(it, same_payer, [&](auto& row){
+            row.next_buyback_at = now + _obs_gap();
+        });
+        return false;
+    }
+
+    const int64_t min_out = min_swap_out(chunk, pools, it->max_slippage);
+    if (min_out <= 0) {
+        CHECKC(crank, err::INCORRECT_AMOUNT, "buyback chunk too small for pool");
+        return park();
+    }
+
+    POOL_PAY(bank, SWAP_POOL, chunk, build_swap_memo(min_out, pools, pair));
 
     tbl.modify(it, same_payer, [&](auto& row){
-        row.used_buyback += remaining;
-        row.updated_at = time_point_sec(current_time_point());
+        row.used_buyback   += chunk;
+        row.updated_at      = now;
+        row.next_buyback_at = now + row.chunk_interval;
+    });
+    return true;
+}
+
+uint32_t yieldrwa::_obs_gap() const
+{
+    return std::max<uint32_t>(1, _gstate->twap_window / PRICE_OBS_SLOTS);
+}
+
+// 记录现价观测：头部累计值 O(1) 推进，距上个槽位满一个间隔才写入下一个环形槽位
+void yieldrwa::_observe_price(const name& pair, const uint128_t& spot)
+{
+    const uint32_t now = current_time_point().sec_since_epoch();
+
+    price_oracle_t::idx_t oracles(get_self(), get_self().value);
+    auto it = oracles.find(pair.value);
+    price_obs_t::idx_t slots(get_self(), pair.value);
+
+    auto write_slot = [&](const uint16_t& slot, const uint128_t& cumulative, const uint64_t& elapsed) {
+        auto s = slots.find(slot);
+        if (s == slots.end()) {
+            slots.emplace(get_self(), [&](auto& o){
+                o.slot             = slot;
+                o.observed_at      = now;
+                o.price_cumulative = cumulative;
+                o.time_cumulative  = elapsed;
+            });
+        } else {
+            slots.modify(s, same_payer, [&](auto& o){
+                o.observed_at      = now;
+                o.price_cumulative = cumulative;
+                o.time_cumulative  = elapsed;
+            });
+        }
+    };
+
+    if (it == oracles.end()) {
+        oracles.emplace(get_self(), [&](auto& o){
+            o.pair             = pair;
+            o.cursor           = 0;
+            o.filled           = 1;
+            o.last_slot_at     = now;
+            o.last_observed_at = now;
+            o.last_price       = spot;
+            o.price_cumulative = 0;
+            o.time_cumulative  = 0;
+        });
+        write_slot(0, 0, 0);
+        return;
+    }
+
+    if (now == it->last_observed_at) return;   // 同一区块只取首个观测，防止块内操纵
+
+    const bool append = now - it->last_slot_at >= _obs_gap();
+    uint16_t cursor   = it->cursor;
+    uint128_t cumulative = 0;
+    uint64_t elapsed     = 0;
+
+    oracles.modify(it, same_payer, [&](auto& o){
+        // 长时间无人观测时，单个（可能被操纵的）价格最多计一个观测间隔的权重
+        const uint32_t dt = std::min<uint32_t>(now - o.last_observed_at, _obs_gap());
+        // Σ price × dt 按 2^128 取模累加，差值仍正确
+        o.price_cumulative += o.last_price * (uint128_t)dt;
+        o.time_cumulative  += dt;
+        o.last_observed_at  = now;
+        o.last_price        = spot;
+        if (append) {
+            o.cursor        = (o.cursor + 1) % PRICE_OBS_SLOTS;
+            o.filled        = std::min<uint16_t>(o.filled + 1, PRICE_OBS_SLOTS);
+            o.last_slot_at  = now;
+        }
+        cursor     = o.cursor;
+        cumulative = o.price_cumulative;
+        elapsed    = o.time_cumulative;
     });
+    if (append) write_slot(cursor, cumulative, elapsed);
+}
+
+// 最旧槽位至当前的时间加权均价（按封顶后的权重时间）：最近一次观测的价格计到当前但不写回；历史不足返回 0
+uint128_t yieldrwa::_twap(const name& pair) const
+{
+    price_oracle_t::idx_t oracles(get_self(), get_self().value);
+    auto o = oracles.find(pair.value);
+    if (o == oracles.end()) return 0;
+
+    const uint16_t oldest = o->filled < PRICE_OBS_SLOTS ? 0 : (o->cursor + 1) % PRICE_OBS_SLOTS;
+    price_obs_t::idx_t slots(get_self(), pair.value);
+    auto s = slots.find(oldest);
+    if (s == slots.end()) return 0;
+
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const uint32_t dt  = std::min<uint32_t>(now - o->last_observed_at, _obs_gap());
+    const uint128_t cumulative = o->price_cumulative + o->last_price * (uint128_t)dt;
+    const uint64_t  elapsed    = o->time_cumulative + dt;
+    if (elapsed <= s->time_cumulative) return 0;
+
+    return (cumulative - s->price_cumulative) / (elapsed - s->time_cumulative);
+}
+
+// 仅防范不利方向（现价高于 TWAP，即回购变贵）：
+// 偏离 ≤ max_dev 全额；max_dev ~ 2×max_dev 线性缩减；更大或无 TWAP 则拒绝
+int64_t yieldrwa::_twap_guard(const int64_t& amount, const uint128_t& spot, const uint128_t& twap) const
+{
+    if (twap == 0) return 0;
+    if (spot <= twap) return amount;
+
+    const uint128_t max_dev = _gstate->max_twap_dev;
+    const uint128_t dev     = (spot - twap) * 10000 / twap;
+    if (dev <= max_dev)      return amount;
+    if (dev >= 2 * max_dev)  return 0;
+
+    return muldiv(amount, 2 * max_dev - dev, max_dev);
+}
+
+void yieldrwa::crank(const name& keeper, const uint16_t& max_work)
+{
+    require_auth(keeper);
+    CHECKC(max_work > 0 && max_work <= MAX_CRANK_WORK, err::PARAM_ERROR,
+           "max_work must be in [1, " + std::to_string(MAX_CRANK_WORK) + "]");
+
+    const uint64_t now = current_time_point().sec_since_epoch();
+    uint16_t steps = 0, done = 0;   // done 仅统计实际成交的回购，挂起 / 顺延不计报酬
+
+    while (steps < max_work) {
+        plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
+        auto pending = tbl.get_index<"bynextbuy"_n>();
+        auto it = pending.begin();
+        if (it == pending.end() || it->by_next_buyback() > now) break;
+
+        const uint64_t plan_id = it->plan_id;
+        fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
+        auto p = plans.find(plan_id);
+
+        const name pair = (p != plans.end() && p->status == PlanStatus::SUCCESS)
+                        ? _lookup_pair(p->goal_quantity.symbol, p->receipt_symbol, SWAP_POOL)
+                        : name{0};
+
+        if (pair.value == 0) {
+            // 暂不可回购：挂起，避免阻塞后续计划
+            tbl.modify(tbl.find(plan_id), same_payer, [&](auto& row){
+                row.next_buyback_at = time_point_sec::maximum();
+            });
+        } else if (_do_buyback(*p, pair, true)) {
+            ++done;
+        }
+        ++steps;
+    }
+
+    CHECKC(steps > 0, err::NOT_EXPIRED, "no pending buyback to crank");
+    _pay_keeper(keeper, done);
+}
+
+void yieldrwa::setkeeper(const asset& fee_per_work)
+{
+    require_auth(_gstate->admin);
+    CHECKC(fee_per_work.symbol == SING_SYM, err::SYMBOL_MISMATCH, "keeper fee must be SING");
+    CHECKC(fee_per_work.amount >= 0, err::NOT_POSITIVE, "keeper fee must not be negative");
+
+    _gstate.mut().keeper.fee_per_work = fee_per_work;
+}
+
+// 旧版收益日志逐行搬入紧凑表：先写新行再删旧行，行数受 max_rows 限制可分多次执行
+// 每行同时计入计划累计；搬完后超出窗口的月份只保留在累计中
+void yieldrwa::migratelogs(const uint64_t& plan_id, const uint16_t& max_rows)
+{
+    require_auth(_gstate->admin);
+    CHECKC(max_rows > 0, err::PARAM_ERROR, "max_rows must be positive");
+
+    legacy_yield_log_t::idx_t legacy(get_self(), plan_id);
+    yield_log_t::idx_t logs(get_self(), plan_id);
+
+    uint16_t done = 0;
+    for (auto it = legacy.begin(); it != legacy.end() && done < max_rows; ++done) {
+        CHECKC(logs.find(it->period) == logs.end(), err::STATUS_ERROR,
+               "period already migrated: " + std::to_string(it->period));
+        logs.emplace(get_self(), [&](auto& y){
+            y.period            = it->period;
+            y.period_yield      = it->period_yield;
+            y.guarantor_yield   = it->guarantor_yield;
+            y.investor_yield    = it->investor_yield;
+            y.buyback_yield     = it->buyback_yield;
+            y.cumulative_yield  = it->cumulative_yield;
+            y.created_at        = it->created_at;
+            y.updated_at        = it->updated_at;
+        });
+        _add_yield_totals(plan_id, it->period, true,
+                          it->period_yield, it->investor_yield, it->guarantor_yield, it->buyback_yield);
+        it = legacy.erase(it);
+    }
+    CHECKC(done > 0, err::RECORD_NOT_FOUND, "no legacy yield logs to migrate");
+    _trim_logs(logs, logs.rbegin()->period);
+}
+
+void yieldrwa::migratebuys(const uint16_t& max_rows)
+{
+    require_auth(_gstate->admin);
+    CHECKC(max_rows > 0, err::PARAM_ERROR, "max_rows must be positive");
+
+    legacy_buyback_t::pl_tbl legacy(get_self(), get_self().value);
+    plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
+
+    uint16_t done = 0;
+    for (auto it = legacy.begin(); it != legacy.end() && done < max_rows; ++done) {
+        CHECKC(tbl.find(it->plan_id) == tbl.end(), err::STATUS_ERROR,
+               "plan already migrated: " + std::to_string(it->plan_id));
+        tbl.emplace(get_self(), [&](auto& row){
+            row.plan_id         = it->plan_id;
+            row.total_buyback   = it->total_buyback;
+            row.used_buyback    = it->used_buyback;
+            row.total_voucher   = it->total_voucher;
+            row.max_slippage    = it->max_slippage;
+            row.updated_at      = it->updated_at;   // 旧版没有分批回购：不分批、next_buyback_at 为 0，下次 crank 即可执行
+        });
+        it = legacy.erase(it);
+    }
+    CHECKC(done > 0, err::RECORD_NOT_FOUND, "no legacy buyback rows to migrate");
+}
+
+// 旧版 global 中 admin 仍在旧表里，新表为空时无法校验 admin，因此要求合约自身授权
+// 旧版回购份额为剩余部分（swap 键只做存在性检查），转换后 swap_bps 同样取剩余；
+// keeper 奖励与 TWAP 参数旧版没有，取新版默认值
+void yieldrwa::migrateconf()
+{
+    require_auth(get_self());
+
+    legacy_global_singleton legacy(get_self(), get_self().value);
+    CHECKC(legacy.exists(), err::RECORD_NOT_FOUND, "no legacy config to migrate");
+    const legacy_global_t old = legacy.get();
+
+    const auto& conf = old.yield_split_conf;
+    const auto stake = conf.find(legacy_global_t::stake_key);
+    const auto guar  = conf.find(legacy_global_t::guaranty_key);
+    CHECKC(stake != conf.end() && guar != conf.end(), err::PARAM_ERROR, "legacy yield config missing keys");
+    CHECKC(stake->second + guar->second <= 100, err::PARAM_ERROR, "legacy yield split exceeds 100%");
+
+    auto& g = _gstate.mut();
+    g.admin               = old.admin;
+    g.split.stake_bps     = stake->second * 100;
+    g.split.guaranty_bps  = guar->second * 100;
+    g.split.swap_bps      = SPLIT_BPS_BASE - g.split.stake_bps - g.split.guaranty_bps;
+
+    legacy.remove();
+}
+
+void yieldrwa::migratebal(const name& bank, const symbol& sym)
+{
+    require_auth(_gstate->admin);
+    const asset balance = token::get_balance(bank, get_self(), sym.code());
+    CHECKC(balance.amount > 0, err::NOT_POSITIVE, "no balance to migrate");
+    POOL_IMPORT(bank, YIELD_MODULE, balance);
+}
+
+void yieldrwa::_pay_keeper(const name& keeper, const uint32_t& done)
+{
+    const asset reward = _gstate.mut().keeper.charge(done);
+    if (reward.amount > 0)
+        POOL_PAY(SING_BANK, keeper, reward, "crank reward: " + std::to_string(done));
 }
 
 void yieldrwa::setslippage(const name& submitter,const uint64_t& plan_id,const uint16_t& max_slippage)
 {
     require_auth(submitter);
-    CHECKC(submitter == _gstate.admin, err::NO_AUTH,
+    CHECKC(submitter == _gstate->admin, err::NO_AUTH,
            "only admin can update slippage");
 
     CHECKC(max_slippage <= 2000, err::PARAM_ERROR,
@@ -194,79 +592,327 @@ void yieldrwa::setslippage(const name& submitter,const uint64_t& plan_id,const u
     });
 }
 
-double yieldrwa::_get_coverage_ratio(const uint64_t& plan_id)
+void yieldrwa::setchunk(const name& submitter,const uint64_t& plan_id,const asset& chunk_size,const uint32_t& chunk_interval)
 {
-    guaranty_stats_t::idx_t stats(GUARANTY_POOL, GUARANTY_POOL.value);
-    auto gs = stats.find(plan_id);
-    if (gs == stats.end()) return 0.0;
+    require_auth(submitter);
+    CHECKC(submitter == _gstate->admin, err::NO_AUTH,
+           "only admin can update buyback chunk");
+    CHECKC(chunk_size.amount >= 0, err::NOT_POSITIVE, "chunk size must not be negative");
 
     fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
     auto p = plans.find(plan_id);
-    if (p == plans.end()) return 0.0;
+    CHECKC(p != plans.end(), err::RECORD_NOT_FOUND, "plan not found");
+    CHECKC(chunk_size.symbol == p->goal_quantity.symbol, err::SYMBOL_MISMATCH, "chunk symbol mismatch");
 
-    double required_half = (double)p->goal_quantity.amount / 2.0;
-    if (required_half <= 0) return 0.0;
+    plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
+    auto it = tbl.find(plan_id);
+    CHECKC(it != tbl.end(), err::RECORD_NOT_FOUND, "planbuyback not found");
 
-    double cover = (double)gs->total_guarantee_funds.amount / required_half;
-    return std::max(0.0, std::min(1.0, cover));
+    tbl.modify(it, submitter, [&](auto& row){
+        row.chunk_size     = chunk_size;
+        row.chunk_interval = chunk_interval;
+        row.updated_at     = time_point_sec(current_time_point());
+    });
 }
 
-void yieldrwa::_perform_distribution(const name& bank,const asset& total,const uint64_t& plan_id)
+// 回购兑回的凭证：只接受 flon.swap 转入，按凭证符号记入对应计划
+void yieldrwa::on_voucher(const name& from, const name& to, const asset& quantity, const string&)
+{
+    if (from == VAULT_POOL || to != VAULT_POOL) return;
+    CHECKC(from == SWAP_POOL, err::ACCOUNT_INVALID, "vouchers only accepted from swap");
+
+    plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
+    auto by_voucher = tbl.get_index<"byvoucher"_n>();
+    auto it = by_voucher.find(quantity.symbol.code().raw());
+    CHECKC(it != by_voucher.end() && it->total_voucher.symbol == quantity.symbol,
+           err::RECORD_NOT_FOUND, "no buyback plan for voucher " + quantity.symbol.code().to_string());
+
+    by_voucher.modify(it, same_payer, [&](auto& row){
+        row.total_voucher += quantity;
+    });
+}
+
+uint16_t yieldrwa::_get_coverage_bps(const uint64_t& plan_id) const
+{
+    plan_coverage_t::idx_t covers(get_self(), get_self().value);
+    auto it = covers.find(plan_id);
+    return it != covers.end() ? it->coverage_bps : 0;
+}
+
+void yieldrwa::setcoverage(const uint64_t& plan_id, const uint16_t& coverage_bps)
+{
+    require_auth(GUARANTY_POOL);
+    _set_coverage(plan_id, coverage_bps);
+}
+
+void yieldrwa::_set_coverage(const uint64_t& plan_id, const uint16_t& coverage_bps)
+{
+    CHECKC(coverage_bps <= SPLIT_BPS_BASE, err::PARAM_ERROR, "coverage exceeds " + std::to_string(SPLIT_BPS_BASE) + " bps");
+
+    const time_point_sec now = time_point_sec(current_time_point());
+    plan_coverage_t::idx_t covers(get_self(), get_self().value);
+    auto it = covers.find(plan_id);
+    if (it == covers.end()) {
+        covers.emplace(get_self(), [&](auto& c) {
+            c.plan_id      = plan_id;
+            c.coverage_bps = coverage_bps;
+            c.updated_at   = now;
+        });
+    } else {
+        covers.modify(it, same_payer, [&](auto& c) {
+            c.coverage_bps = coverage_bps;
+            c.updated_at   = now;
+        });
+    }
+}
+
+yield_split_t yieldrwa::_get_split(const uint64_t& plan_id) const
+{
+    plan_split_t::idx_t splits(get_self(), get_self().value);
+    auto it = splits.find(plan_id);
+    return it != splits.end() ? it->split : _gstate->split;
+}
+
+yieldrwa::yield_parts_t yieldrwa::_split_yield(const fundplan_t& plan, const asset& total)
 {
     CHECKC(total.amount > 0,    err::NOT_POSITIVE, "zero total");
+    CHECKC(plan.status == "success"_n,                                  err::INVALID_FORMAT,"plan not in yield stage");
+    CHECKC(time_point_sec(current_time_point()) < plan.return_end_time, err::EXPIRED,"plan already ended, no further yield accepted");
+    CHECKC(total.symbol == plan.goal_quantity.symbol,                   err::SYMBOL_MISMATCH, "symbol mismatch");
+
+    const yield_split_t split = _get_split(plan.id);
+
+    // 担保份额按覆盖率折算：total × guaranty_bps × coverage_bps / 10000²
+    const uint16_t coverage_bps = _get_coverage_bps(plan.id);
+
+    yield_parts_t parts;
+    parts.stake = asset(muldiv(total.amount, split.stake_bps, SPLIT_BPS_BASE), total.symbol);
+    parts.guar  = asset(muldiv(total.amount, (__int128)split.guaranty_bps * coverage_bps,
+                               (__int128)SPLIT_BPS_BASE * SPLIT_BPS_BASE), total.symbol);
+    parts.swap  = asset(total.amount - parts.stake.amount - parts.guar.amount, total.symbol);
+    return parts;
+}
 
+void yieldrwa::_perform_distribution(const name& bank,const asset& total,const uint64_t& plan_id)
+{
     fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
     auto p = plans.find(plan_id);
     CHECKC(p != plans.end(),                                            err::RECORD_NOT_FOUND, "plan not found");
-    CHECKC(p->status == "success"_n,                                    err::INVALID_FORMAT,"plan not in yield stage");
-    CHECKC(time_point_sec(current_time_point()) < p->return_end_time,   err::EXPIRED,"plan already ended, no further yield accepted");
-    CHECKC(total.symbol == p->goal_quantity.symbol,                     err::SYMBOL_MISMATCH, "symbol mismatch");
 
-    auto& cfg = _gstate.yield_split_conf;
-    CHECKC(cfg.count(STAKE_POOL) &&cfg.count(GUARANTY_POOL) &&cfg.count(SWAP_POOL),err::PARAM_ERROR, "yield config missing keys");
+    const yield_parts_t parts = _split_yield(*p, total);
+    vector<plan_alloc_t> to_stake, to_guar;
+    if (parts.stake.amount > 0) to_stake.push_back({plan_id, parts.stake});
+    if (parts.guar.amount > 0)  to_guar.push_back({plan_id, parts.guar});
+
+    _forward_shares(bank, to_stake, to_guar);
+    _book_yield(*p, total, parts);
+}
+
+void yieldrwa::distribute(const name& depositor, const vector<plan_alloc_t>& allocs)
+{
+    require_auth(depositor);
+    CHECKC(!allocs.empty(), err::PARAM_ERROR, "empty allocations");
+    CHECKC(allocs.size() <= MAX_DISTRIBUTE_PLANS, err::PARAM_ERROR,
+           "too many plans, max " + std::to_string(MAX_DISTRIBUTE_PLANS));
+
+    const symbol sym = allocs.front().quantity.symbol;
+    yield_credit_t::idx_t credits(get_self(), depositor.value);
+    auto credit = credits.find(sym.code().raw());
+    CHECKC(credit != credits.end() && credit->balance.quantity.symbol == sym,
+           err::RECORD_NOT_FOUND, "no yield credit in " + sym.code().to_string());
+    const name bank = credit->balance.contract;
+
+    fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
+    vector<plan_alloc_t> to_stake, to_guar;
+    asset total(0, sym);
+    for (const auto& a : allocs) {
+        CHECKC(a.quantity.symbol == sym, err::SYMBOL_MISMATCH, "all allocations must share one symbol");
+        auto p = plans.find(a.plan_id);
+        CHECKC(p != plans.end(), err::RECORD_NOT_FOUND, "plan not found: " + std::to_string(a.plan_id));
+        CHECKC(p->goal_asset_contract == bank, err::SYMBOL_MISMATCH, "token contract mismatch");
+
+        const yield_parts_t parts = _split_yield(*p, a.quantity);
+        if (parts.stake.amount > 0) to_stake.push_back({a.plan_id, parts.stake});
+        if (parts.guar.amount > 0)  to_guar.push_back({a.plan_id, parts.guar});
+        _book_yield(*p, a.quantity, parts);
+        total += a.quantity;
+    }
+
+    CHECKC(total <= credit->balance.quantity, err::QUANTITY_INSUFFICIENT, "insufficient yield credit");
+    if (total == credit->balance.quantity) {
+        credits.erase(credit);
+    } else {
+        credits.modify(credit, same_payer, [&](auto& c){
+            c.balance.quantity -= total;
+            c.updated_at        = time_point_sec(current_time_point());
+        });
+    }
+
+    _forward_shares(bank, to_stake, to_guar);
+}
+
+void yieldrwa::flush(const uint16_t& max_plans)
+{
+    CHECKC(max_plans > 0 && max_plans <= MAX_DISTRIBUTE_PLANS, err::PARAM_ERROR,
+           "max_plans must be in [1, " + std::to_string(MAX_DISTRIBUTE_PLANS) + "]");
+    CHECKC(_flush(max_plans) > 0, err::RECORD_NOT_FOUND, "nothing to flush");
+}
+
+void yieldrwa::setflush(const uint32_t& flush_interval)
+{
+    require_auth(_gstate->admin);
+    _gstate.mut().flush_interval = flush_interval;
+}
+
+void yieldrwa::_forward_shares(const name& bank, const vector<plan_alloc_t>& to_stake, const vector<plan_alloc_t>& to_guar)
+{
+    // 收益入账即计为已交付：延迟转出不能让 guaranty 把已覆盖的部分再当作缺口补足
+    _notify_delivered(to_stake);
 
-    double stake_pct    = cfg[STAKE_POOL];
-    double guaranty_pct = cfg[GUARANTY_POOL] * _get_coverage_ratio(plan_id);
-    double swap_pct     = 100.0 - stake_pct - guaranty_pct;
-    if (swap_pct < 0) swap_pct = 0;
+    const uint32_t interval = _gstate->flush_interval;
+    if (interval == 0) {
+        _send_shares(bank, to_stake, to_guar);
+        return;
+    }
 
-    const __int128 T = total.amount;
+    const time_point_sec now = time_point_sec(current_time_point());
+    pending_share_t::idx_t pending(get_self(), get_self().value);
+    const auto accrue = [&](const plan_alloc_t& a, const bool& is_stake) {
+        auto it = pending.find(a.plan_id);
+        if (it == pending.end()) {
+            pending.emplace(get_self(), [&](auto& s){
+                s.plan_id = a.plan_id;
+                s.token   = extended_symbol(a.quantity.symbol, bank);
+                s.since   = now;
+                (is_stake ? s.stake : s.guaranty) += a.quantity;
+            });
+        } else {
+            pending.modify(it, same_payer, [&](auto& s){
+                (is_stake ? s.stake : s.guaranty) += a.quantity;
+            });
+        }
+    };
+    for (const auto& a : to_stake) accrue(a, true);
+    for (const auto& a : to_guar)  accrue(a, false);
+
+    // 最早一笔累计已超过间隔：本次入账顺带转出
+    auto by_since = pending.get_index<"bysince"_n>();
+    auto oldest   = by_since.begin();
+    if (oldest != by_since.end() && now.sec_since_epoch() - oldest->since.sec_since_epoch() >= interval)
+        _flush(MAX_DISTRIBUTE_PLANS);
+}
 
-    asset stake{(int64_t)(T * stake_pct / 100.0), total.symbol};
-    asset guar {(int64_t)(T * guaranty_pct / 100.0), total.symbol};
-    asset swap {total.amount - stake.amount - guar.amount, total.symbol};
+void yieldrwa::_notify_delivered(const vector<plan_alloc_t>& to_stake)
+{
+    if (to_stake.size() == 1) {
+        const auto& a = to_stake.front();
+        guarantyrwa::addyield_action{
+            GUARANTY_POOL,
+            { permission_level{ get_self(), active_perm } }
+        }.send(a.plan_id, a.quantity);
+    } else if (!to_stake.empty()) {
+        guarantyrwa::addyields_action{
+            GUARANTY_POOL,
+            { permission_level{ get_self(), active_perm } }
+        }.send(to_stake);
+    }
+}
 
-    if (stake.amount > 0)
-        TRANSFER(bank, STAKE_POOL, stake, "reward:" + std::to_string(plan_id));
+void yieldrwa::_send_shares(const name& bank, const vector<plan_alloc_t>& to_stake, const vector<plan_alloc_t>& to_guar)
+{
+    // 单个计划沿用 move；多个计划每个目标池一次转移，收款池按明细逐计划入账
+    if (to_stake.size() == 1) {
+        const auto& a = to_stake.front();
+#ifdef RWAFI_HUB
+        rwahub::pools::stake_reward(get_self(), rwahub::YIELD_TO_STAKE, bank, a.quantity, a.plan_id);
+#else
+        POOL_MOVE(STAKE_POOL, bank, a.quantity, a.plan_id);
+#endif
+    } else if (!to_stake.empty()) {
+#ifdef RWAFI_HUB
+        rwahub::pools::stake_rewards(get_self(), rwahub::YIELD_TO_STAKE, bank, to_stake);
+#else
+        POOL_MOVE_BATCH(STAKE_POOL, bank, to_stake);
+#endif
+    }
 
-    if (guar.amount > 0)
-        TRANSFER(bank, GUARANTY_POOL, guar, "reward:" + std::to_string(plan_id));
+    if (to_guar.size() == 1) {
+        const auto& a = to_guar.front();
+#ifdef RWAFI_HUB
+        rwahub::pools::guaranty_reward(get_self(), bank, a.quantity, a.plan_id);
+#else
+        POOL_MOVE(GUARANTY_POOL, bank, a.quantity, a.plan_id);
+#endif
+    } else if (!to_guar.empty()) {
+#ifdef RWAFI_HUB
+        rwahub::pools::guaranty_rewards(get_self(), bank, to_guar);
+#else
+        POOL_MOVE_BATCH(GUARANTY_POOL, bank, to_guar);
+#endif
+    }
+}
+
+uint16_t yieldrwa::_flush(const uint16_t& max_plans)
+{
+    pending_share_t::idx_t pending(get_self(), get_self().value);
+    auto it = pending.begin();
+    if (it == pending.end()) return 0;
+
+    // movebatch 只能带一种代币：本次只处理与第一行同代币的计划，按代币索引遍历不扫描其他代币
+    const extended_symbol token = it->token;
+    const uint128_t key = pending_share_t::token_key(token);
+    auto by_token = pending.get_index<"bytoken"_n>();
+    auto row = by_token.lower_bound(key);
+    vector<plan_alloc_t> to_stake, to_guar;
+    uint16_t done = 0;
+    while (row != by_token.end() && row->by_token() == key && done < max_plans) {
+        if (row->stake.amount > 0)    to_stake.push_back({row->plan_id, row->stake.of(token.get_symbol())});
+        if (row->guaranty.amount > 0) to_guar.push_back({row->plan_id, row->guaranty.of(token.get_symbol())});
+        row = by_token.erase(row);
+        ++done;
+    }
+
+    _send_shares(token.get_contract(), to_stake, to_guar);
+    return done;
+}
+
+void yieldrwa::_book_yield(const fundplan_t& plan, const asset& total, const yield_parts_t& parts)
+{
+    const uint64_t plan_id = plan.id;
+    const asset& swap = parts.swap;
 
     // accumulate buyback
     if (swap.amount > 0) {
         plan_buyback_t::pl_tbl tbl(get_self(), get_self().value);
         auto it = tbl.find(plan_id);
 
-        asset zero(0, total.symbol);
-
         if (it == tbl.end()) {
+            // 旧版回购行须先经 migratebuys 搬迁，否则新旧两行并存
+            legacy_buyback_t::pl_tbl legacy(get_self(), get_self().value);
+            CHECKC(legacy.find(plan_id) == legacy.end(), err::STATUS_ERROR,
+                   "plan buyback pending migration: " + std::to_string(plan_id));
             tbl.emplace(get_self(), [&](auto& row){
                 row.plan_id       = plan_id;
                 row.total_buyback = swap;
-                row.used_buyback  = zero;
-                row.total_voucher = zero;
+                row.total_voucher = asset(0, plan.receipt_symbol);
                 row.max_slippage  = 100; // 1%
+                row.chunk_size    = {};     // 默认一次回购全部
                 row.updated_at    = time_point_sec(current_time_point());
+                row.next_buyback_at = row.updated_at;
             });
         } else {
             tbl.modify(it, get_self(), [&](auto& row){
+                const time_point_sec now = time_point_sec(current_time_point());
+                // 新的待回购余额（或挂起后恢复）：从现在起排入 crank 队列
+                if (row.remaining() == 0 || row.next_buyback_at > now)
+                    row.next_buyback_at = now;
                 row.total_buyback += swap;
-                row.updated_at     = time_point_sec(current_time_point());
+                row.updated_at     = now;
             });
         }
     }
 
-    _log_yield(plan_id, total, stake, guar, swap);
+    _log_yield(plan_id, total, parts.stake, parts.guar, swap);
 }
 
 void yieldrwa::_log_yield(const uint64_t& plan_id,const asset& total,const asset& stake,const asset& guar,const asset& swap)
@@ -277,45 +923,89 @@ void yieldrwa::_log_yield(const uint64_t& plan_id,const asset& total,const asset
     time_point_sec now = time_point_sec(current_time_point());
 
     yield_log_t::idx_t logs(get_self(), plan_id);
+    auto it = logs.find(period);
+    const bool new_period = it == logs.end();
 
-    asset cumulative_prev(0, total.symbol);
-    if (logs.begin() != logs.end()) {
-        auto last = logs.end(); --last;
-        cumulative_prev = last->cumulative_yield;
-    }
+    const amount64 cumulative = _add_yield_totals(plan_id, period, new_period, total, stake, guar, swap);
 
-    auto it = logs.find(period);
-    if (it == logs.end()) {
+    if (new_period) {
         logs.emplace(get_self(), [&](auto& y){
             y.period                = period;
             y.period_yield          = total;
             y.investor_yield        = stake;
             y.guarantor_yield       = guar;
             y.buyback_yield         = swap;
-            y.cumulative_yield      = cumulative_prev + total;
+            y.cumulative_yield      = cumulative;
             y.created_at            = now;
             y.updated_at            = now;
         });
+        _trim_logs(logs, period);
     } else {
         logs.modify(it, get_self(), [&](auto& y){
             y.period_yield          += total;
             y.investor_yield        += stake;
             y.guarantor_yield       += guar;
             y.buyback_yield         += swap;
-            y.cumulative_yield      += total;
+            y.cumulative_yield       = cumulative;
             y.updated_at             = now;
         });
     }
+
+    logyield_action(get_self(), {get_self(), "active"_n})
+        .send(plan_id, period, total, stake, guar, swap, cumulative.of(total.symbol));
+}
+
+amount64 yieldrwa::_add_yield_totals(const uint64_t& plan_id, const uint64_t& period, const bool& new_period,
+                                     const asset& total, const asset& stake, const asset& guar, const asset& swap)
+{
+    yield_total_t::idx_t totals(get_self(), get_self().value);
+    auto it = totals.find(plan_id);
+    if (it == totals.end()) {
+        it = totals.emplace(get_self(), [&](auto& t){
+            t.plan_id      = plan_id;
+            t.first_period = period;
+        });
+    }
+
+    totals.modify(it, same_payer, [&](auto& t){
+        t.total_yield     += total;
+        t.investor_yield  += stake;
+        t.guarantor_yield += guar;
+        t.buyback_yield   += swap;
+        t.first_period     = std::min(t.first_period, period);
+        t.last_period      = std::max(t.last_period, period);
+        if (new_period) ++t.periods;
+        t.updated_at       = time_point_sec(current_time_point());
+    });
+    return it->total_yield;
+}
+
+void yieldrwa::_trim_logs(yield_log_t::idx_t& logs, const uint64_t& latest)
+{
+    const int64_t cutoff = calendar::period_ordinal(latest) - YIELD_LOG_WINDOW;
+    for (auto it = logs.begin(); it != logs.end() && calendar::period_ordinal(it->period) <= cutoff; )
+        it = logs.erase(it);
+}
+
+// 仅作事件：参数只进入 action trace
+void yieldrwa::logyield(const uint64_t&, const uint64_t&, const asset&,
+                        const asset&, const asset&, const asset&, const asset&)
+{
+    require_auth(get_self());
 }
 
 asset yieldrwa::_calc_yearly_yield_core(const uint64_t& plan_id,const uint64_t& year,const string& type) const
 {
+    fundplan_t::idx_t plans(INVEST_POOL, INVEST_POOL.value);
+    auto p = plans.find(plan_id);
+    CHECKC(p != plans.end(), err::RECORD_NOT_FOUND, "plan not found");
+
     yield_log_t::idx_t logs(get_self(), plan_id);
     CHECKC(logs.begin() != logs.end(), err::RECORD_NOT_FOUND,
            "no yield logs");
 
     int64_t total = 0;
-    symbol sym = logs.begin()->period_yield.symbol;
+    const symbol sym = p->goal_quantity.symbol;
 
     uint64_t start = year * 100 + 1;
     uint64_t end   = (year + 1) * 100;
@@ -19,6 +19,9 @@ mpush   $guaranty_con init  '["flonian"]' -p $guaranty_con
 mpush sing.token transfer '["gahbnbehaskk", "guaranty1111", "300.00000000 SING", "guaranty:8"]' -p gahbnbehaskk
 mpush $guaranty_con redeem '["gahbnbehaskk",7,"100.00000000 SING"]' -p gahbnbehaskk
 
+#第 1 计划年结束后，按 APR 计提补足保底收益
+mpush $guaranty_con guarantpay '["flonian",8,1]' -p flonian
+
 
 mpush $invest_con  cancelplan '["gahbnbehaskk",7]' -p gahbnbehaskk
 
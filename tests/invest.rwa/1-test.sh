@@ -40,6 +40,13 @@ mpush $invest_con createplan '[
 
 #mpush $invest_con  cancelplan '["gahbnbehaskk",3]' -p gahbnbehaskk
 
+# keeper 激励：每推进一个计划奖励 0.01 SING
+mpush $invest_con setkeeper '["0.01000000 SING"]' -p flonian
+mpush sing.token transfer '["flonian", "investrwa112", "10.00000000 SING", "keeper"]' -p flonian
+
+# 按截止时间推进到期计划的状态（最多 5 个）
+mpush $invest_con crank '["flonian",5]' -p flonian
+
 
 
 
@@ -0,0 +1,272 @@
+/**
+ * Per-action cost benchmark on the native simulator.
+ *
+ * Drives every user facing action at N = 1, 10, 100, 1000 participants and
+ * records, for the measured transaction only:
+ *   cpu_us     wall time spent in the contract handlers (all receivers)
+ *   net_bytes  packed size of the pushed action
+ *   ram        bytes billed per payer (negative = refunded)
+ *
+ * The report is JSON; thresholds.json holds the accepted baseline. A run
+ * fails when RAM or net grow at all, or CPU exceeds the baseline by more
+ * than cpu_slack (wall time is machine dependent).
+ *
+ *   sim_bench -- [--max-n 1000] [--report file] [--thresholds file] [--update-thresholds]
+ */
+#define BOOST_TEST_MODULE rwafi_action_bench
+#include <boost/test/included/unit_test.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include "../rwafi_fixture.hpp"
+
+#include <guaranty.rwa/guarantyrwadb.hpp>
+#include <invest.rwa/investrwadb.hpp>
+#include <rwafi.token/rwafi.token.hpp>
+
+using namespace rwafi_sim;
+
+namespace {
+
+struct cost_sample {
+    std::string                 action;
+    uint32_t                    n = 0;
+    double                      cpu_us = 0;
+    uint32_t                    net_bytes = 0;
+    std::map<name, int64_t>     ram;
+};
+
+struct options {
+    uint32_t    max_n = 1000;
+    std::string report = "action_bench.json";
+    std::string thresholds;
+    bool        update = false;
+};
+
+options parse_options() {
+    options o;
+    const auto& suite = boost::unit_test::framework::master_test_suite();
+    for (int i = 1; i < suite.argc; ++i) {
+        const std::string a = suite.argv[i];
+        auto next = [&]() -> std::string {
+            BOOST_REQUIRE_MESSAGE(i + 1 < suite.argc, "missing value for " << a);
+            return suite.argv[++i];
+        };
+        if (a == "--max-n")                  o.max_n = std::stoul(next());
+        else if (a == "--report")            o.report = next();
+        else if (a == "--thresholds")        o.thresholds = next();
+        else if (a == "--update-thresholds") o.update = true;
+        else BOOST_FAIL("unknown option " << a);
+    }
+    return o;
+}
+
+struct bench_chain : rwafi_fixture {
+    std::vector<cost_sample>& out;
+    const uint32_t       n;
+
+    bench_chain(std::vector<cost_sample>& o, uint32_t n) : out(o), n(n) {}
+
+    // push one transaction and keep its cost
+    void measure(const std::string& label, const std::string& result) {
+        BOOST_REQUIRE_MESSAGE(result.empty(), label << " @" << n << ": " << result);
+        cost_sample s;
+        s.action    = label;
+        s.n         = n;
+        s.net_bytes = chain.net_bytes();
+        s.ram       = chain.ram_deltas();
+        for (const auto& t : chain.traces()) s.cpu_us += t.elapsed_ns / 1000.0;
+        out.push_back(std::move(s));
+    }
+};
+
+// createplan with n - 1 plans already on the table
+void bench_createplan(std::vector<cost_sample>& out, uint32_t n) {
+    bench_chain b(out, n);
+    for (uint32_t i = 1; i < n; ++i)
+        REQUIRE_OK(b.create_plan(rwafi_fixture::receipt_sym(i), sing(1000), 7 * flon::DAY_SECONDS));
+    b.measure("createplan", b.create_plan(rwafi_fixture::receipt_sym(n), sing(1000), 7 * flon::DAY_SECONDS));
+}
+
+// one plan with n investors and n guarantors, walked from raise to redeem
+void bench_plan(std::vector<cost_sample>& out, uint32_t n) {
+    bench_chain b(out, n);
+    auto& chain = b.chain;
+
+    const uint64_t plan_id = 1;
+    const symbol   st      = rwafi_fixture::receipt_sym(1);
+    const asset    goal    = sing(100.0 * n);
+    const std::string plan_memo = "plan:" + std::to_string(plan_id);
+    REQUIRE_OK(b.create_plan(st, goal, 7 * flon::DAY_SECONDS));
+
+    std::vector<name> investors, guarantors;
+    for (uint32_t i = 0; i < n; ++i) {
+        investors.push_back(rwafi_fixture::participant("inv", i));
+        guarantors.push_back(rwafi_fixture::participant("gua", i));
+        b.create_account(investors.back(), sing(1000));
+        b.create_account(guarantors.back(), sing(1000));
+    }
+
+    // guarantors cover 60% of the goal, above the 50% line
+    for (const auto& g : guarantors)
+        REQUIRE_OK(b.transfer(flon::SING_BANK, g, flon::VAULT_POOL, sing(60), "guaranty/guaranty:" + std::to_string(plan_id)));
+
+    for (uint32_t i = 0; i + 1 < n; ++i)
+        REQUIRE_OK(b.transfer(flon::SING_BANK, investors[i], flon::INVEST_POOL, sing(100), plan_memo));
+    b.measure("invest", b.transfer(flon::SING_BANK, investors.back(), flon::INVEST_POOL, sing(100), plan_memo));
+
+    chain.produce(30 * flon::DAY_SECONDS);
+    b.measure("yield", b.transfer(flon::SING_BANK, b.admin, flon::VAULT_POOL, sing(100), "yield/" + plan_memo));
+
+    const name holder = investors.front();
+    b.measure("claim", chain.push(flon::STAKE_POOL, "claim"_n, holder, holder, plan_id));
+    b.measure("unstake", chain.push(flon::STAKE_POOL, "unstake"_n, holder, holder, plan_id, asset(5000000000, st)));
+
+    // ST/SING market seeded with the unstaked receipts, then a buyback of the 10% swap share
+    const name tp = "stsing"_n;
+    REQUIRE_OK(chain.push(flon::SWAP_POOL, "addmarket"_n, flon::SWAP_POOL, tp,
+                          extended_symbol(st, flon::RECEIPT_BANK), extended_symbol(flon::SING_SYM, flon::SING_BANK),
+                          (uint16_t)30));
+    REQUIRE_OK(b.transfer(flon::RECEIPT_BANK, holder, flon::SWAP_POOL, asset(5000000000, st), "deposit:" + tp.to_string()));
+    REQUIRE_OK(b.transfer(flon::SING_BANK, b.admin, flon::SWAP_POOL, sing(50), "deposit:" + tp.to_string()));
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "observe"_n, b.admin, plan_id));
+    chain.produce(60);
+    b.measure("buyback", chain.push(flon::YIELD_POOL, "buyback"_n, b.admin, b.admin, plan_id));
+
+    // from N = 10 up the delivered yield is below the 8% APR and year 1 needs a top-up
+    chain.produce(366 * flon::DAY_SECONDS);
+    b.measure("guarantpay", chain.push(flon::GUARANTY_POOL, "guarantpay"_n, b.admin, b.admin, plan_id, (uint64_t)1));
+
+    const name g = guarantors.front();
+    // guarantor rows settle lazily against their tranche
+    rwafi::guarantor_stake_t::idx_t  stakes(flon::GUARANTY_POOL, plan_id);
+    rwafi::guaranty_tranche_t::idx_t tranches(flon::GUARANTY_POOL, plan_id);
+    auto stake = stakes.get(g.value);
+    stake.settle(tranches.get(stake.tranche));
+    const asset available = stake.available_stake.of(flon::SING_SYM);
+    b.measure("redeem", chain.push(flon::GUARANTY_POOL, "redeem"_n, g, g, plan_id, available));
+}
+
+// a plan that misses its soft cap: the deadline crank refunds the first page of n stakers
+void bench_batchunstake(std::vector<cost_sample>& out, uint32_t n) {
+    bench_chain b(out, n);
+    REQUIRE_OK(b.create_plan(rwafi_fixture::receipt_sym(1), sing(1000.0 * n), 7 * flon::DAY_SECONDS));
+    for (uint32_t i = 0; i < n; ++i) {
+        const name inv = rwafi_fixture::participant("inv", i);
+        b.create_account(inv, sing(100));
+        REQUIRE_OK(b.transfer(flon::SING_BANK, inv, flon::INVEST_POOL, sing(100), "plan:1"));
+    }
+    b.chain.produce(7 * flon::DAY_SECONDS + 1);
+    b.measure("batchunstake", b.chain.push(flon::INVEST_POOL, "crank"_n, b.keeper, b.keeper, (uint16_t)1));
+}
+
+// one rwafi.token transferbatch paying n new holders (capped at max_batch_transfers)
+void bench_transferbatch(std::vector<cost_sample>& out, uint32_t n) {
+    bench_chain b(out, n);
+    const asset supply(1000000000000, symbol("TKN", 4));
+    REQUIRE_OK(b.chain.push(flon::RECEIPT_BANK, "create"_n, flon::INVEST_POOL, b.admin, supply));
+    REQUIRE_OK(b.chain.push(flon::RECEIPT_BANK, "issue"_n, b.admin, b.admin, supply, std::string("issue")));
+
+    std::vector<std::pair<name, asset>> batch;
+    for (uint32_t i = 0; i < std::min(n, eosio::token::max_batch_transfers); ++i) {
+        const name r = rwafi_fixture::participant("rcv", i);
+        b.create_account(r);
+        batch.emplace_back(r, asset(10000, supply.symbol));
+    }
+    b.measure("transferbatch", b.chain.push(flon::RECEIPT_BANK, "transferbatch"_n, b.admin,
+                                            b.admin, batch, std::string("airdrop")));
+}
+
+std::string key_of(const cost_sample& s) { return s.action + "@" + std::to_string(s.n); }
+
+void write_report(const std::string& path, const std::vector<cost_sample>& samples) {
+    std::ofstream f(path);
+    BOOST_REQUIRE_MESSAGE(f, "cannot write " << path);
+    f << "{\n  \"samples\": [\n";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& s = samples[i];
+        f << "    {\"action\": \"" << s.action << "\", \"n\": " << s.n
+          << ", \"cpu_us\": " << s.cpu_us << ", \"net_bytes\": " << s.net_bytes << ", \"ram\": {";
+        bool first = true;
+        for (const auto& [payer, bytes] : s.ram) {
+            f << (first ? "" : ", ") << "\"" << payer.to_string() << "\": " << bytes;
+            first = false;
+        }
+        f << "}}" << (i + 1 < samples.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+}
+
+void write_thresholds(const std::string& path, const std::vector<cost_sample>& samples, double cpu_slack) {
+    std::ofstream f(path);
+    BOOST_REQUIRE_MESSAGE(f, "cannot write " << path);
+    f << "{\n  \"cpu_slack\": " << cpu_slack << ",\n  \"cpu_floor_us\": 500,\n  \"limits\": {\n";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& s = samples[i];
+        f << "    \"" << key_of(s) << "\": {\"cpu_us\": " << (int64_t)(s.cpu_us + 1)
+          << ", \"net_bytes\": " << s.net_bytes << ", \"ram\": {";
+        bool first = true;
+        for (const auto& [payer, bytes] : s.ram) {
+            f << (first ? "" : ", ") << "\"" << payer.to_string() << "\": " << bytes;
+            first = false;
+        }
+        f << "}}" << (i + 1 < samples.size() ? "," : "") << "\n";
+    }
+    f << "  }\n}\n";
+}
+
+// RAM and net are deterministic and may not grow; CPU gets cpu_slack x headroom
+void check_thresholds(const std::string& path, const std::vector<cost_sample>& samples) {
+    boost::property_tree::ptree root;
+    boost::property_tree::read_json(path, root);
+    const double cpu_slack = root.get<double>("cpu_slack");
+    const double cpu_floor = root.get<double>("cpu_floor_us");
+    const auto&  limits    = root.get_child("limits");
+
+    for (const auto& s : samples) {
+        const auto it = limits.find(key_of(s));
+        if (it == limits.not_found()) {
+            BOOST_TEST_MESSAGE("no baseline for " << key_of(s));
+            continue;
+        }
+        const auto& lim = it->second;
+        const double cpu_cap = std::max(cpu_floor, lim.get<double>("cpu_us") * cpu_slack);
+        BOOST_CHECK_MESSAGE(s.cpu_us <= cpu_cap, key_of(s) << " cpu " << s.cpu_us << "us > " << cpu_cap << "us");
+        BOOST_CHECK_MESSAGE(s.net_bytes <= lim.get<uint32_t>("net_bytes"),
+                            key_of(s) << " net " << s.net_bytes << " > " << lim.get<uint32_t>("net_bytes"));
+        for (const auto& [payer, bytes] : s.ram) {
+            // account names contain '.', the default ptree path separator
+            const boost::property_tree::ptree::path_type ram_path("ram/" + payer.to_string(), '/');
+            const int64_t cap = lim.get<int64_t>(ram_path, 0);
+            BOOST_CHECK_MESSAGE(bytes <= cap, key_of(s) << " ram of " << payer.to_string() << " " << bytes << " > " << cap);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(action_costs) {
+    const options opt = parse_options();
+
+    std::vector<cost_sample> samples;
+    for (uint32_t n = 1; n <= opt.max_n; n *= 10) {
+        bench_createplan(samples, n);
+        bench_plan(samples, n);
+        bench_batchunstake(samples, n);
+        bench_transferbatch(samples, n);
+    }
+
+    for (const auto& s : samples)
+        BOOST_TEST_MESSAGE(key_of(s) << ": " << s.cpu_us << " us, " << s.net_bytes << " net bytes");
+
+    write_report(opt.report, samples);
+    if (opt.update) {
+        BOOST_REQUIRE_MESSAGE(!opt.thresholds.empty(), "--update-thresholds needs --thresholds <file>");
+        write_thresholds(opt.thresholds, samples, 10.0);
+    } else if (!opt.thresholds.empty()) {
+        check_thresholds(opt.thresholds, samples);
+    }
+}
@@ -0,0 +1,316 @@
+/**
+ * Adversarial CPU-cliff search on the native simulator.
+ *
+ * Every unbounded loop reachable from an action gets a workload that grows
+ * the loop's dimension (stakers, guarantors, yield-log months, swap markets)
+ * and probes the action as a dry run at each size. N doubles until the probe
+ * exceeds the budget, then a fresh chain is stepped between the last passing
+ * and the first failing N to locate the breaking point.
+ *
+ * Costs are native wall time; --scale converts them to an on-chain estimate
+ * (the WASM engine runs slower than native code), so the breaking N is only
+ * as good as the scale factor fed in.
+ *
+ *   sim_cliffs -- [--budget-us 150000] [--scale 3] [--max-n 65536] [--report file]
+ */
+#define BOOST_TEST_MODULE rwafi_cpu_cliffs
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <optional>
+
+#include "../rwafi_fixture.hpp"
+
+#include <guaranty.rwa/guarantyrwadb.hpp>
+#include <invest.rwa/investrwadb.hpp>
+
+using namespace rwafi_sim;
+
+namespace {
+
+struct options {
+    double      budget_us = 150000;     // default max_transaction_cpu_usage
+    double      scale     = 3;          // native → on-chain CPU factor
+    uint32_t    max_n     = 65536;
+    std::string report    = "cpu_cliffs.json";
+};
+
+options parse_options() {
+    options o;
+    const auto& suite = boost::unit_test::framework::master_test_suite();
+    for (int i = 1; i < suite.argc; ++i) {
+        const std::string a = suite.argv[i];
+        auto next = [&]() -> std::string {
+            BOOST_REQUIRE_MESSAGE(i + 1 < suite.argc, "missing value for " << a);
+            return suite.argv[++i];
+        };
+        if (a == "--budget-us")      o.budget_us = std::stod(next());
+        else if (a == "--scale")     o.scale = std::stod(next());
+        else if (a == "--max-n")     o.max_n = std::stoul(next());
+        else if (a == "--report")    o.report = next();
+        else BOOST_FAIL("unknown option " << a);
+    }
+    return o;
+}
+
+/**
+ * A chain whose worst-case dimension can be grown in place and probed.
+ * grow(n) only ever adds rows: a smaller N needs a fresh instance.
+ */
+struct cliff_workload : rwafi_fixture {
+    uint32_t n = 0;
+
+    virtual ~cliff_workload() = default;
+    virtual void        grow_one(uint32_t i) = 0;
+    virtual std::string probe() = 0;   // one dry run of the action under test
+
+    void grow(uint32_t to) {
+        for (; n < to; ++n) grow_one(n);
+    }
+
+    // best of three dry runs: wall time only ever gets noisier, never faster
+    double cost_us() {
+        double best = -1;
+        for (int r = 0; r < 3; ++r) {
+            const std::string result = probe();
+            BOOST_REQUIRE_MESSAGE(result.empty(), "probe @" << n << ": " << result);
+            double us = 0;
+            for (const auto& t : chain.traces()) us += t.elapsed_ns / 1000.0;
+            best = best < 0 ? us : std::min(best, us);
+        }
+        return best;
+    }
+
+    std::string yield_deposit(const asset& quantity) {
+        return transfer(flon::SING_BANK, admin, flon::VAULT_POOL, quantity, "yield/plan:1");
+    }
+
+    // a successful plan 1: 900 of 1000 SING raised, 80% soft cap reached
+    void raise_plan(uint16_t return_months = 12) {
+        REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, return_months));
+        create_account("investor"_n, sing(900));
+        REQUIRE_OK(transfer(flon::SING_BANK, "investor"_n, flon::INVEST_POOL, sing(900), "plan:1"));
+    }
+
+    void add_guarantor(uint32_t i, const asset& stake) {
+        const name g = participant("gua", i);
+        create_account(g, stake);
+        REQUIRE_OK(transfer(flon::SING_BANK, g, flon::VAULT_POOL, stake, "guaranty/guaranty:1"));
+    }
+};
+
+// invest.crank → stake.batchunstake: stakers of a plan that missed its soft cap
+struct refund_stakers : cliff_workload {
+    time_point_sec deadline;
+
+    refund_stakers() {
+        deadline = chain.now() + 7 * flon::DAY_SECONDS + 1;
+        REQUIRE_OK(create_plan(receipt_sym(1), sing(1e7), 7 * flon::DAY_SECONDS));
+    }
+    void grow_one(uint32_t i) override {
+        const name inv = participant("inv", i);
+        create_account(inv, sing(1));
+        REQUIRE_OK(transfer(flon::SING_BANK, inv, flon::INVEST_POOL, sing(1), "plan:1"));
+    }
+    std::string probe() override {
+        const time_point_sec t = chain.now();
+        chain.set_time(deadline);
+        const std::string r = chain.dry_run(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)1);
+        chain.set_time(t);
+        return r;
+    }
+};
+
+// yield deposit → guaranty._handle_reward_transfer: one pass over the plan's tranches, not its guarantors
+struct yield_guarantors : cliff_workload {
+    yield_guarantors() { raise_plan(); }
+    void grow_one(uint32_t i) override { add_guarantor(i, sing(1)); }
+    std::string probe() override {
+        return chain.dry_run(flon::SING_BANK, "transfer"_n, admin, admin, flon::VAULT_POOL, sing(100),
+                             std::string("yield/plan:1"));
+    }
+};
+
+// guarantpay → _deduct_from_guarantors: year 1 closed with no yield delivered (tranche waterfall)
+struct guarantpay_guarantors : cliff_workload {
+    time_point_sec year_end;
+
+    guarantpay_guarantors() {
+        year_end = chain.now() + 366 * flon::DAY_SECONDS;
+        raise_plan();
+    }
+    void grow_one(uint32_t i) override { add_guarantor(i, sing(100)); }
+    std::string probe() override {
+        const time_point_sec t = chain.now();
+        chain.set_time(year_end);
+        const std::string r = chain.dry_run(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin,
+                                            (uint64_t)1, (uint64_t)1);
+        chain.set_time(t);
+        return r;
+    }
+};
+
+// redeem → _redeem_in_progress: total stake summed over tranches, not guarantors
+struct redeem_guarantors : cliff_workload {
+    const name first = participant("gua", 0);
+
+    redeem_guarantors() {
+        raise_plan();
+        add_guarantor(0, sing(600));        // 60% cover, above the 50% line
+        REQUIRE_OK(yield_deposit(sing(100)));
+        n = 1;
+    }
+    void grow_one(uint32_t i) override { add_guarantor(i, sing(1)); }
+    std::string probe() override {
+        return chain.dry_run(flon::GUARANTY_POOL, "redeem"_n, first, first, (uint64_t)1, sing(1));
+    }
+};
+
+// redeem → _redeem_in_progress: totals over every monthly yield log
+struct redeem_months : cliff_workload {
+    // time_point_sec runs out in 2106: the longest plan the chain can express
+    static constexpr uint16_t return_months = 948;
+    static constexpr uint32_t max_logs      = return_months * 30 / 31 - 1;   // 31-day steps
+    const name first = participant("gua", 0);
+
+    redeem_months() {
+        raise_plan(return_months);
+        add_guarantor(0, sing(600));
+    }
+    void grow_one(uint32_t) override {
+        chain.produce(31 * flon::DAY_SECONDS);
+        REQUIRE_OK(yield_deposit(sing(1)));
+    }
+    std::string probe() override {
+        return chain.dry_run(flon::GUARANTY_POOL, "redeem"_n, first, first, (uint64_t)1, sing(1));
+    }
+};
+
+// observe / buyback → find_pair_by_symbols: the plan's market sorts after every filler
+struct observe_markets : cliff_workload {
+    observe_markets() {
+        raise_plan();
+        const symbol st = receipt_sym(1);
+        const name   tp = "zzzzzz"_n;
+        REQUIRE_OK(chain.push(flon::STAKE_POOL, "unstake"_n, "investor"_n, "investor"_n, (uint64_t)1,
+                              asset(10000000000, st)));
+        REQUIRE_OK(chain.push(flon::SWAP_POOL, "addmarket"_n, flon::SWAP_POOL, tp,
+                              extended_symbol(st, flon::RECEIPT_BANK),
+                              extended_symbol(flon::SING_SYM, flon::SING_BANK), (uint16_t)30));
+        REQUIRE_OK(transfer(flon::RECEIPT_BANK, "investor"_n, flon::SWAP_POOL, asset(10000000000, st),
+                            "deposit:" + tp.to_string()));
+        REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::SWAP_POOL, sing(100), "deposit:" + tp.to_string()));
+    }
+    void grow_one(uint32_t i) override {
+        REQUIRE_OK(chain.push(flon::SWAP_POOL, "addmarket"_n, flon::SWAP_POOL, participant("m", i),
+                              extended_symbol(flon::SING_SYM, flon::SING_BANK),
+                              extended_symbol(symbol("FILL", 4), flon::SWAP_POOL), (uint16_t)30));
+    }
+    std::string probe() override {
+        return chain.dry_run(flon::YIELD_POOL, "observe"_n, admin, (uint64_t)1);
+    }
+};
+
+struct cliff_spec {
+    std::string                                     workload;
+    std::string                                     action;
+    std::string                                     dimension;
+    uint32_t                                        max_n;      // 0 = --max-n
+    std::function<std::unique_ptr<cliff_workload>()> make;
+};
+
+struct cliff_result {
+    const cliff_spec*                       spec;
+    std::optional<uint32_t>                 breaking_n;
+    std::vector<std::pair<uint32_t, double>> curve;     // N → on-chain estimate (us)
+};
+
+template<typename W>
+std::function<std::unique_ptr<cliff_workload>()> factory() {
+    return [] { return std::make_unique<W>(); };
+}
+
+cliff_result search(const cliff_spec& spec, const options& opt) {
+    cliff_result res{&spec, std::nullopt, {}};
+    const uint32_t max_n = spec.max_n ? std::min(spec.max_n, opt.max_n) : opt.max_n;
+    auto over = [&](cliff_workload& w, uint32_t n) {
+        w.grow(n);
+        const double us = w.cost_us() * opt.scale;
+        res.curve.emplace_back(n, us);
+        return us > opt.budget_us;
+    };
+
+    // doubling until the first N over budget
+    uint32_t lo = 0, hi = 0;
+    {
+        auto w = spec.make();
+        for (uint32_t n = std::max<uint32_t>(1, w->n);; n = std::min(max_n, n * 2)) {
+            if (over(*w, n)) { hi = n; break; }
+            lo = n;
+            if (n >= max_n) break;
+        }
+    }
+    if (hi == 0) return res;
+
+    // 16 linear steps inside (lo, hi] on a fresh chain
+    auto w = spec.make();
+    const uint32_t step = std::max<uint32_t>(1, (hi - lo) / 16);
+    res.breaking_n = hi;
+    for (uint32_t n = lo + step; n < hi; n += step) {
+        if (over(*w, n)) { res.breaking_n = n; break; }
+    }
+    std::sort(res.curve.begin(), res.curve.end());
+    return res;
+}
+
+void write_report(const std::string& path, const options& opt, const std::vector<cliff_result>& results) {
+    std::ofstream f(path);
+    BOOST_REQUIRE_MESSAGE(f, "cannot write " << path);
+    f << "{\n  \"budget_us\": " << opt.budget_us << ",\n  \"scale\": " << opt.scale
+      << ",\n  \"max_n\": " << opt.max_n << ",\n  \"cliffs\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        f << "    {\"workload\": \"" << r.spec->workload << "\", \"action\": \"" << r.spec->action
+          << "\", \"dimension\": \"" << r.spec->dimension << "\", \"breaking_n\": ";
+        if (r.breaking_n) f << *r.breaking_n; else f << "null";
+        f << ", \"curve\": [";
+        for (size_t j = 0; j < r.curve.size(); ++j)
+            f << (j ? ", " : "") << "[" << r.curve[j].first << ", " << (int64_t)r.curve[j].second << "]";
+        f << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ],\n  \"unreachable\": [\n"
+      << "    {\"loop\": \"yieldrwa::_calc_yearly_yield_core\", \"dimension\": \"yield-log months\","
+      << " \"reason\": \"only called by get_yearly_yield, which is not an action\"}\n  ]\n}\n";
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cpu_cliffs) {
+    const options opt = parse_options();
+
+    const std::vector<cliff_spec> specs = {
+        {"refund_stakers",        "invest.crank",       "stakers",          0, factory<refund_stakers>()},
+        {"yield_guarantors",      "sing.transfer",      "guarantors",       0, factory<yield_guarantors>()},
+        {"guarantpay_guarantors", "guaranty.guarantpay","guarantors",       0, factory<guarantpay_guarantors>()},
+        {"redeem_guarantors",     "guaranty.redeem",    "guarantors",       0, factory<redeem_guarantors>()},
+        {"redeem_months",         "guaranty.redeem",    "yield-log months", redeem_months::max_logs,
+                                                                               factory<redeem_months>()},
+        {"observe_markets",       "yield.observe",      "swap markets",     0, factory<observe_markets>()},
+    };
+
+    std::vector<cliff_result> results;
+    for (const auto& s : specs) {
+        results.push_back(search(s, opt));
+        const auto& r = results.back();
+        std::cout << std::left << std::setw(24) << s.workload << std::setw(22) << s.action
+                           << std::setw(18) << s.dimension << "breaks at N = "
+                           << (r.breaking_n ? std::to_string(*r.breaking_n) : std::string("none"))
+                           << " (largest probe " << (int64_t)r.curve.back().second << " us @"
+                           << r.curve.back().first << ")\n";
+    }
+    write_report(opt.report, opt, results);
+}
@@ -0,0 +1,138 @@
+/**
+ * Micro-benchmarks of the precision math kernels, per decimals (0, 6, 12, 18).
+ *
+ * The contract kernels are called through sim::kernels, i.e. the exact code
+ * compiled into the contract libraries; a replacement kernel is proven by
+ * math_tests and is expected to beat the numbers here.
+ *
+ *   sim_math_bench [--benchmark_filter=<regex>] [--benchmark_min_time=<s>]
+ */
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <flon/utils.hpp>
+#include <sim/kernels.hpp>
+
+using namespace eosio;
+namespace k = sim::kernels;
+
+namespace {
+
+// a fixed ring of operands, so the optimizer cannot fold the inputs
+struct operands {
+    static constexpr size_t size = 1024;
+    std::vector<int64_t> a, b;
+
+    explicit operands(int bits) {
+        std::mt19937_64 rng(7);
+        for (size_t i = 0; i < size; ++i) {
+            a.push_back(int64_t(rng() >> (64 - bits)) + 1);
+            b.push_back(int64_t(rng() >> (64 - bits)) + 1);
+        }
+    }
+};
+
+void bm_reward_per_share_delta(benchmark::State& state) {
+    const operands o(48);
+    const symbol   rs("SING", state.range(0)), ss("STAAA", state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k::reward_per_share_delta(asset(o.a[i], rs), asset(o.b[i], ss)));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_user_reward(benchmark::State& state) {
+    const operands o(40);
+    const symbol   rs("SING", state.range(0)), ss("STAAA", state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k::user_reward(asset(o.a[i], ss), (int128_t)o.b[i] << 30, rs));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_issue_amount(benchmark::State& state) {
+    const operands o(30);
+    const symbol   gs("SING", state.range(0)), rs("STAAA", 8);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k::issue_amount(asset(o.a[i], gs), asset(o.b[i], rs)));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_refund_amount(benchmark::State& state) {
+    const operands o(40);
+    const symbol   gs("SING", state.range(0)), rs("STAAA", 8);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k::refund_amount(asset(o.a[i], rs), asset(o.a[i] + o.b[i], rs), gs));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_max_supply(benchmark::State& state) {
+    const operands o(30);
+    const symbol   gs("SING", state.range(0)), rs("STAAA", 8);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k::max_supply(asset(o.a[i], gs), 100, asset(o.b[i] % 1000000000 + 1, rs)));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_multiply_decimal(benchmark::State& state) {
+    const operands o(28);
+    const int128_t precision = power10(state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(multiply_decimal64(o.a[i], o.b[i], precision));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_divide_decimal(benchmark::State& state) {
+    const operands o(30);
+    const int128_t precision = power10(state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        // a / b < 0.5 keeps the x10 intermediate inside int64 up to 18 decimals
+        benchmark::DoNotOptimize(divide_decimal64(o.a[i] % (o.b[i] / 2 + 1), o.b[i], precision));
+        i = (i + 1) % operands::size;
+    }
+}
+
+// flon::muldiv with the product below 2^64 (64-bit divide) and above it (int128 divide)
+void bm_muldiv(benchmark::State& state) {
+    const operands o(state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(flon::muldiv(o.a[i], o.b[i], o.a[i] | 1));
+        i = (i + 1) % operands::size;
+    }
+}
+
+void bm_safe_multiply(benchmark::State& state) {
+    const operands o(31);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((safe<int64_t>(o.a[i]) * safe<int64_t>(o.b[i])).value);
+        i = (i + 1) % operands::size;
+    }
+}
+
+} // namespace
+
+BENCHMARK(bm_reward_per_share_delta)->DenseRange(0, 18, 6);
+BENCHMARK(bm_user_reward)->DenseRange(0, 18, 6);
+BENCHMARK(bm_issue_amount)->DenseRange(0, 18, 6);
+BENCHMARK(bm_refund_amount)->DenseRange(0, 18, 6);
+BENCHMARK(bm_max_supply)->DenseRange(0, 18, 6);
+BENCHMARK(bm_multiply_decimal)->DenseRange(0, 18, 6);
+BENCHMARK(bm_divide_decimal)->DenseRange(0, 18, 6);
+BENCHMARK(bm_muldiv)->Arg(31)->Arg(62);
+BENCHMARK(bm_safe_multiply);
+
+BENCHMARK_MAIN();
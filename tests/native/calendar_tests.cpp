@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+#include <ctime>
+
+#include <flon/calendar.hpp>
+
+using namespace flon::calendar;
+
+BOOST_AUTO_TEST_SUITE(calendar_tests)
+
+// walk every day of 1970..2069 with a naive counter and cross check against gmtime
+BOOST_AUTO_TEST_CASE(civil_sweep_100_years) {
+    int32_t  y = 1970;
+    uint32_t m = 1, d = 1;
+
+    for (int64_t day = 0; y < 2070; ++day) {
+        BOOST_REQUIRE_EQUAL(days_from_civil(y, m, d), day);
+
+        const civil_t c = civil_from_days(day);
+        BOOST_REQUIRE_EQUAL(c.year, y);
+        BOOST_REQUIRE_EQUAL(c.month, m);
+        BOOST_REQUIRE_EQUAL(c.day, d);
+
+        for (const int64_t tod : {(int64_t)0, (int64_t)43200, SECONDS_PER_DAY - 1}) {
+            const uint32_t sec = (uint32_t)(day * SECONDS_PER_DAY + tod);
+            const time_t   t   = (time_t)sec;
+            std::tm g{};
+            gmtime_r(&t, &g);
+            BOOST_REQUIRE_EQUAL(to_period(sec), (uint64_t)((g.tm_year + 1900) * 100 + g.tm_mon + 1));
+        }
+
+        if (++d > days_in_month(y, m)) {
+            d = 1;
+            if (++m > 12) { m = 1; ++y; }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(period_arithmetic) {
+    BOOST_CHECK_EQUAL(period_add_months(202501, 0), 202501u);
+    BOOST_CHECK_EQUAL(period_add_months(202512, 1), 202601u);
+    BOOST_CHECK_EQUAL(period_add_months(202601, -1), 202512u);
+    BOOST_CHECK_EQUAL(period_add_months(202511, 120), 203511u);
+
+    for (uint64_t p = 197001; p < 207001; p = period_add_months(p, 1)) {
+        BOOST_REQUIRE_EQUAL(period_from_ordinal(period_ordinal(p)), p);
+        BOOST_REQUIRE(p % 100 >= 1 && p % 100 <= 12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(add_months_clamps_day) {
+    const uint32_t jan31 = (uint32_t)(days_from_civil(2024, 1, 31) * SECONDS_PER_DAY + 3600);
+
+    BOOST_CHECK_EQUAL(add_months(jan31, 1), days_from_civil(2024, 2, 29) * SECONDS_PER_DAY + 3600);
+    BOOST_CHECK_EQUAL(add_months(jan31, 13), days_from_civil(2025, 2, 28) * SECONDS_PER_DAY + 3600);
+    BOOST_CHECK_EQUAL(add_months(jan31, 2), days_from_civil(2024, 3, 31) * SECONDS_PER_DAY + 3600);
+    BOOST_CHECK_EQUAL(add_months(jan31, 0), jan31);
+}
+
+BOOST_AUTO_TEST_CASE(plan_relative_index) {
+    const uint32_t start = 1762746300;   // 2025-11-10T03:45:00Z
+
+    BOOST_CHECK_EQUAL(plan_month_index(start, start), 0);
+    BOOST_CHECK_EQUAL(plan_month_index(start, start - 86400 * 10), -1);
+    BOOST_CHECK_EQUAL(plan_year_index(start, start - 86400 * 10), 0u);
+    BOOST_CHECK_EQUAL(plan_year_index(start, start), 1u);
+
+    BOOST_CHECK_EQUAL(plan_year_first_period(start, 1), 202511u);
+    BOOST_CHECK_EQUAL(plan_year_end_period(start, 1), 202611u);
+    BOOST_CHECK_EQUAL(plan_year_first_period(start, 2), 202611u);
+
+    // every month of a 10 year plan lands in the plan year whose period range contains it
+    for (int64_t i = 0; i < 120; ++i) {
+        const uint32_t now  = add_months(start, i);
+        const uint64_t year = plan_year_index(start, now);
+        BOOST_REQUIRE_EQUAL(plan_month_index(start, now), i);
+        BOOST_REQUIRE_EQUAL(year, (uint64_t)(i / 12 + 1));
+        BOOST_REQUIRE(to_period(now) >= plan_year_first_period(start, year));
+        BOOST_REQUIRE(to_period(now) <  plan_year_end_period(start, year));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
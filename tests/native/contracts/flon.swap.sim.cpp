@@ -0,0 +1,95 @@
+#include <flon.swap/flon.swap.db.hpp>
+#include <flon/flon.token.hpp>
+#include <flon/utils.hpp>
+
+#include <sim/dispatch.hpp>
+
+/**
+ * Minimal constant-product AMM standing in for flon.swap so buybacks can be
+ * exercised natively. Only the market row layout is shared with the real
+ * contract; the memo protocol mirrors what yield.rwa sends:
+ *   deposit:<tpcode>                add liquidity to one side of the pair
+ *   swap:<min asset>:<tpcode>       swap, paying the output back to the sender
+ */
+namespace flon {
+
+class swap : public contract {
+public:
+    using contract::contract;
+
+    void addmarket(const name& tpcode, const extended_symbol& left, const extended_symbol& right,
+                   const uint16_t& fee_ratio)
+    {
+        require_auth(get_self());
+        check(fee_ratio < 10000, "invalid fee ratio");
+
+        market_t::idx_t markets(get_self(), get_self().value);
+        check(markets.find(tpcode.value) == markets.end(), "market already exists");
+        markets.emplace(get_self(), [&](auto& m) {
+            m.tpcode           = tpcode;
+            m.left_pool_quant  = extended_asset(asset(0, left.get_symbol()), left.get_contract());
+            m.right_pool_quant = extended_asset(asset(0, right.get_symbol()), right.get_contract());
+            m.sys_fee_ratio    = fee_ratio;
+            m.lp_fee_ratio     = 0;
+            m.buy_fee_ratio    = fee_ratio;
+            m.sell_fee_ratio   = fee_ratio;
+            m.created_at       = current_time_point();
+            m.updated_at       = m.created_at;
+        });
+    }
+
+    void on_transfer(const name& from, const name& to, const asset& quant, const string& memo)
+    {
+        if (from == get_self() || to != get_self()) return;
+
+        const auto parts = split(memo, ":");
+        check(parts.size() >= 2, "unsupported memo: " + memo);
+
+        market_t::idx_t markets(get_self(), get_self().value);
+        const name tpcode(parts.back());
+        auto itr = markets.require_find(tpcode.value, "market not found");
+
+        const extended_symbol in_sym(quant.symbol, get_first_receiver());
+        const bool is_left = itr->left_pool_quant.get_extended_symbol() == in_sym;
+        check(is_left || itr->right_pool_quant.get_extended_symbol() == in_sym, "input not in pair");
+
+        if (parts[0] == "deposit") {
+            markets.modify(itr, same_payer, [&](auto& m) {
+                (is_left ? m.left_pool_quant : m.right_pool_quant).quantity += quant;
+            });
+            return;
+        }
+
+        check(parts[0] == "swap" && parts.size() == 3, "unsupported memo: " + memo);
+        const asset min_out = asset_from_string(parts[1]);
+
+        const extended_asset& in_pool  = is_left ? itr->left_pool_quant : itr->right_pool_quant;
+        const extended_asset& out_pool = is_left ? itr->right_pool_quant : itr->left_pool_quant;
+        check(min_out.symbol == out_pool.quantity.symbol, "min output symbol mismatch");
+
+        const int128_t in_net = (int128_t)quant.amount * (10000 - itr->sys_fee_ratio) / 10000;
+        const int64_t  out    = (int64_t)(in_net * out_pool.quantity.amount / (in_pool.quantity.amount + in_net));
+        check(out > 0 && out >= min_out.amount, "slippage exceeded");
+
+        const asset          out_quant(out, out_pool.quantity.symbol);
+        const name           out_bank = out_pool.contract;
+        markets.modify(itr, same_payer, [&](auto& m) {
+            (is_left ? m.left_pool_quant : m.right_pool_quant).quantity  += quant;
+            (is_left ? m.right_pool_quant : m.left_pool_quant).quantity -= out_quant;
+            m.updated_at = current_time_point();
+        });
+
+        token::transfer_action act{out_bank, {{get_self(), "active"_n}}};
+        act.send(get_self(), from, out_quant, string("swap"));
+    }
+};
+
+} // namespace flon
+
+SIM_EXPORT void sim_apply_flonswap(uint64_t receiver, uint64_t code, uint64_t action) {
+    using flon::swap;
+    sim::dispatcher<swap>(receiver, code, action)
+        .on_action<&swap::addmarket>("addmarket"_n)
+        .on_notify<&swap::on_transfer>(sim::any_code, "transfer"_n)
+        .finish();
+}
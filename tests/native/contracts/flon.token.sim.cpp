@@ -0,0 +1,182 @@
+#include <flon/flon.token.hpp>
+
+#include <sim/dispatch.hpp>
+
+/**
+ * Native stand-in for the sing.token contract (flon.token), whose sources
+ * are not part of this repository: standard token semantics plus burn and
+ * forcetake as declared in flon/flon.token.hpp.
+ */
+namespace flon {
+
+void token::create( const name& issuer, const asset& maximum_supply )
+{
+    require_auth( get_self() );
+
+    auto sym = maximum_supply.symbol;
+    check( maximum_supply.is_valid(), "invalid supply");
+    check( maximum_supply.amount > 0, "max-supply must be positive");
+
+    stats statstable( get_self(), sym.code().raw() );
+    check( statstable.find( sym.code().raw() ) == statstable.end(), "token with symbol already exists" );
+
+    statstable.emplace( get_self(), [&]( auto& s ) {
+       s.supply.symbol = maximum_supply.symbol;
+       s.max_supply    = maximum_supply;
+       s.issuer        = issuer;
+    });
+}
+
+void token::issue( const name& to, const asset& quantity, const string& memo )
+{
+    check( memo.size() <= 256, "memo has more than 256 bytes" );
+
+    stats statstable( get_self(), quantity.symbol.code().raw() );
+    const auto& st = statstable.get( quantity.symbol.code().raw(), "token with symbol does not exist, create token before issue" );
+    check( to == st.issuer, "tokens can only be issued to issuer account" );
+
+    require_auth( st.issuer );
+    check( quantity.is_valid(), "invalid quantity" );
+    check( quantity.amount > 0, "must issue positive quantity" );
+    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
+    check( quantity.amount <= st.max_supply.amount - st.supply.amount, "quantity exceeds available supply");
+
+    statstable.modify( st, same_payer, [&]( auto& s ) {
+       s.supply += quantity;
+    });
+    add_balance( st.issuer, quantity, st.issuer );
+}
+
+void token::retire( const asset& quantity, const string& memo )
+{
+    stats statstable( get_self(), quantity.symbol.code().raw() );
+    const auto& st = statstable.get( quantity.symbol.code().raw(), "token with symbol does not exist" );
+
+    require_auth( st.issuer );
+    check( quantity.is_valid(), "invalid quantity" );
+    check( quantity.amount > 0, "must retire positive quantity" );
+    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
+
+    statstable.modify( st, same_payer, [&]( auto& s ) {
+       s.supply -= quantity;
+    });
+    sub_balance( st.issuer, quantity );
+}
+
+void token::burn( const name& owner, const asset& quantity, const string& memo )
+{
+    require_auth( owner );
+
+    stats statstable( get_self(), quantity.symbol.code().raw() );
+    const auto& st = statstable.get( quantity.symbol.code().raw(), "token with symbol does not exist" );
+    check( quantity.is_valid() && quantity.amount > 0, "must burn positive quantity" );
+    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
+
+    statstable.modify( st, same_payer, [&]( auto& s ) {
+       s.supply -= quantity;
+    });
+    sub_balance( owner, quantity );
+}
+
+void token::transfer( const name& from, const name& to, const asset& quantity, const string& memo )
+{
+    check( from != to, "cannot transfer to self" );
+    require_auth( from );
+    check( is_account( to ), "to account does not exist");
+
+    stats statstable( get_self(), quantity.symbol.code().raw() );
+    const auto& st = statstable.get( quantity.symbol.code().raw() );
+
+    require_recipient( from );
+    require_recipient( to );
+
+    check( quantity.is_valid(), "invalid quantity" );
+    check( quantity.amount > 0, "must transfer positive quantity" );
+    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
+    check( memo.size() <= 256, "memo has more than 256 bytes" );
+
+    auto payer = has_auth( to ) ? to : from;
+    sub_balance( from, quantity );
+    add_balance( to, quantity, payer );
+}
+
+void token::forcetake( const name& from, const asset& quantity, const string& memo )
+{
+    stats statstable( get_self(), quantity.symbol.code().raw() );
+    const auto& st = statstable.get( quantity.symbol.code().raw(), "token with symbol does not exist" );
+    require_auth( st.issuer );
+    check( quantity.is_valid() && quantity.amount > 0, "must take positive quantity" );
+
+    require_recipient( from );
+    sub_balance( from, quantity );
+    add_balance( st.issuer, quantity, st.issuer );
+}
+
+void token::open( const name& owner, const symbol& symbol, const name& ram_payer )
+{
+    require_auth( ram_payer );
+    check( is_account( owner ), "owner account does not exist" );
+
+    stats statstable( get_self(), symbol.code().raw() );
+    const auto& st = statstable.get( symbol.code().raw(), "symbol does not exist" );
+    check( st.supply.symbol == symbol, "symbol precision mismatch" );
+
+    accounts acnts( get_self(), owner.value );
+    if( acnts.find( symbol.code().raw() ) == acnts.end() ) {
+       acnts.emplace( ram_payer, [&]( auto& a ){
+         a.balance = asset{0, symbol};
+       });
+    }
+}
+
+void token::close( const name& owner, const symbol& symbol )
+{
+    require_auth( owner );
+    accounts acnts( get_self(), owner.value );
+    auto it = acnts.find( symbol.code().raw() );
+    check( it != acnts.end(), "Balance row already deleted or never existed. Action won't have any effect." );
+    check( it->balance.amount == 0, "Cannot close because the balance is not zero." );
+    acnts.erase( it );
+}
+
+void token::sub_balance( const name& owner, const asset& value )
+{
+    accounts from_acnts( get_self(), owner.value );
+    const auto& from = from_acnts.get( value.symbol.code().raw(), "no balance object found" );
+    check( from.balance.amount >= value.amount, "overdrawn balance" );
+
+    from_acnts.modify( from, same_payer, [&]( auto& a ) {
+       a.balance -= value;
+    });
+}
+
+void token::add_balance( const name& owner, const asset& value, const name& ram_payer )
+{
+    accounts to_acnts( get_self(), owner.value );
+    auto to = to_acnts.find( value.symbol.code().raw() );
+    if( to == to_acnts.end() ) {
+       to_acnts.emplace( ram_payer, [&]( auto& a ){
+         a.balance = value;
+       });
+    } else {
+       to_acnts.modify( to, same_payer, [&]( auto& a ) {
+         a.balance += value;
+       });
+    }
+}
+
+} // namespace flon
+
+SIM_EXPORT void sim_apply_flontoken(uint64_t receiver, uint64_t code, uint64_t action) {
+    using flon::token;
+    sim::dispatcher<token>(receiver, code, action)
+        .on_action<&token::create>("create"_n)
+        .on_action<&token::issue>("issue"_n)
+        .on_action<&token::retire>("retire"_n)
+        .on_action<&token::burn>("burn"_n)
+        .on_action<&token::transfer>("transfer"_n)
+        .on_action<&token::forcetake>("forcetake"_n)
+        .on_action<&token::open>("open"_n)
+        .on_action<&token::close>("close"_n)
+        .finish();
+}
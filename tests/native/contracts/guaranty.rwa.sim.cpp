@@ -0,0 +1,26 @@
+#include "guarantyrwa.cpp"
+
+#include <sim/dispatch.hpp>
+
+SIM_EXPORT void sim_apply_guarantyrwa(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwafi::guarantyrwa;
+    sim::dispatcher<guarantyrwa>(receiver, code, action)
+        .on_action<&guarantyrwa::init>("init"_n)
+        .on_action<&guarantyrwa::guarantpay>("guarantpay"_n)
+        .on_action<&guarantyrwa::redeem>("redeem"_n)
+        .on_action<&guarantyrwa::addyield>("addyield"_n)
+        .on_action<&guarantyrwa::addyields>("addyields"_n)
+        .on_action<&guarantyrwa::crank>("crank"_n)
+        .on_action<&guarantyrwa::setkeeper>("setkeeper"_n)
+        .on_action<&guarantyrwa::settranches>("settranches"_n)
+        .on_action<&guarantyrwa::migrateconf>("migrateconf"_n)
+        .on_action<&guarantyrwa::migratestats>("migratestats"_n)
+        .on_action<&guarantyrwa::migratestake>("migratestake"_n)
+        .on_action<&guarantyrwa::migratebal>("migratebal"_n)
+        .on_action<&guarantyrwa::synccover>("synccover"_n)
+        .on_action<&guarantyrwa::openshares>("openshares"_n)
+        .on_notify<&guarantyrwa::on_transfer>(sim::any_code, "transfer"_n)
+        .on_notify<&guarantyrwa::on_move>(flon::VAULT_POOL, "move"_n)
+        .on_notify<&guarantyrwa::on_movebatch>(flon::VAULT_POOL, "movebatch"_n)
+        .finish();
+}
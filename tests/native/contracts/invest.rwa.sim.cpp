@@ -0,0 +1,44 @@
+#include "investrwa.cpp"
+
+#include <sim/dispatch.hpp>
+#include <sim/kernels.hpp>
+
+SIM_EXPORT void sim_apply_investrwa(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwafi::investrwa;
+    sim::dispatcher<investrwa>(receiver, code, action)
+        .on_action<&investrwa::init>("init"_n)
+        .on_action<&investrwa::addtoken>("addtoken"_n)
+        .on_action<&investrwa::deltoken>("deltoken"_n)
+        .on_action<&investrwa::onshelf>("onshelf"_n)
+        .on_action<&investrwa::createplan>("createplan"_n)
+        .on_action<&investrwa::cancelplan>("cancelplan"_n)
+        .on_action<&investrwa::setallowlist>("setallowlist"_n)
+        .on_action<&investrwa::prove>("prove"_n)
+        .on_action<&investrwa::crank>("crank"_n)
+        .on_action<&investrwa::setkeeper>("setkeeper"_n)
+        .on_action<&investrwa::migrateconf>("migrateconf"_n)
+        .on_action<&investrwa::migrateplans>("migrateplans"_n)
+        .on_notify<&investrwa::on_transfer>(sim::any_code, "transfer"_n)
+        .finish();
+}
+
+namespace sim { namespace kernels {
+
+int64_t issue_amount(const eosio::asset& accepted, const eosio::asset& receipt_per_unit) {
+    return rwafi::investrwa::calc_issue_amount(accepted, receipt_per_unit);
+}
+
+int64_t refund_amount(const eosio::asset& receipts, const eosio::asset& receipt_per_unit,
+                      const eosio::symbol& goal_symbol) {
+    return rwafi::investrwa::calc_refund_amount(receipts, receipt_per_unit, goal_symbol);
+}
+
+int64_t cap_amount(const eosio::asset& goal_quantity, uint8_t cap_percent) {
+    return rwafi::investrwa::calc_cap_amount(goal_quantity, cap_percent);
+}
+
+int64_t max_supply(const eosio::asset& goal_quantity, uint8_t hard_cap_percent, const eosio::asset& receipt_per_unit) {
+    return rwafi::investrwa::calc_max_supply(goal_quantity, hard_cap_percent, receipt_per_unit);
+}
+
+}} // namespace sim::kernels
@@ -0,0 +1,54 @@
+#include <rwafihub.hpp>
+
+#include <sim/dispatch.hpp>
+
+// the module sources are compiled into the same library from contracts/rwafi.hub/src
+SIM_EXPORT void sim_apply_rwafihub(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwahub::rwafihub;
+    sim::dispatcher<rwafihub>(receiver, code, action)
+        .on_action<&rwafihub::init>("init"_n)
+        .on_action<&rwafihub::crank>("crank"_n)
+        .on_action<&rwafihub::setkeeper>("setkeeper"_n)
+        .on_action<&rwafihub::addtoken>("addtoken"_n)
+        .on_action<&rwafihub::deltoken>("deltoken"_n)
+        .on_action<&rwafihub::onshelf>("onshelf"_n)
+        .on_action<&rwafihub::createplan>("createplan"_n)
+        .on_action<&rwafihub::cancelplan>("cancelplan"_n)
+        .on_action<&rwafihub::setallowlist>("setallowlist"_n)
+        .on_action<&rwafihub::prove>("prove"_n)
+        .on_action<&rwafihub::addplan>("addplan"_n)
+        .on_action<&rwafihub::delplan>("delplan"_n)
+        .on_action<&rwafihub::claim>("claim"_n)
+        .on_action<&rwafihub::claimfor>("claimfor"_n)
+        .on_action<&rwafihub::setoperator>("setoperator"_n)
+        .on_action<&rwafihub::deloperator>("deloperator"_n)
+        .on_action<&rwafihub::grantclaim>("grantclaim"_n)
+        .on_action<&rwafihub::revokeclaim>("revokeclaim"_n)
+        .on_action<&rwafihub::unstake>("unstake"_n)
+        .on_action<&rwafihub::batchunstake>("batchunstake"_n)
+        .on_action<&rwafihub::setsplit>("setsplit"_n)
+        .on_action<&rwafihub::delsplit>("delsplit"_n)
+        .on_action<&rwafihub::buyback>("buyback"_n)
+        .on_action<&rwafihub::setslippage>("setslippage"_n)
+        .on_action<&rwafihub::setchunk>("setchunk"_n)
+        .on_action<&rwafihub::observe>("observe"_n)
+        .on_action<&rwafihub::settwap>("settwap"_n)
+        .on_action<&rwafihub::migratelogs>("migratelogs"_n)
+        .on_action<&rwafihub::migratebuys>("migratebuys"_n)
+        .on_action<&rwafihub::migrateconf>("migrateconf"_n)
+        .on_action<&rwafihub::distribute>("distribute"_n)
+        .on_action<&rwafihub::flush>("flush"_n)
+        .on_action<&rwafihub::setflush>("setflush"_n)
+        .on_action<&rwafihub::logyield>("logyield"_n)
+        .on_action<&rwafihub::guarantpay>("guarantpay"_n)
+        .on_action<&rwafihub::redeem>("redeem"_n)
+        .on_action<&rwafihub::addyield>("addyield"_n)
+        .on_action<&rwafihub::addyields>("addyields"_n)
+        .on_action<&rwafihub::settranches>("settranches"_n)
+        .on_action<&rwafihub::migratestats>("migratestats"_n)
+        .on_action<&rwafihub::migratestake>("migratestake"_n)
+        .on_action<&rwafihub::synccover>("synccover"_n)
+        .on_action<&rwafihub::openshares>("openshares"_n)
+        .on_notify<&rwafihub::on_transfer>(sim::any_code, "transfer"_n)
+        .finish();
+}
@@ -0,0 +1,17 @@
+#include "rwafi.token.cpp"
+
+#include <sim/dispatch.hpp>
+
+SIM_EXPORT void sim_apply_rwafitoken(uint64_t receiver, uint64_t code, uint64_t action) {
+    using eosio::token;
+    sim::dispatcher<token>(receiver, code, action)
+        .on_action<&token::create>("create"_n)
+        .on_action<&token::issue>("issue"_n)
+        .on_action<&token::retire>("retire"_n)
+        .on_action<&token::transfer>("transfer"_n)
+        .on_action<&token::transferbatch>("transferbatch"_n)
+        .on_action<&token::open>("open"_n)
+        .on_action<&token::close>("close"_n)
+        .on_action<&token::checkpoint>("checkpoint"_n)
+        .finish();
+}
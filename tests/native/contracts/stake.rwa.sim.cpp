@@ -0,0 +1,43 @@
+#include "stakerwa.cpp"
+
+#include <sim/dispatch.hpp>
+#include <sim/kernels.hpp>
+
+SIM_EXPORT void sim_apply_stakerwa(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwafi::stakerwa;
+    sim::dispatcher<stakerwa>(receiver, code, action)
+        .on_action<&stakerwa::init>("init"_n)
+        .on_action<&stakerwa::addplan>("addplan"_n)
+        .on_action<&stakerwa::delplan>("delplan"_n)
+        .on_action<&stakerwa::claim>("claim"_n)
+        .on_action<&stakerwa::claimfor>("claimfor"_n)
+        .on_action<&stakerwa::setoperator>("setoperator"_n)
+        .on_action<&stakerwa::deloperator>("deloperator"_n)
+        .on_action<&stakerwa::grantclaim>("grantclaim"_n)
+        .on_action<&stakerwa::revokeclaim>("revokeclaim"_n)
+        .on_action<&stakerwa::unstake>("unstake"_n)
+        .on_action<&stakerwa::batchunstake>("batchunstake"_n)
+        .on_action<&stakerwa::crank>("crank"_n)
+        .on_action<&stakerwa::setkeeper>("setkeeper"_n)
+        .on_action<&stakerwa::migrateconf>("migrateconf"_n)
+        .on_action<&stakerwa::migratepools>("migratepools"_n)
+        .on_action<&stakerwa::migratebal>("migratebal"_n)
+        .on_notify<&stakerwa::on_transfer_rwafi>(flon::RECEIPT_BANK, "transfer"_n)
+        .on_notify<&stakerwa::on_transfer_reward>(flon::SING_BANK, "transfer"_n)
+        .on_notify<&stakerwa::on_move>(flon::VAULT_POOL, "move"_n)
+        .on_notify<&stakerwa::on_movebatch>(flon::VAULT_POOL, "movebatch"_n)
+        .finish();
+}
+
+namespace sim { namespace kernels {
+
+int128_t reward_per_share_delta(const eosio::asset& rewards, const eosio::asset& total_staked) {
+    return rwafi::stakerwa::calc_reward_per_share_delta(rewards, total_staked);
+}
+
+eosio::asset user_reward(const eosio::asset& staked, const int128_t& reward_per_share_delta,
+                         const eosio::symbol& reward_symbol) {
+    return rwafi::stakerwa::calc_user_reward(staked, reward_per_share_delta, reward_symbol);
+}
+
+}} // namespace sim::kernels
@@ -0,0 +1,14 @@
+#include "vaultrwa.cpp"
+
+#include <sim/dispatch.hpp>
+
+SIM_EXPORT void sim_apply_vaultrwa(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwafi::vaultrwa;
+    sim::dispatcher<vaultrwa>(receiver, code, action)
+        .on_action<&vaultrwa::init>("init"_n)
+        .on_action<&vaultrwa::move>("move"_n)
+        .on_action<&vaultrwa::movebatch>("movebatch"_n)
+        .on_action<&vaultrwa::withdraw>("withdraw"_n)
+        .on_notify<&vaultrwa::on_transfer>(sim::any_code, "transfer"_n)
+        .finish();
+}
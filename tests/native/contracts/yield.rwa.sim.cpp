@@ -0,0 +1,30 @@
+#include "yieldrwa.cpp"
+
+#include <sim/dispatch.hpp>
+
+SIM_EXPORT void sim_apply_yieldrwa(uint64_t receiver, uint64_t code, uint64_t action) {
+    using rwafi::yieldrwa;
+    sim::dispatcher<yieldrwa>(receiver, code, action)
+        .on_action<&yieldrwa::init>("init"_n)
+        .on_action<&yieldrwa::setsplit>("setsplit"_n)
+        .on_action<&yieldrwa::delsplit>("delsplit"_n)
+        .on_action<&yieldrwa::buyback>("buyback"_n)
+        .on_action<&yieldrwa::setslippage>("setslippage"_n)
+        .on_action<&yieldrwa::setchunk>("setchunk"_n)
+        .on_action<&yieldrwa::crank>("crank"_n)
+        .on_action<&yieldrwa::observe>("observe"_n)
+        .on_action<&yieldrwa::settwap>("settwap"_n)
+        .on_action<&yieldrwa::setkeeper>("setkeeper"_n)
+        .on_action<&yieldrwa::migratelogs>("migratelogs"_n)
+        .on_action<&yieldrwa::migratebuys>("migratebuys"_n)
+        .on_action<&yieldrwa::migrateconf>("migrateconf"_n)
+        .on_action<&yieldrwa::migratebal>("migratebal"_n)
+        .on_action<&yieldrwa::distribute>("distribute"_n)
+        .on_action<&yieldrwa::flush>("flush"_n)
+        .on_action<&yieldrwa::setflush>("setflush"_n)
+        .on_action<&yieldrwa::setcoverage>("setcoverage"_n)
+        .on_action<&yieldrwa::logyield>("logyield"_n)
+        .on_notify<&yieldrwa::on_transfer>(flon::SING_BANK, "transfer"_n)
+        .on_notify<&yieldrwa::on_voucher>(flon::RECEIPT_BANK, "transfer"_n)
+        .finish();
+}
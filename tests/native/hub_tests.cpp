@@ -0,0 +1,172 @@
+#include "rwafi_fixture.hpp"
+
+#include <investrwadb.hpp>
+#include <rwafihubdb.hpp>
+
+using namespace rwafi_sim;
+
+namespace {
+
+const name HUB = "rwafi.hub"_n;
+
+/**
+ * invest / stake / yield / guaranty deployed as the single rwafi.hub contract,
+ * with the rwafi.token build whose issuer is the hub.
+ */
+struct hub_fixture {
+    sim::chain  chain;
+
+    const name  admin       = "admin"_n;
+    const name  creator     = "creator"_n;
+    const name  keeper      = "keeper"_n;
+    const name  alice       = "alice"_n;
+    const name  bob         = "bob"_n;
+
+    hub_fixture() {
+        chain.deploy(HUB,                 sim_apply_rwafihub);
+        chain.deploy(flon::RECEIPT_BANK,  sim_apply_rwafitoken_hub);
+        chain.deploy(flon::SING_BANK,     sim_apply_flontoken);
+        chain.deploy(flon::SWAP_POOL,     sim_apply_flonswap);
+
+        for (auto a : {admin, creator, keeper, alice, bob})
+            chain.create_account(a);
+
+        REQUIRE_OK(chain.push(flon::SING_BANK, "create"_n, flon::SING_BANK, admin, sing(1e9)));
+        REQUIRE_OK(chain.push(flon::SING_BANK, "issue"_n, admin, admin, sing(1e8), "genesis"));
+        REQUIRE_OK(transfer(flon::SING_BANK, admin, alice, sing(10000), "fund"));
+        REQUIRE_OK(transfer(flon::SING_BANK, admin, bob, sing(10000), "fund"));
+
+        REQUIRE_OK(chain.push(HUB, "init"_n, HUB, admin));
+        REQUIRE_OK(chain.push(HUB, "addtoken"_n, admin, flon::SING_BANK, flon::SING_SYM));
+    }
+
+    std::string transfer(name bank, name from, name to, const asset& quantity, const std::string& memo) {
+        return chain.push(bank, "transfer"_n, from, from, to, quantity, memo);
+    }
+
+    asset balance(name bank, name owner, const symbol& sym) const {
+        flon::token::accounts accts(bank, owner.value);
+        auto it = accts.find(sym.code().raw());
+        return it == accts.end() ? asset(0, sym) : it->balance;
+    }
+
+    std::string create_plan(const symbol& receipt, const asset& goal, uint32_t raise_seconds) {
+        const time_point start = chain.now();
+        const time_point end   = chain.now() + raise_seconds;
+        return chain.push(HUB, "createplan"_n, creator,
+                          creator, std::string("plan"), flon::SING_BANK, goal,
+                          flon::RECEIPT_BANK, asset(100000000, receipt),
+                          (uint8_t)80, (uint8_t)100, start, end,
+                          (uint16_t)12, (uint32_t)800);
+    }
+
+    rwafi::fundplan_t plan(uint64_t id) const {
+        rwafi::fundplan_t::idx_t plans(HUB, HUB.value);
+        return plans.get(id, "plan not found");
+    }
+
+    rwahub::pool_move_t moved(name route, const symbol& sym) const {
+        rwahub::pool_move_t::idx_t moves(HUB, route.value);
+        return moves.get(sym.code().raw(), "no move booked");
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(hub_tests)
+
+BOOST_FIXTURE_TEST_CASE(raise_yield_and_claim_through_hub, hub_fixture) {
+    const symbol st1 = rwafi_fixture::receipt_sym(1);
+    REQUIRE_OK(create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, HUB, sing(500), "invest/plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, HUB, sing(400), "invest/plan:1"));
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::SUCCESS);
+
+    // receipts stay on the hub account: the stake pool only books them
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, HUB, st1), asset(90000000000, st1));
+    BOOST_CHECK_EQUAL(moved(rwahub::INVEST_TO_STAKE, st1).moved.quantity, asset(90000000000, st1));
+    BOOST_CHECK_EQUAL(moved(rwahub::INVEST_TO_STAKE, st1).count, 2u);
+
+    chain.produce(30 * flon::DAY_SECONDS);
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, HUB, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(moved(rwahub::YIELD_TO_STAKE, flon::SING_SYM).moved, extended_asset(sing(80), flon::SING_BANK));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, HUB, flon::SING_SYM), sing(1000));
+
+    const asset before = balance(flon::SING_BANK, alice, flon::SING_SYM);
+    REQUIRE_OK(chain.push(HUB, "claim"_n, alice, alice, (uint64_t)1));
+    const asset got = balance(flon::SING_BANK, alice, flon::SING_SYM) - before;
+    BOOST_CHECK_LE(std::abs(got.amount - sing(80.0 * 500 / 900).amount), 1);
+
+    REQUIRE_OK(chain.push(HUB, "unstake"_n, bob, bob, (uint64_t)1, asset(10000000000, st1)));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, st1), asset(10000000000, st1));
+}
+
+BOOST_FIXTURE_TEST_CASE(raise_failure_refunds_through_hub_crank, hub_fixture) {
+    const symbol st1 = rwafi_fixture::receipt_sym(1);
+    REQUIRE_OK(create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, HUB, sing(100), "invest/plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, HUB, sing(50), "invest/plan:1"));
+
+    chain.produce(7 * flon::DAY_SECONDS + 1);
+    REQUIRE_FAIL(chain.push(HUB, "crank"_n, keeper, keeper, "bogus"_n, (uint16_t)5), "unknown pool");
+    REQUIRE_OK(chain.push(HUB, "crank"_n, keeper, keeper, rwahub::INVEST, (uint16_t)5));
+
+    // crank → batchunstake (inline) → refund booked on stake.invest → SING back to investors
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::REFUNDED);
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, bob, flon::SING_SYM), sing(10000));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, HUB, st1).amount, 0);
+    BOOST_CHECK_EQUAL(moved(rwahub::STAKE_TO_INVEST, st1).moved.quantity, asset(15000000000, st1));
+    BOOST_CHECK_EQUAL(moved(rwahub::STAKE_TO_INVEST, st1).count, 2u);
+}
+
+BOOST_FIXTURE_TEST_CASE(memo_needs_pool_prefix, hub_fixture) {
+    REQUIRE_OK(create_plan(rwafi_fixture::receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, HUB, sing(10), "plan:1"), "memo must be <pool>/<memo>");
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, HUB, sing(10), "swap/plan:1"), "unknown pool");
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+}
+
+// a batched distribution books one yield -> stake move for all plans
+BOOST_FIXTURE_TEST_CASE(batched_distribution_books_once, hub_fixture) {
+    for (uint64_t id = 1; id <= 2; ++id) {
+        REQUIRE_OK(create_plan(rwafi_fixture::receipt_sym(id), sing(1000), 7 * flon::DAY_SECONDS));
+        REQUIRE_OK(transfer(flon::SING_BANK, alice, HUB, sing(900), "invest/plan:" + std::to_string(id)));
+    }
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, HUB, sing(200), "yield/credit"));
+    REQUIRE_OK(chain.push(HUB, "distribute"_n, admin, admin,
+                          std::vector<flon::plan_alloc_t>{{1, sing(100)}, {2, sing(100)}}));
+
+    const auto m = moved(rwahub::YIELD_TO_STAKE, flon::SING_SYM);
+    BOOST_CHECK_EQUAL(m.moved, extended_asset(sing(160), flon::SING_BANK));
+    BOOST_CHECK_EQUAL(m.count, 1u);
+}
+
+// the investment and yield hops between pools no longer go through rwafi.token / sing.token
+BOOST_AUTO_TEST_CASE(fewer_actions_than_split_deployment) {
+    const symbol st1 = rwafi_fixture::receipt_sym(1);
+    size_t split_invest = 0, split_yield = 0;
+    {
+        rwafi_fixture f;
+        f.create_account("alice"_n, sing(10000));
+        REQUIRE_OK(f.create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+        REQUIRE_OK(f.transfer(flon::SING_BANK, "alice"_n, flon::INVEST_POOL, sing(900), "plan:1"));
+        split_invest = f.chain.traces().size();
+        REQUIRE_OK(f.transfer(flon::SING_BANK, f.admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+        split_yield = f.chain.traces().size();
+    }
+
+    hub_fixture h;
+    REQUIRE_OK(h.create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(h.transfer(flon::SING_BANK, h.alice, HUB, sing(900), "invest/plan:1"));
+    const size_t hub_invest = h.chain.traces().size();
+    REQUIRE_OK(h.transfer(flon::SING_BANK, h.admin, HUB, sing(100), "yield/plan:1"));
+    const size_t hub_yield = h.chain.traces().size();
+
+    BOOST_TEST_MESSAGE("invest: " << split_invest << " -> " << hub_invest
+                       << " actions, yield: " << split_yield << " -> " << hub_yield);
+    BOOST_CHECK_LT(hub_invest, split_invest);
+    BOOST_CHECK_LT(hub_yield, split_yield);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <eosio/check.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/permission.hpp>
+
+namespace eosio {
+
+inline void require_auth(name n)         { sim::host::require_auth(n.value); }
+inline bool has_auth(name n)             { return sim::host::has_auth(n.value); }
+inline void require_recipient(name n)    { sim::host::require_recipient(n.value); }
+
+template<typename... Accounts>
+void require_recipient(name n, Accounts... remaining) {
+    require_recipient(n);
+    require_recipient(remaining...);
+}
+
+inline void require_auth(const permission_level& level) { require_auth(level.actor); }
+
+/**
+ * An action ready to be sent inline. Payload is the packed argument tuple.
+ */
+struct action {
+    eosio::name                   account;
+    eosio::name                   name;
+    std::vector<permission_level> authorization;
+    std::vector<char>             data;
+
+    action() = default;
+
+    template<typename... Ts>
+    action(const permission_level& auth, eosio::name a, eosio::name n, const std::tuple<Ts...>& value)
+        : account(a), name(n), authorization(1, auth), data(pack_args(value)) {}
+
+    template<typename... Ts>
+    action(std::vector<permission_level> auths, eosio::name a, eosio::name n, const std::tuple<Ts...>& value)
+        : account(a), name(n), authorization(std::move(auths)), data(pack_args(value)) {}
+
+    template<typename Tuple>
+    static std::vector<char> pack_args(const Tuple& t) {
+        datastream<size_t> ps;
+        std::apply([&](const auto&... v) { (ps << ... << v); }, t);
+        std::vector<char> out(ps.tellp());
+        datastream<char*> ds(out.data(), out.size());
+        std::apply([&](const auto&... v) { (ds << ... << v); }, t);
+        return out;
+    }
+
+    void send() const {
+        std::vector<std::pair<uint64_t, uint64_t>> auth;
+        for (const auto& p : authorization) auth.emplace_back(p.actor.value, p.permission.value);
+        sim::host::send_inline(account.value, name.value, auth, data);
+    }
+};
+
+namespace _action_detail {
+    template<typename T>
+    struct member_args;
+
+    template<typename C, typename R, typename... Args>
+    struct member_args<R (C::*)(Args...)> {
+        using type = std::tuple<std::decay_t<Args>...>;
+    };
+    template<typename C, typename R, typename... Args>
+    struct member_args<R (C::*)(Args...) const> {
+        using type = std::tuple<std::decay_t<Args>...>;
+    };
+}
+
+/**
+ * Typed wrapper of an action of another (or the same) contract; arguments are
+ * converted to the declared parameter types before being packed.
+ */
+template<name::raw Name, auto Action>
+struct action_wrapper {
+    using args_type = typename _action_detail::member_args<decltype(Action)>::type;
+
+    template<typename Code>
+    action_wrapper(Code&& code, std::vector<permission_level>&& perms)
+        : code_name(std::forward<Code>(code)), permissions(std::move(perms)) {}
+
+    template<typename Code>
+    action_wrapper(Code&& code, const std::vector<permission_level>& perms)
+        : code_name(std::forward<Code>(code)), permissions(perms) {}
+
+    template<typename Code>
+    action_wrapper(Code&& code, const permission_level& perm)
+        : code_name(std::forward<Code>(code)), permissions(1, perm) {}
+
+    static constexpr eosio::name action_name = eosio::name(Name);
+
+    template<typename... Args>
+    action to_action(Args&&... args) const {
+        static_assert(sizeof...(Args) == std::tuple_size_v<args_type>, "wrong number of action arguments");
+        return action(permissions, code_name, action_name, args_type(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    void send(Args&&... args) const {
+        to_action(std::forward<Args>(args)...).send();
+    }
+
+    eosio::name                   code_name;
+    std::vector<permission_level> permissions;
+};
+
+} // namespace eosio
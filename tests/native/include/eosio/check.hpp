@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <sim/host.hpp>
+
+typedef __int128            int128_t;
+typedef unsigned __int128   uint128_t;
+
+namespace eosio {
+
+inline void check(bool pred, const char* msg) {
+    if (!pred) sim::host::abort(msg);
+}
+
+inline void check(bool pred, const std::string& msg) {
+    if (!pred) sim::host::abort(msg);
+}
+
+inline void check(bool pred, std::string_view msg) {
+    if (!pred) sim::host::abort(std::string(msg));
+}
+
+} // namespace eosio
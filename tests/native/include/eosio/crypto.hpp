@@ -0,0 +1,14 @@
+#pragma once
+
+#include <eosio/fixed_bytes.hpp>
+#include <sim/host.hpp>
+
+namespace eosio {
+
+inline checksum256 sha256(const char* data, uint32_t length) {
+    checksum256 r;
+    sim::host::sha256(data, length, r.data());
+    return r;
+}
+
+} // namespace eosio
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <eosio/check.hpp>
+
+namespace eosio {
+
+/**
+ * Byte stream used by the abi serializer; mirrors the CDT class so that
+ * EOSLIB_SERIALIZE bodies and hand written operators work unchanged.
+ */
+template<typename T>
+class datastream {
+public:
+    datastream(T start, size_t s) : _start(start), _pos(start), _end(start + s) {}
+
+    void skip(size_t s) { _pos += s; }
+
+    bool read(char* d, size_t s) {
+        check(size_t(_end - _pos) >= s, "datastream attempted to read past the end");
+        std::memcpy(d, _pos, s);
+        _pos += s;
+        return true;
+    }
+
+    bool write(const char* d, size_t s) {
+        check(size_t(_end - _pos) >= s, "datastream attempted to write past the end");
+        std::memcpy((void*)_pos, d, s);
+        _pos += s;
+        return true;
+    }
+
+    bool write(char c) { return write(&c, 1); }
+
+    T       pos() const       { return _pos; }
+    bool    valid() const     { return _pos <= _end && _pos >= _start; }
+    size_t  tellp() const     { return size_t(_pos - _start); }
+    size_t  remaining() const { return size_t(_end - _pos); }
+
+private:
+    T _start;
+    T _pos;
+    T _end;
+};
+
+// size counting stream
+template<>
+class datastream<size_t> {
+public:
+    datastream(size_t init_size = 0) : _size(init_size) {}
+    bool   skip(size_t s)               { _size += s; return true; }
+    bool   write(const char*, size_t s) { _size += s; return true; }
+    bool   write(char)                  { ++_size; return true; }
+    size_t tellp() const                { return _size; }
+    size_t remaining() const            { return 0; }
+private:
+    size_t _size;
+};
+
+template<typename T>
+struct is_datastream : std::false_type {};
+template<typename T>
+struct is_datastream<datastream<T>> : std::true_type {};
+
+struct unsigned_int {
+    uint32_t value = 0;
+    unsigned_int(uint32_t v = 0) : value(v) {}
+    operator uint32_t() const { return value; }
+};
+
+template<typename Stream>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const unsigned_int& v) {
+    uint64_t val = v.value;
+    do {
+        uint8_t b = uint8_t(val) & 0x7f;
+        val >>= 7;
+        b |= ((val > 0) << 7);
+        ds.write((char)b);
+    } while (val);
+    return ds;
+}
+
+template<typename Stream>
+datastream<Stream>& operator>>(datastream<Stream>& ds, unsigned_int& vi) {
+    uint64_t v = 0; char b = 0; uint8_t by = 0;
+    do {
+        ds.read(&b, 1);
+        v |= uint32_t(uint8_t(b) & 0x7f) << by;
+        by += 7;
+    } while (uint8_t(b) & 0x80 && by < 32);
+    vi.value = static_cast<uint32_t>(v);
+    return ds;
+}
+
+namespace _datastream_detail {
+    template<typename T>
+    constexpr bool is_primitive = std::is_arithmetic_v<T> || std::is_enum_v<T>
+                               || std::is_same_v<T, __int128> || std::is_same_v<T, unsigned __int128>;
+
+    template<typename T>
+    struct is_std_array : std::false_type {};
+    template<typename T, size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+}
+
+template<typename Stream, typename T, std::enable_if_t<_datastream_detail::is_primitive<T>>* = nullptr>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const T& v) {
+    ds.write((const char*)&v, sizeof(T));
+    return ds;
+}
+
+template<typename Stream, typename T, std::enable_if_t<_datastream_detail::is_primitive<T>>* = nullptr>
+datastream<Stream>& operator>>(datastream<Stream>& ds, T& v) {
+    ds.read((char*)&v, sizeof(T));
+    return ds;
+}
+
+template<typename Stream>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::string& v) {
+    ds << unsigned_int(v.size());
+    if (!v.empty()) ds.write(v.data(), v.size());
+    return ds;
+}
+
+template<typename Stream>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::string& v) {
+    unsigned_int s;
+    ds >> s;
+    v.resize(s.value);
+    if (s.value) ds.read(v.data(), s.value);
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::vector<T>& v) {
+    ds << unsigned_int(v.size());
+    for (const auto& i : v) ds << i;
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::vector<T>& v) {
+    unsigned_int s;
+    ds >> s;
+    v.clear();
+    v.resize(s.value);
+    for (auto& i : v) ds >> i;
+    return ds;
+}
+
+template<typename Stream, typename T, size_t N>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::array<T, N>& v) {
+    for (const auto& i : v) ds << i;
+    return ds;
+}
+
+template<typename Stream, typename T, size_t N>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::array<T, N>& v) {
+    for (auto& i : v) ds >> i;
+    return ds;
+}
+
+template<typename Stream, typename K, typename V>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::pair<K, V>& v) {
+    return ds << v.first << v.second;
+}
+
+template<typename Stream, typename K, typename V>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::pair<K, V>& v) {
+    return ds >> v.first >> v.second;
+}
+
+template<typename Stream, typename K, typename V>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::map<K, V>& m) {
+    ds << unsigned_int(m.size());
+    for (const auto& i : m) ds << i.first << i.second;
+    return ds;
+}
+
+template<typename Stream, typename K, typename V>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::map<K, V>& m) {
+    unsigned_int s;
+    ds >> s;
+    m.clear();
+    for (uint32_t i = 0; i < s.value; ++i) {
+        K k; V v;
+        ds >> k >> v;
+        m.emplace(std::move(k), std::move(v));
+    }
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::set<T>& s) {
+    ds << unsigned_int(s.size());
+    for (const auto& i : s) ds << i;
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::set<T>& s) {
+    unsigned_int n;
+    ds >> n;
+    s.clear();
+    for (uint32_t i = 0; i < n.value; ++i) {
+        T v;
+        ds >> v;
+        s.emplace(std::move(v));
+    }
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator<<(datastream<Stream>& ds, const std::optional<T>& o) {
+    ds << bool(o);
+    if (o) ds << *o;
+    return ds;
+}
+
+template<typename Stream, typename T>
+datastream<Stream>& operator>>(datastream<Stream>& ds, std::optional<T>& o) {
+    bool has = false;
+    ds >> has;
+    if (has) { T v; ds >> v; o = std::move(v); }
+    else o.reset();
+    return ds;
+}
+
+/**
+ * Field-wise serialization of plain aggregates without EOSLIB_SERIALIZE
+ * (the CDT uses boost::pfr for this). Only reached when no more specific
+ * operator exists; the EOSLIB_SERIALIZE friends win partial ordering.
+ */
+namespace _reflect_detail {
+    struct any_field {
+        template<typename T> operator T() const;
+    };
+
+    template<typename T, typename... A>
+    constexpr auto brace_constructible(int) -> decltype(T{std::declval<A>()...}, true) { return true; }
+    template<typename T, typename... A>
+    constexpr bool brace_constructible(...) { return false; }
+
+    template<typename T, size_t... I>
+    constexpr bool brace_constructible_n(std::index_sequence<I...>) {
+        return brace_constructible<T, decltype((void)I, any_field{})...>(0);
+    }
+
+    template<typename T, size_t N = 12>
+    constexpr size_t field_count() {
+        if constexpr (N == 0) return 0;
+        else if constexpr (brace_constructible_n<T>(std::make_index_sequence<N>{})) return N;
+        else return field_count<T, N - 1>();
+    }
+
+#define SIM_TIE_FIELDS(N, ...)                                            \
+    if constexpr (n == N) { auto& [__VA_ARGS__] = t; return std::tie(__VA_ARGS__); } else
+
+    template<typename T>
+    auto tie_fields(T& t) {
+        constexpr size_t n = field_count<std::remove_const_t<T>>();
+        SIM_TIE_FIELDS(1, a)
+        SIM_TIE_FIELDS(2, a, b)
+        SIM_TIE_FIELDS(3, a, b, c)
+        SIM_TIE_FIELDS(4, a, b, c, d)
+        SIM_TIE_FIELDS(5, a, b, c, d, e)
+        SIM_TIE_FIELDS(6, a, b, c, d, e, f)
+        SIM_TIE_FIELDS(7, a, b, c, d, e, f, g)
+        SIM_TIE_FIELDS(8, a, b, c, d, e, f, g, h)
+        SIM_TIE_FIELDS(9, a, b, c, d, e, f, g, h, i)
+        SIM_TIE_FIELDS(10, a, b, c, d, e, f, g, h, i, j)
+        SIM_TIE_FIELDS(11, a, b, c, d, e, f, g, h, i, j, k)
+        SIM_TIE_FIELDS(12, a, b, c, d, e, f, g, h, i, j, k, l)
+        { static_assert(n > 0 && n <= 12, "aggregate is not reflectable"); return std::tie(); }
+    }
+#undef SIM_TIE_FIELDS
+
+    template<typename T>
+    constexpr bool reflectable = std::is_class_v<T> && std::is_aggregate_v<T>
+                              && !_datastream_detail::is_std_array<T>::value;
+}
+
+template<typename DataStream, typename T,
+         std::enable_if_t<is_datastream<DataStream>::value && _reflect_detail::reflectable<T>>* = nullptr>
+DataStream& operator<<(DataStream& ds, const T& v) {
+    std::apply([&](const auto&... f) { (ds << ... << f); }, _reflect_detail::tie_fields(v));
+    return ds;
+}
+
+template<typename DataStream, typename T,
+         std::enable_if_t<is_datastream<DataStream>::value && _reflect_detail::reflectable<T>>* = nullptr>
+DataStream& operator>>(DataStream& ds, T& v) {
+    std::apply([&](auto&... f) { (ds >> ... >> f); }, _reflect_detail::tie_fields(v));
+    return ds;
+}
+
+template<typename T>
+size_t pack_size(const T& value) {
+    datastream<size_t> ps;
+    ps << value;
+    return ps.tellp();
+}
+
+template<typename T>
+std::vector<char> pack(const T& value) {
+    std::vector<char> result(pack_size(value));
+    datastream<char*> ds(result.data(), result.size());
+    ds << value;
+    return result;
+}
+
+template<typename T>
+void unpack(T& res, const char* buffer, size_t len) {
+    datastream<const char*> ds(buffer, len);
+    ds >> res;
+}
+
+template<typename T>
+T unpack(const char* buffer, size_t len) {
+    T result;
+    unpack(result, buffer, len);
+    return result;
+}
+
+template<typename T>
+T unpack(const std::vector<char>& bytes) {
+    return unpack<T>(bytes.data(), bytes.size());
+}
+
+} // namespace eosio
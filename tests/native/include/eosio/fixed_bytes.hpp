@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <eosio/serialize.hpp>
+
+namespace eosio {
+
+/**
+ * Fixed size byte array (checksum160/256/512), big-endian word packing as in the CDT.
+ */
+template<size_t Size>
+class fixed_bytes {
+public:
+    fixed_bytes() { _data.fill(0); }
+
+    template<typename Word, typename... Rest>
+    static fixed_bytes make_from_word_sequence(Word first_word, Rest... rest) {
+        static_assert(std::is_integral_v<Word> && std::is_unsigned_v<Word>, "word must be unsigned integral");
+        static_assert(sizeof(Word) * (1 + sizeof...(Rest)) <= Size, "too many words");
+        fixed_bytes r;
+        size_t pos = 0;
+        for (Word w : {first_word, Word(rest)...}) {
+            for (size_t i = 0; i < sizeof(Word); ++i)
+                r._data[pos++] = uint8_t(w >> (8 * (sizeof(Word) - 1 - i)));
+        }
+        return r;
+    }
+
+    const uint8_t* data() const { return _data.data(); }
+    uint8_t*       data()       { return _data.data(); }
+    static constexpr size_t size() { return Size; }
+
+    std::array<uint8_t, Size> extract_as_byte_array() const { return _data; }
+
+    friend bool operator==(const fixed_bytes& a, const fixed_bytes& b) { return a._data == b._data; }
+    friend bool operator!=(const fixed_bytes& a, const fixed_bytes& b) { return a._data != b._data; }
+    friend bool operator< (const fixed_bytes& a, const fixed_bytes& b) { return a._data <  b._data; }
+
+    std::array<uint8_t, Size> _data;
+
+    EOSLIB_SERIALIZE(fixed_bytes, (_data))
+};
+
+using checksum160 = fixed_bytes<20>;
+using checksum256 = fixed_bytes<32>;
+using checksum512 = fixed_bytes<64>;
+
+} // namespace eosio
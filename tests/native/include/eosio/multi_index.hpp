@@ -0,0 +1,431 @@
+#pragma once
+
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <eosio/check.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/fixed_bytes.hpp>
+#include <eosio/name.hpp>
+
+namespace eosio {
+
+constexpr static inline name same_payer{};
+
+template<class Class, typename Type, Type (Class::*PtrToMemberFunction)() const>
+struct const_mem_fun {
+    typedef typename std::remove_reference<Type>::type result_type;
+
+    Type operator()(const Class& x) const { return (x.*PtrToMemberFunction)(); }
+};
+
+template<name::raw IndexName, typename Extractor>
+struct indexed_by {
+    static constexpr name index_name = name(IndexName);
+    typedef Extractor secondary_extractor_type;
+};
+
+namespace _multi_index_detail {
+
+    inline std::string be_bytes(uint64_t v) {
+        std::string s(8, '\0');
+        for (int i = 0; i < 8; ++i) s[i] = char(uint8_t(v >> (56 - 8 * i)));
+        return s;
+    }
+
+    // order preserving encoding of a secondary key
+    template<typename K>
+    std::string to_key(const K& k) {
+        if constexpr (std::is_same_v<K, uint128_t> || std::is_same_v<K, int128_t>) {
+            const uint128_t u = (uint128_t)k;
+            return be_bytes(uint64_t(u >> 64)) + be_bytes(uint64_t(u));
+        } else if constexpr (std::is_floating_point_v<K>) {
+            const double d = (double)k;
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            bits = (bits >> 63) ? ~bits : (bits | (1ull << 63));
+            return be_bytes(bits);
+        } else if constexpr (std::is_integral_v<K>) {
+            return be_bytes((uint64_t)k);
+        } else {
+            return std::string((const char*)k.data(), k.size());
+        }
+    }
+
+    template<uint64_t Name, uint32_t I, typename... Indices>
+    struct index_number;
+    template<uint64_t Name, uint32_t I>
+    struct index_number<Name, I> { static constexpr uint32_t value = I; };
+    template<uint64_t Name, uint32_t I, typename First, typename... Rest>
+    struct index_number<Name, I, First, Rest...> {
+        static constexpr uint32_t value = First::index_name.value == Name ? I : index_number<Name, I + 1, Rest...>::value;
+    };
+
+} // namespace _multi_index_detail
+
+/**
+ * In-memory multi_index. Rows live in the sim host as packed bytes (so other
+ * contracts can read them with their own struct copies); each instance keeps
+ * its own object cache exactly like the CDT implementation does.
+ */
+template<name::raw TableName, typename T, typename... Indices>
+class multi_index {
+    static_assert(sizeof...(Indices) <= 16, "multi_index only supports a maximum of 16 secondary indices");
+
+    static constexpr uint64_t table_value = static_cast<uint64_t>(TableName);
+
+public:
+    struct const_iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = const T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        const_iterator() = default;
+        const_iterator(const multi_index* mi, uint64_t pk, bool end) : _mi(mi), _pk(pk), _end(end) {}
+
+        const T& operator*() const {
+            check(!_end, "cannot dereference end iterator");
+            const T* p = _mi->_load(_pk);
+            check(p != nullptr, "dereference of deleted object");
+            return *p;
+        }
+        const T* operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            check(!_end, "cannot increment end iterator");
+            uint64_t next;
+            if (sim::host::db_upper_bound(_mi->_code.value, _mi->_scope, table_value, _pk, next)) _pk = next;
+            else _end = true;
+            return *this;
+        }
+        const_iterator operator++(int) { auto r = *this; ++(*this); return r; }
+
+        const_iterator& operator--() {
+            uint64_t prev;
+            if (_end) {
+                check(sim::host::db_last(_mi->_code.value, _mi->_scope, table_value, prev),
+                      "cannot decrement end iterator when the table is empty");
+                _end = false;
+            } else {
+                check(sim::host::db_prev(_mi->_code.value, _mi->_scope, table_value, _pk, prev),
+                      "cannot decrement iterator at beginning of table");
+            }
+            _pk = prev;
+            return *this;
+        }
+        const_iterator operator--(int) { auto r = *this; --(*this); return r; }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a._mi == b._mi && a._end == b._end && (a._end || a._pk == b._pk);
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) { return !(a == b); }
+
+    private:
+        friend class multi_index;
+        const multi_index* _mi  = nullptr;
+        uint64_t           _pk  = 0;
+        bool               _end = true;
+    };
+
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    template<typename IndexSpec, uint32_t Number>
+    class index {
+    public:
+        using extractor          = typename IndexSpec::secondary_extractor_type;
+        using secondary_key_type = std::decay_t<decltype(extractor{}(std::declval<const T&>()))>;
+
+        struct const_iterator {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = const T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const T*;
+            using reference         = const T&;
+
+            const_iterator() = default;
+            const_iterator(const index* idx, std::string key, uint64_t pk, bool end)
+                : _idx(idx), _key(std::move(key)), _pk(pk), _end(end) {}
+
+            const T& operator*() const {
+                check(!_end, "cannot dereference end iterator");
+                const T* p = _idx->_mi->_load(_pk);
+                check(p != nullptr, "dereference of deleted object");
+                return *p;
+            }
+            const T* operator->() const { return &**this; }
+
+            const_iterator& operator++() {
+                check(!_end, "cannot increment end iterator");
+                if (!sim::host::idx_next(_idx->_code(), _idx->_scope(), table_value, Number, _key, _pk, _key, _pk))
+                    _end = true;
+                return *this;
+            }
+            const_iterator operator++(int) { auto r = *this; ++(*this); return r; }
+
+            const_iterator& operator--() {
+                if (_end) {
+                    check(sim::host::idx_last(_idx->_code(), _idx->_scope(), table_value, Number, _key, _pk),
+                          "cannot decrement end iterator when the index is empty");
+                    _end = false;
+                } else {
+                    check(sim::host::idx_prev(_idx->_code(), _idx->_scope(), table_value, Number, _key, _pk, _key, _pk),
+                          "cannot decrement iterator at beginning of index");
+                }
+                return *this;
+            }
+            const_iterator operator--(int) { auto r = *this; --(*this); return r; }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b) {
+                return a._owner() == b._owner() && a._end == b._end
+                    && (a._end || (a._pk == b._pk && a._key == b._key));
+            }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b) { return !(a == b); }
+
+        private:
+            friend class index;
+            const multi_index* _owner() const { return _idx ? _idx->_mi : nullptr; }
+
+            const index* _idx = nullptr;
+            std::string  _key;
+            uint64_t     _pk  = 0;
+            bool         _end = true;
+        };
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        explicit index(multi_index* mi) : _mi(mi) {}
+
+        const_iterator cbegin() const { return _lower_bound(std::string(), 0); }
+        const_iterator begin() const  { return cbegin(); }
+        const_iterator cend() const   { return const_iterator(this, std::string(), 0, true); }
+        const_iterator end() const    { return cend(); }
+
+        const_reverse_iterator crbegin() const { return std::make_reverse_iterator(cend()); }
+        const_reverse_iterator rbegin() const  { return crbegin(); }
+        const_reverse_iterator crend() const   { return std::make_reverse_iterator(cbegin()); }
+        const_reverse_iterator rend() const    { return crend(); }
+
+        const_iterator lower_bound(const secondary_key_type& k) const {
+            return _lower_bound(_multi_index_detail::to_key(k), 0);
+        }
+
+        const_iterator upper_bound(const secondary_key_type& k) const {
+            std::string key; uint64_t pk;
+            if (sim::host::idx_next(_code(), _scope(), table_value, Number,
+                                    _multi_index_detail::to_key(k), std::numeric_limits<uint64_t>::max(), key, pk))
+                return const_iterator(this, std::move(key), pk, false);
+            return cend();
+        }
+
+        const_iterator find(const secondary_key_type& k) const {
+            auto itr = lower_bound(k);
+            if (itr != cend() && itr._key == _multi_index_detail::to_key(k)) return itr;
+            return cend();
+        }
+
+        const_iterator require_find(const secondary_key_type& k, const char* msg = "unable to find secondary key") const {
+            auto itr = find(k);
+            check(itr != cend(), msg);
+            return itr;
+        }
+
+        const T& get(const secondary_key_type& k, const char* msg = "unable to find secondary key") const {
+            return *require_find(k, msg);
+        }
+
+        const_iterator iterator_to(const T& obj) const {
+            return const_iterator(this, _multi_index_detail::to_key(extractor{}(obj)), obj.primary_key(), false);
+        }
+
+        template<typename Lambda>
+        void modify(const_iterator itr, name payer, Lambda&& updater) {
+            check(itr != cend(), "cannot pass end iterator to modify");
+            _mi->modify(*itr, payer, std::forward<Lambda>(updater));
+        }
+
+        const_iterator erase(const_iterator itr) {
+            check(itr != cend(), "cannot pass end iterator to erase");
+            auto next = itr;
+            ++next;
+            _mi->erase(*itr);
+            return next;
+        }
+
+        name     get_code() const  { return _mi->get_code(); }
+        uint64_t get_scope() const { return _mi->get_scope(); }
+
+    private:
+        uint64_t _code() const  { return _mi->_code.value; }
+        uint64_t _scope() const { return _mi->_scope; }
+
+        const_iterator _lower_bound(const std::string& k, uint64_t pk) const {
+            std::string key; uint64_t found;
+            if (sim::host::idx_lower_bound(_code(), _scope(), table_value, Number, k, pk, key, found))
+                return const_iterator(this, std::move(key), found, false);
+            return cend();
+        }
+
+        multi_index* _mi;
+    };
+
+    multi_index(name code, uint64_t scope) : _code(code), _scope(scope) {}
+
+    multi_index(const multi_index&)            = delete;
+    multi_index& operator=(const multi_index&) = delete;
+    multi_index(multi_index&&)                 = default;
+    multi_index& operator=(multi_index&&)      = default;
+
+    name     get_code() const  { return _code; }
+    uint64_t get_scope() const { return _scope; }
+
+    const_iterator cbegin() const { return lower_bound(0); }
+    const_iterator begin() const  { return cbegin(); }
+    const_iterator cend() const   { return const_iterator(this, 0, true); }
+    const_iterator end() const    { return cend(); }
+
+    const_reverse_iterator crbegin() const { return std::make_reverse_iterator(cend()); }
+    const_reverse_iterator rbegin() const  { return crbegin(); }
+    const_reverse_iterator crend() const   { return std::make_reverse_iterator(cbegin()); }
+    const_reverse_iterator rend() const    { return crend(); }
+
+    const_iterator lower_bound(uint64_t primary) const {
+        uint64_t pk;
+        if (sim::host::db_lower_bound(_code.value, _scope, table_value, primary, pk)) return const_iterator(this, pk, false);
+        return cend();
+    }
+
+    const_iterator upper_bound(uint64_t primary) const {
+        uint64_t pk;
+        if (sim::host::db_upper_bound(_code.value, _scope, table_value, primary, pk)) return const_iterator(this, pk, false);
+        return cend();
+    }
+
+    uint64_t available_primary_key() const {
+        uint64_t last;
+        if (!sim::host::db_last(_code.value, _scope, table_value, last)) return 0;
+        check(last < std::numeric_limits<uint64_t>::max() - 1, "next primary key in table is at autoincrement limit");
+        return last + 1;
+    }
+
+    const_iterator find(uint64_t primary) const {
+        return _load(primary) ? const_iterator(this, primary, false) : cend();
+    }
+
+    const_iterator require_find(uint64_t primary, const char* msg = "unable to find key") const {
+        auto itr = find(primary);
+        check(itr != cend(), msg);
+        return itr;
+    }
+
+    const T& get(uint64_t primary, const char* msg = "unable to find key") const {
+        const T* p = _load(primary);
+        check(p != nullptr, msg);
+        return *p;
+    }
+
+    const_iterator iterator_to(const T& obj) const {
+        return const_iterator(this, obj.primary_key(), false);
+    }
+
+    template<name::raw IndexName>
+    auto get_index() {
+        constexpr uint32_t n = _multi_index_detail::index_number<static_cast<uint64_t>(IndexName), 0, Indices...>::value;
+        static_assert(n < sizeof...(Indices), "name provided is not the name of any secondary index within multi_index");
+        return index<std::tuple_element_t<n, std::tuple<Indices...>>, n>(this);
+    }
+
+    template<name::raw IndexName>
+    auto get_index() const {
+        return const_cast<multi_index*>(this)->template get_index<IndexName>();
+    }
+
+    template<typename Lambda>
+    const_iterator emplace(name payer, Lambda&& constructor) {
+        auto obj = std::make_unique<T>();
+        constructor(*obj);
+        const uint64_t pk = obj->primary_key();
+        check(_load(pk) == nullptr, "could not insert object, most likely a uniqueness constraint was violated");
+        check(payer.value != 0, "must specify a valid account to pay for new record");
+        sim::host::db_set(_code.value, _scope, table_value, payer.value, pk, pack(*obj), _secondary_keys(*obj));
+        _items[pk] = std::move(obj);
+        return const_iterator(this, pk, false);
+    }
+
+    template<typename Lambda>
+    void modify(const_iterator itr, name payer, Lambda&& updater) {
+        check(itr != cend(), "cannot pass end iterator to modify");
+        modify(*itr, payer, std::forward<Lambda>(updater));
+    }
+
+    template<typename Lambda>
+    void modify(const T& obj, name payer, Lambda&& updater) {
+        const uint64_t pk = obj.primary_key();
+        const T* cached = _load(pk);
+        check(cached == &obj, "object passed to modify is not in multi_index");
+        const std::vector<std::string> old_keys = _secondary_keys(obj);
+        auto& mutableobj = const_cast<T&>(obj);
+        updater(mutableobj);
+        check(pk == mutableobj.primary_key(), "updater cannot change primary key when modifying an object");
+
+        // like CDT, a changed key is updated through the row's existing index entry, and an
+        // unchanged key is left alone: rows written before an index existed stay out of it
+        std::vector<std::string> keys = _secondary_keys(mutableobj);
+        for (uint32_t i = 0; i < keys.size(); ++i) {
+            std::string stored;
+            if (sim::host::idx_key_of(_code.value, _scope, table_value, i, pk, stored)) continue;
+            check(keys[i] == old_keys[i], "secondary index entry missing for modified key");
+            keys.resize(i);
+            break;
+        }
+        sim::host::db_set(_code.value, _scope, table_value, payer.value, pk, pack(mutableobj), std::move(keys));
+    }
+
+    const_iterator erase(const_iterator itr) {
+        check(itr != cend(), "cannot pass end iterator to erase");
+        auto next = itr;
+        ++next;
+        erase(*itr);
+        return next;
+    }
+
+    void erase(const T& obj) {
+        const uint64_t pk = obj.primary_key();
+        check(_load(pk) == &obj, "object passed to erase is not in multi_index");
+        sim::host::db_erase(_code.value, _scope, table_value, pk);
+        _items.erase(pk);
+    }
+
+private:
+    const T* _load(uint64_t pk) const {
+        auto it = _items.find(pk);
+        if (it != _items.end()) return it->second.get();
+
+        std::vector<char> buf;
+        if (!sim::host::db_get(_code.value, _scope, table_value, pk, buf)) return nullptr;
+
+        auto obj = std::make_unique<T>();
+        unpack(*obj, buf.data(), buf.size());
+        const T* p = obj.get();
+        _items.emplace(pk, std::move(obj));
+        return p;
+    }
+
+    static std::vector<std::string> _secondary_keys(const T& obj) {
+        return { _multi_index_detail::to_key(typename Indices::secondary_extractor_type{}(obj))... };
+    }
+
+    name                                            _code;
+    uint64_t                                        _scope;
+    mutable std::map<uint64_t, std::unique_ptr<T>>  _items;
+};
+
+} // namespace eosio
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <eosio/name.hpp>
+#include <eosio/serialize.hpp>
+
+namespace eosio {
+
+struct permission_level {
+    permission_level(name a, name p) : actor(a), permission(p) {}
+    permission_level() {}
+
+    name actor;
+    name permission;
+
+    friend constexpr bool operator==(const permission_level& a, const permission_level& b) {
+        return a.actor == b.actor && a.permission == b.permission;
+    }
+    friend constexpr bool operator<(const permission_level& a, const permission_level& b) {
+        return a.actor < b.actor || (a.actor == b.actor && a.permission < b.permission);
+    }
+
+    EOSLIB_SERIALIZE(permission_level, (actor)(permission))
+};
+
+} // namespace eosio
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include <eosio/asset.hpp>
+#include <eosio/name.hpp>
+#include <eosio/symbol.hpp>
+
+namespace eosio {
+
+inline void print(const char* s)        { sim::host::print(s); }
+inline void print(const std::string& s) { sim::host::print(s); }
+inline void print(std::string_view s)   { sim::host::print(std::string(s)); }
+inline void print(char c)               { sim::host::print(std::string(1, c)); }
+inline void print(bool b)               { sim::host::print(b ? "true" : "false"); }
+inline void print(name n)               { sim::host::print(n.to_string()); }
+inline void print(symbol_code s)        { sim::host::print(s.to_string()); }
+inline void print(symbol s)             { sim::host::print(s.to_string()); }
+inline void print(const asset& a)       { sim::host::print(a.to_string()); }
+inline void print(const extended_asset& a) { sim::host::print(a.to_string()); }
+
+template<typename T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>* = nullptr>
+void print(T v) {
+    sim::host::print(std::to_string(v));
+}
+
+inline void print(int128_t v) {
+    const bool neg = v < 0;
+    unsigned __int128 u = neg ? (unsigned __int128)(-v) : (unsigned __int128)v;
+    std::string s;
+    do { s.insert(s.begin(), char('0' + int(u % 10))); u /= 10; } while (u);
+    sim::host::print(neg ? "-" + s : s);
+}
+
+inline void print(uint128_t v) {
+    std::string s;
+    do { s.insert(s.begin(), char('0' + int(v % 10))); v /= 10; } while (v);
+    sim::host::print(s);
+}
+
+template<typename Arg, typename... Args>
+void print(Arg&& a, Args&&... args) {
+    print(std::forward<Arg>(a));
+    print(std::forward<Args>(args)...);
+}
+
+inline void printhex(const void*, uint32_t) {}
+
+} // namespace eosio
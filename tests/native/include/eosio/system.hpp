@@ -0,0 +1,21 @@
+#pragma once
+
+#include <eosio/check.hpp>
+#include <eosio/name.hpp>
+#include <eosio/time.hpp>
+
+namespace eosio {
+
+inline time_point current_time_point() {
+    return time_point(microseconds(sim::host::current_time_us()));
+}
+
+inline time_point_sec current_block_time() {
+    return time_point_sec(current_time_point());
+}
+
+inline bool is_account(name n) {
+    return sim::host::is_account(n.value);
+}
+
+} // namespace eosio
@@ -0,0 +1,4 @@
+#pragma once
+
+#include <eosio/action.hpp>
+#include <eosio/time.hpp>
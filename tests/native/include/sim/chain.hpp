@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/permission.hpp>
+#include <eosio/time.hpp>
+
+#include <sim/host.hpp>
+
+namespace sim {
+
+using apply_fn = void (*)(uint64_t receiver, uint64_t code, uint64_t action);
+
+struct action_trace {
+    eosio::name receiver;
+    eosio::name code;
+    eosio::name action;
+    uint32_t    depth       = 0;    // inline depth, 0 for the pushed action
+    int64_t     elapsed_ns  = 0;    // wall time spent in this receiver's handler
+    int64_t     ram_delta   = 0;    // bytes billed (or refunded) during the handler
+};
+
+/**
+ * In-memory chain driving the natively compiled contracts.
+ *
+ * One instance at a time; every push_action runs as its own transaction with
+ * full rollback on failure. Inline actions and notifications execute in the
+ * same order as nodeos: the action, then every notified receiver, then the
+ * inline actions queued by all of them.
+ */
+class SIM_HOST_API chain {
+public:
+    chain();
+    ~chain();
+
+    chain(const chain&)            = delete;
+    chain& operator=(const chain&) = delete;
+
+    void create_account(eosio::name account);
+    void deploy(eosio::name account, apply_fn apply);
+    // `actor@active` trusts `contract@eosio.code` (the --add-code permission)
+    void grant_code(eosio::name actor, eosio::name contract);
+
+    void                  set_time(eosio::time_point_sec t);
+    void                  produce(uint32_t seconds);
+    eosio::time_point_sec now() const;
+
+    // returns an empty string on success, the assertion message otherwise
+    std::string push_action(eosio::name code, eosio::name action,
+                            const std::vector<eosio::permission_level>& auth,
+                            std::vector<char> data);
+
+    template<typename... Args>
+    std::string push(eosio::name code, eosio::name action, eosio::name signer, const Args&... args) {
+        datastream_packer p;
+        (p.add(args), ...);
+        return push_action(code, action, {{signer, eosio::name("active")}}, p.take());
+    }
+
+    // executes like push_action, keeps traces and RAM deltas, then rolls everything back
+    std::string dry_run_action(eosio::name code, eosio::name action,
+                               const std::vector<eosio::permission_level>& auth,
+                               std::vector<char> data);
+
+    template<typename... Args>
+    std::string dry_run(eosio::name code, eosio::name action, eosio::name signer, const Args&... args) {
+        datastream_packer p;
+        (p.add(args), ...);
+        return dry_run_action(code, action, {{signer, eosio::name("active")}}, p.take());
+    }
+
+    int64_t                          ram_usage(eosio::name account) const;
+    const std::vector<action_trace>& traces() const;    // of the last transaction, up to the failing receiver
+    const std::string&               console() const;   // of the last transaction
+    // RAM billed (or refunded) per payer by the last successful transaction
+    const std::map<eosio::name, int64_t>& ram_deltas() const;
+    // packed size of the last pushed action; like nodeos, inline actions cost no net
+    uint32_t                              net_bytes() const;
+    uint64_t                         rows(eosio::name code) const;
+
+    struct impl;
+
+private:
+    std::string _push(eosio::name code, eosio::name action,
+                      const std::vector<eosio::permission_level>& auth,
+                      std::vector<char> data, bool commit);
+
+    struct datastream_packer {
+        std::vector<char> buf;
+        template<typename T>
+        void add(const T& v) {
+            auto b = eosio::pack(v);
+            buf.insert(buf.end(), b.begin(), b.end());
+        }
+        void add(const char* s) { add(std::string(s)); }
+        std::vector<char> take() { return std::move(buf); }
+    };
+
+    std::unique_ptr<impl> _my;
+};
+
+} // namespace sim
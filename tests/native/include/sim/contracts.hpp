@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// entry points exported by the natively built contract libraries
+extern "C" {
+void sim_apply_investrwa(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_stakerwa(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_yieldrwa(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_guarantyrwa(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_vaultrwa(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_rwafitoken(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_flontoken(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_flonswap(uint64_t receiver, uint64_t code, uint64_t action);
+
+// rwafi.hub: the four pools as one contract, with its own rwafi.token build
+void sim_apply_rwafihub(uint64_t receiver, uint64_t code, uint64_t action);
+void sim_apply_rwafitoken_hub(uint64_t receiver, uint64_t code, uint64_t action);
+}
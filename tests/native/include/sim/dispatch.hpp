@@ -0,0 +1,81 @@
+#pragma once
+
+#include <tuple>
+
+#include <eosio/eosio.hpp>
+
+/**
+ * Native replacement of the abigen generated `apply` entry point.
+ *
+ * Each contract library exports one `sim_apply_<contract>` function listing
+ * its actions and `on_notify` handlers (the attributes themselves are ignored
+ * by the host compiler):
+ *
+ *     SIM_EXPORT void sim_apply_token(uint64_t receiver, uint64_t code, uint64_t action) {
+ *         sim::dispatcher<eosio::token>(receiver, code, action)
+ *             .on_action<&eosio::token::transfer>("transfer"_n)
+ *             .finish();
+ *     }
+ */
+#define SIM_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace sim {
+
+// on_notify("*::transfer")
+static constexpr eosio::name any_code{};
+
+template<typename Contract>
+class dispatcher {
+public:
+    dispatcher(uint64_t receiver, uint64_t code, uint64_t action)
+        : _receiver(receiver), _code(code), _action(action) {}
+
+    template<auto Method>
+    dispatcher& on_action(eosio::name act) {
+        if (!_done && _receiver == _code && act.value == _action) {
+            _run<Method>();
+            _done = true;
+        }
+        return *this;
+    }
+
+    // `code` may be "*"_n to match any first receiver, as in "*::transfer"
+    template<auto Method>
+    dispatcher& on_notify(eosio::name code, eosio::name act) {
+        if (!_done && _receiver != _code && act.value == _action
+                   && (code == any_code || code.value == _code)) {
+            _run<Method>();
+            _done = true;
+        }
+        return *this;
+    }
+
+    void finish() {
+        if (!_done && _receiver == _code) {
+            eosio::check(false, "unknown action " + eosio::name(_action).to_string()
+                                + " on " + eosio::name(_receiver).to_string());
+        }
+    }
+
+private:
+    template<auto Method>
+    void _run() {
+        using args_t = typename eosio::_action_detail::member_args<decltype(Method)>::type;
+
+        const auto& data = sim::host::action_data();
+        args_t args;
+        eosio::datastream<const char*> ds(data.data(), data.size());
+        std::apply([&](auto&... a) { (void)(ds >> ... >> a); }, args);
+
+        Contract obj(eosio::name(_receiver), eosio::name(_code),
+                     eosio::datastream<const char*>(data.data(), data.size()));
+        std::apply([&](auto&... a) { (obj.*Method)(a...); }, args);
+    }
+
+    uint64_t _receiver;
+    uint64_t _code;
+    uint64_t _action;
+    bool     _done = false;
+};
+
+} // namespace sim
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Host side of the native simulator.
+ *
+ * Contract libraries are built with hidden visibility and only talk to the
+ * host through the functions below (the native counterpart of the wasm
+ * intrinsics). They are implemented once in the sim host library, which owns
+ * the in-memory database, the action queue, authorization and the clock.
+ */
+#define SIM_HOST_API __attribute__((visibility("default")))
+
+namespace sim { namespace host {
+
+using bytes = std::vector<char>;
+
+// ---- context -----------------------------------------------------------
+[[noreturn]] SIM_HOST_API void abort(const std::string& msg);
+SIM_HOST_API void           print(const std::string& s);
+SIM_HOST_API int64_t        current_time_us();
+SIM_HOST_API bool           is_account(uint64_t account);
+SIM_HOST_API void           require_auth(uint64_t account);
+SIM_HOST_API bool           has_auth(uint64_t account);
+SIM_HOST_API void           require_recipient(uint64_t account);
+SIM_HOST_API const bytes&   action_data();
+SIM_HOST_API void           send_inline(uint64_t account, uint64_t action,
+                                        const std::vector<std::pair<uint64_t, uint64_t>>& auth,
+                                        bytes data);
+
+// ---- crypto ------------------------------------------------------------
+SIM_HOST_API void           sha256(const char* data, uint32_t length, uint8_t out[32]);
+
+// ---- primary table -----------------------------------------------------
+// only the current receiver may write to tables of `code`; payer 0 keeps the row payer
+SIM_HOST_API bool db_get(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, bytes& out);
+SIM_HOST_API void db_set(uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, uint64_t pk,
+                         const bytes& data, const std::vector<std::string>& sec_keys);
+SIM_HOST_API void db_erase(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk);
+SIM_HOST_API bool db_lower_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out);
+SIM_HOST_API bool db_upper_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out);
+SIM_HOST_API bool db_prev(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out);
+SIM_HOST_API bool db_last(uint64_t code, uint64_t scope, uint64_t table, uint64_t& out);
+
+// ---- secondary indexes -------------------------------------------------
+// keys are order preserving byte strings, ties are broken by primary key
+SIM_HOST_API bool idx_lower_bound(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                                  const std::string& key, uint64_t pk,
+                                  std::string& out_key, uint64_t& out_pk);
+SIM_HOST_API bool idx_next(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                           const std::string& key, uint64_t pk,
+                           std::string& out_key, uint64_t& out_pk);
+SIM_HOST_API bool idx_prev(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                           const std::string& key, uint64_t pk,
+                           std::string& out_key, uint64_t& out_pk);
+SIM_HOST_API bool idx_last(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                           std::string& out_key, uint64_t& out_pk);
+SIM_HOST_API bool idx_key_of(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                             uint64_t pk, std::string& out_key);
+
+} } // namespace sim::host
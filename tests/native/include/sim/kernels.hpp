@@ -0,0 +1,27 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+
+/**
+ * Precision math of the contracts, exported by the contract libraries so the
+ * property tests and micro-benchmarks call the exact code the actions run.
+ * Failed checks throw like any other contract assertion.
+ */
+#define SIM_KERNEL __attribute__((visibility("default")))
+
+namespace sim { namespace kernels {
+
+// stake.rwa
+SIM_KERNEL int128_t     reward_per_share_delta(const eosio::asset& rewards, const eosio::asset& total_staked);
+SIM_KERNEL eosio::asset user_reward(const eosio::asset& staked, const int128_t& reward_per_share_delta,
+                                    const eosio::symbol& reward_symbol);
+
+// invest.rwa
+SIM_KERNEL int64_t      issue_amount(const eosio::asset& accepted, const eosio::asset& receipt_per_unit);
+SIM_KERNEL int64_t      refund_amount(const eosio::asset& receipts, const eosio::asset& receipt_per_unit,
+                                      const eosio::symbol& goal_symbol);
+SIM_KERNEL int64_t      cap_amount(const eosio::asset& goal_quantity, uint8_t cap_percent);
+SIM_KERNEL int64_t      max_supply(const eosio::asset& goal_quantity, uint8_t hard_cap_percent,
+                                   const eosio::asset& receipt_per_unit);
+
+}} // namespace sim::kernels
@@ -0,0 +1,1164 @@
+#include <chrono>
+
+#include "rwafi_fixture.hpp"
+
+#include <investrwadb.hpp>
+#include <guaranty.rwa/guarantyrwadb.hpp>
+#include <yield.rwa/yieldrwadb.hpp>
+#include <flon/calendar.hpp>
+#include <flon/keeper.hpp>
+#include <flon/plan_alloc.hpp>
+#include <flon/merkle.hpp>
+#include <eosio/singleton.hpp>
+
+using namespace rwafi_sim;
+
+namespace {
+
+struct lifecycle_fixture : rwafi_fixture {
+    const name alice = "alice"_n;
+    const name bob   = "bob"_n;
+
+    lifecycle_fixture() {
+        create_account(alice, sing(10000));
+        create_account(bob,   sing(10000));
+    }
+
+    rwafi::fundplan_t plan(uint64_t id) const {
+        rwafi::fundplan_t::idx_t plans(flon::INVEST_POOL, flon::INVEST_POOL.value);
+        return plans.get(id, "plan not found");
+    }
+};
+
+// allowlist root and per-account proofs; an unpaired node moves up a level unchanged
+struct merkle_tree {
+    checksum256                             root;
+    std::vector<std::vector<checksum256>>   proofs;
+
+    explicit merkle_tree(const std::vector<name>& accounts): proofs(accounts.size()) {
+        std::vector<checksum256> level;
+        for (const auto& a : accounts) level.push_back(flon::merkle_leaf(a));
+        std::vector<size_t> pos(accounts.size());
+        for (size_t i = 0; i < pos.size(); ++i) pos[i] = i;
+
+        while (level.size() > 1) {
+            for (size_t i = 0; i < pos.size(); ++i) {
+                if ((pos[i] ^ 1) < level.size()) proofs[i].push_back(level[pos[i] ^ 1]);
+                pos[i] /= 2;
+            }
+            std::vector<checksum256> next;
+            for (size_t j = 0; j < level.size(); j += 2)
+                next.push_back(j + 1 < level.size() ? flon::merkle_parent(level[j], level[j + 1]) : level[j]);
+            level.swap(next);
+        }
+        root = level.front();
+    }
+};
+
+// guaranty.rwa rows exactly as the deployed baseline contract wrote them (signed assets, no secondary index)
+struct old_stats_row {
+    uint64_t        plan_id;
+    asset           total_guarantee_funds, total_locked_funds, total_unlocked_funds, used_guarantee_funds, cumulative_yield;
+    time_point_sec  created_at, updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    EOSLIB_SERIALIZE(old_stats_row, (plan_id)(total_guarantee_funds)(total_locked_funds)(total_unlocked_funds)
+                     (used_guarantee_funds)(cumulative_yield)(created_at)(updated_at))
+};
+
+struct old_stake_row {
+    name            guarantor;
+    asset           total_stake, available_stake, locked_stake, earned_yield, withdrawn;
+    time_point_sec  created_at, updated_at;
+
+    uint64_t primary_key() const { return guarantor.value; }
+
+    EOSLIB_SERIALIZE(old_stake_row, (guarantor)(total_stake)(available_stake)(locked_stake)(earned_yield)(withdrawn)
+                     (created_at)(updated_at))
+};
+
+// stands in for the pre-upgrade contract: any action seeds one plan's worth of old rows
+void seed_old_guaranty(uint64_t receiver, uint64_t, uint64_t) {
+    const name self(receiver);
+    eosio::multi_index<"guarantystat"_n, old_stats_row> stats(self, self.value);
+    stats.emplace(self, [&](auto& s) {
+        s.plan_id               = 1;
+        s.total_guarantee_funds = s.total_locked_funds = s.total_unlocked_funds = asset(600, flon::SING_SYM);
+        s.used_guarantee_funds  = s.cumulative_yield = asset(0, flon::SING_SYM);
+    });
+
+    eosio::multi_index<"stakes"_n, old_stake_row> stakes(self, 1);
+    for (uint64_t i = 1; i <= 3; ++i)
+        stakes.emplace(self, [&](auto& s) {
+            s.guarantor       = name(i);
+            s.total_stake     = asset(100 * i, flon::SING_SYM);
+            s.locked_stake    = asset(90 * i, flon::SING_SYM);
+            s.available_stake = s.earned_yield = s.withdrawn = asset(i, flon::SING_SYM);
+        });
+}
+
+// yield.rwa global before (percentage map keyed by pool account) and after (fixed bps split)
+struct old_yield_conf {
+    name                    admin;
+    std::map<name, uint8_t> yield_split_conf;
+
+    EOSLIB_SERIALIZE(old_yield_conf, (admin)(yield_split_conf))
+};
+
+struct old_buyback_row {
+    uint64_t        plan_id;
+    asset           total_buyback, used_buyback, total_voucher;
+    uint16_t        max_slippage = 100;
+    time_point_sec  updated_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    EOSLIB_SERIALIZE(old_buyback_row, (plan_id)(total_buyback)(used_buyback)(total_voucher)(max_slippage)(updated_at))
+};
+
+struct buyback_row {
+    uint64_t        plan_id;
+    int64_t         total_buyback = 0, used_buyback = 0;
+    asset           total_voucher;
+    uint16_t        max_slippage = 0;
+    time_point_sec  updated_at, next_buyback_at;
+    int64_t         chunk_size = 0;
+    uint32_t        chunk_interval = 0;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    EOSLIB_SERIALIZE(buyback_row, (plan_id)(total_buyback)(used_buyback)(total_voucher)(max_slippage)(updated_at)
+                     (next_buyback_at)(chunk_size)(chunk_interval))
+};
+
+// yield.rwa price_oracle_t
+struct oracle_row {
+    name            pair;
+    uint16_t        cursor = 0, filled = 0;
+    uint32_t        last_slot_at = 0, last_observed_at = 0;
+    uint128_t       last_price = 0, price_cumulative = 0;
+    uint64_t        time_cumulative = 0;
+
+    uint64_t primary_key() const { return pair.value; }
+
+    EOSLIB_SERIALIZE(oracle_row, (pair)(cursor)(filled)(last_slot_at)(last_observed_at)(last_price)(price_cumulative)
+                     (time_cumulative))
+};
+
+struct yield_conf {
+    name                    admin;
+    uint16_t                stake_bps = 0, guaranty_bps = 0, swap_bps = 0;
+    flon::keeper_conf_t     keeper;
+    uint32_t                twap_window  = 0;
+    uint16_t                max_twap_dev = 0;
+
+    EOSLIB_SERIALIZE(yield_conf, (admin)(stake_bps)(guaranty_bps)(swap_bps)(keeper)(twap_window)(max_twap_dev))
+};
+
+void seed_old_yield_conf(uint64_t receiver, uint64_t, uint64_t) {
+    const name self(receiver);
+    old_yield_conf g;
+    g.admin            = "admin"_n;
+    g.yield_split_conf = {{flon::STAKE_POOL, 60}, {flon::GUARANTY_POOL, 10}, {flon::SWAP_POOL, 10}};
+    eosio::singleton<"global"_n, old_yield_conf>(self, self.value).set(g, self);
+
+    eosio::multi_index<"planbuyback"_n, old_buyback_row> buybacks(self, self.value);
+    buybacks.emplace(self, [&](auto& b) {
+        b.plan_id       = 1;
+        b.total_buyback = asset(50, flon::SING_SYM);
+        b.used_buyback  = asset(20, flon::SING_SYM);
+        b.total_voucher = asset(7, rwafi_fixture::receipt_sym(1));
+    });
+}
+
+// baseline globals of invest / stake / guaranty: prefixes of the current configs, before keeper was appended
+struct old_invest_conf {
+    name        admin, stake_contract, yield_contract, guaranty_contract;
+    uint64_t    last_plan_id = 0;
+
+    EOSLIB_SERIALIZE(old_invest_conf, (admin)(stake_contract)(yield_contract)(guaranty_contract)(last_plan_id))
+};
+
+struct old_stake_conf {
+    name        admin, investrwa_contract;
+    uint64_t    reward_id = 0, stake_id = 0;
+
+    EOSLIB_SERIALIZE(old_stake_conf, (admin)(investrwa_contract)(reward_id)(stake_id))
+};
+
+struct old_guaranty_conf {
+    name        admin, invest_contract, yield_contract, stake_contract;
+
+    EOSLIB_SERIALIZE(old_guaranty_conf, (admin)(invest_contract)(yield_contract)(stake_contract))
+};
+
+struct reward_state_row {
+    uint64_t        reward_id = 0;
+    asset           total_rewards, last_rewards, unalloted_rewards, unclaimed_rewards, claimed_rewards;
+    int128_t        reward_per_share = 0, last_reward_per_share = 0;
+    time_point_sec  reward_added_at, prev_reward_added_at;
+    name            reward_token_contract;
+    symbol          reward_symbol;
+
+    EOSLIB_SERIALIZE(reward_state_row, (reward_id)(total_rewards)(last_rewards)(unalloted_rewards)(unclaimed_rewards)
+                     (claimed_rewards)(reward_per_share)(last_reward_per_share)(reward_added_at)(prev_reward_added_at)
+                     (reward_token_contract)(reward_symbol))
+};
+
+struct stake_plan_row {
+    uint64_t            plan_id;
+    symbol              receipt_symbol;
+    asset               cum_staked, total_staked;
+    reward_state_row    reward_state;
+    time_point_sec      created_at, refund_started_at;
+    uint8_t             version = 0;
+
+    uint64_t primary_key() const { return plan_id; }
+    uint64_t by_refund() const {
+        return refund_started_at.sec_since_epoch() == 0 ? std::numeric_limits<uint64_t>::max()
+                                                        : refund_started_at.sec_since_epoch();
+    }
+
+    EOSLIB_SERIALIZE(stake_plan_row, (plan_id)(receipt_symbol)(cum_staked)(total_staked)(reward_state)(created_at)
+                     (refund_started_at)(version))
+};
+
+struct old_stake_plan_row {
+    uint64_t            plan_id;
+    symbol              receipt_symbol;
+    asset               cum_staked, total_staked;
+    reward_state_row    reward_state;
+    time_point_sec      created_at;
+
+    uint64_t primary_key() const { return plan_id; }
+
+    EOSLIB_SERIALIZE(old_stake_plan_row, (plan_id)(receipt_symbol)(cum_staked)(total_staked)(reward_state)(created_at))
+};
+
+// a baseline fundplans row: the current plan without the version column
+struct old_fundplan_row : rwafi::fundplan_t {
+    EOSLIB_SERIALIZE(old_fundplan_row, (id)(title)(creator)(goal_asset_contract)(goal_quantity)(created_at)
+                     (receipt_asset_contract)(receipt_symbol)(receipt_quantity_per_unit)(soft_cap_percent)
+                     (hard_cap_percent)(start_time)(end_time)(return_months)(return_end_time)(guaranteed_yield_apr)
+                     (total_raised_funds)(total_issued_receipts)(status))
+};
+
+// rewrites the "global" singleton with only the baseline columns
+template<typename Old>
+void to_old_global(const name& self) {
+    eosio::singleton<"global"_n, Old> conf(self, self.value);
+    conf.set(conf.get(), self);
+}
+
+// the three seeds below rewrite what the current contracts created as baseline rows: same tables,
+// no appended columns, and no entries in the secondary indexes the baseline did not have
+void seed_old_invest(uint64_t receiver, uint64_t, uint64_t) {
+    const name self(receiver);
+    to_old_global<old_invest_conf>(self);
+
+    rwafi::fundplan_t::idx_t plans(self, self.value);
+    const std::vector<rwafi::fundplan_t> rows(plans.begin(), plans.end());
+    for (auto it = plans.begin(); it != plans.end(); it = plans.erase(it)) {}
+
+    eosio::multi_index<"fundplans"_n, old_fundplan_row> old_plans(self, self.value);
+    for (const auto& row : rows)
+        old_plans.emplace(self, [&](auto& p) { static_cast<rwafi::fundplan_t&>(p) = row; });
+}
+
+void seed_old_stake(uint64_t receiver, uint64_t, uint64_t) {
+    const name self(receiver);
+    to_old_global<old_stake_conf>(self);
+
+    eosio::multi_index<"stakeplans"_n, stake_plan_row,
+        eosio::indexed_by<"byrefund"_n, eosio::const_mem_fun<stake_plan_row, uint64_t, &stake_plan_row::by_refund>>
+    > plans(self, self.value);
+    const std::vector<stake_plan_row> rows(plans.begin(), plans.end());
+    for (auto it = plans.begin(); it != plans.end(); it = plans.erase(it)) {}
+
+    eosio::multi_index<"stakeplans"_n, old_stake_plan_row> old_plans(self, self.value);
+    for (const auto& row : rows)
+        old_plans.emplace(self, [&](auto& p) {
+            p.plan_id        = row.plan_id;
+            p.receipt_symbol = row.receipt_symbol;
+            p.cum_staked     = row.cum_staked;
+            p.total_staked   = row.total_staked;
+            p.reward_state   = row.reward_state;
+            p.created_at     = row.created_at;
+        });
+}
+
+void seed_old_guaranty_conf(uint64_t receiver, uint64_t, uint64_t) {
+    to_old_global<old_guaranty_conf>(name(receiver));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(lifecycle_tests)
+
+BOOST_FIXTURE_TEST_CASE(raise_success_yield_and_claim, lifecycle_fixture) {
+    const symbol st1 = receipt_sym(1);
+    REQUIRE_OK(create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    BOOST_REQUIRE_EQUAL(plan(1).status, rwafi::PlanStatus::PENDING);
+
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(500), "plan:1"));
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::RAISEACTIVE);
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::INVEST_POOL, sing(400), "plan:1"));
+
+    // 900 >= soft cap 800: success without waiting for the deadline
+    const auto p = plan(1);
+    BOOST_CHECK_EQUAL(p.status, rwafi::PlanStatus::SUCCESS);
+    BOOST_CHECK_EQUAL(p.total_raised_funds, sing(900));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, flon::INVEST_POOL, flon::SING_SYM), sing(900));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, flon::STAKE_POOL, st1), asset(90000000000, st1));
+
+    // yield of 100 SING: 80% to stakers, the rest to guarantors / buyback
+    chain.produce(30 * flon::DAY_SECONDS);
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(80));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, flon::VAULT_POOL, flon::SING_SYM), sing(100));
+
+    const asset before = balance(flon::SING_BANK, alice, flon::SING_SYM);
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "claim"_n, alice, alice, (uint64_t)1));
+    const asset got = balance(flon::SING_BANK, alice, flon::SING_SYM) - before;
+    BOOST_CHECK_LE(std::abs(got.amount - sing(80.0 * 500 / 900).amount), 1);
+
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "claim"_n, alice, alice, (uint64_t)1), "no new rewards");
+}
+
+// unstake needs only the owner's authority and pays the pending reward on the stake held before the unstake
+BOOST_FIXTURE_TEST_CASE(unstake_settles_rewards_first, lifecycle_fixture) {
+    const symbol st1 = receipt_sym(1);
+    REQUIRE_OK(create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(500), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::INVEST_POOL, sing(400), "plan:1"));
+    chain.produce(30 * flon::DAY_SECONDS);
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+
+    const asset bob_before = balance(flon::SING_BANK, bob, flon::SING_SYM);
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "unstake"_n, bob, bob, (uint64_t)1, asset(10000000000, st1)));
+    BOOST_CHECK_LE(std::abs((balance(flon::SING_BANK, bob, flon::SING_SYM) - bob_before).amount
+                            - sing(80.0 * 400 / 900).amount), 1);
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, st1), asset(10000000000, st1));
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "claim"_n, bob, bob, (uint64_t)1), "no new rewards");
+
+    // nothing left to settle: the unstake still goes through and pays no reward
+    const asset bob_settled = balance(flon::SING_BANK, bob, flon::SING_SYM);
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "unstake"_n, bob, bob, (uint64_t)1, asset(10000000000, st1)));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, bob, flon::SING_SYM), bob_settled);
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, st1), asset(20000000000, st1));
+
+    // later yield is shared on the reduced stake: 200 of alice's 500
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    const asset bob_mid = balance(flon::SING_BANK, bob, flon::SING_SYM);
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "claim"_n, bob, bob, (uint64_t)1));
+    BOOST_CHECK_LE(std::abs((balance(flon::SING_BANK, bob, flon::SING_SYM) - bob_mid).amount
+                            - sing(80.0 * 200 / 700).amount), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(raise_failure_refunds_through_crank, lifecycle_fixture) {
+    const symbol st1 = receipt_sym(1);
+    REQUIRE_OK(create_plan(st1, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(100), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::INVEST_POOL, sing(50), "plan:1"));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(9900));
+
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)5), "no overdue plan");
+
+    chain.produce(7 * flon::DAY_SECONDS + 1);
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(1), "plan:1"), "period ended");
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+
+    // crank → stake.batchunstake → receipts back to invest → SING back to investors
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::REFUNDED);
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, bob, flon::SING_SYM), sing(10000));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, flon::STAKE_POOL, st1).amount, 0);
+
+    bool saw_batchunstake = false;
+    for (const auto& t : chain.traces())
+        saw_batchunstake |= t.action == "batchunstake"_n && t.depth > 0;
+    BOOST_CHECK(saw_batchunstake);
+}
+
+BOOST_FIXTURE_TEST_CASE(failed_transaction_rolls_back, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    const int64_t ram = chain.ram_usage(flon::INVEST_POOL);
+
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:9"), "no such fund plan");
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "bogus:1"), "unsupported memo");
+
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, flon::INVEST_POOL, flon::SING_SYM).amount, 0);
+    BOOST_CHECK_EQUAL(chain.ram_usage(flon::INVEST_POOL), ram);
+}
+
+// SING of stake / yield / guaranty is held by vault.rwa; pools only move it through the vault
+BOOST_FIXTURE_TEST_CASE(vault_custody_guards, lifecycle_fixture) {
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::YIELD_POOL, sing(10), "plan:1"), "deposit through");
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::VAULT_POOL, sing(10), "plan:1"), "memo must be");
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::VAULT_POOL, sing(10), "bogus/plan:1"), "unknown pool");
+
+    // a token contract other than the receipt bank cannot pose as a buyback payout
+    const name fake = "fake.token"_n;
+    chain.deploy(fake, sim_apply_flontoken);
+    REQUIRE_OK(chain.push(fake, "create"_n, fake, flon::SWAP_POOL, sing(1000)));
+    REQUIRE_OK(chain.push(fake, "issue"_n, flon::SWAP_POOL, flon::SWAP_POOL, sing(1000), "fake"));
+    REQUIRE_FAIL(transfer(fake, flon::SWAP_POOL, flon::VAULT_POOL, sing(10), "buyback"), "unsupported token contract");
+
+    const extended_asset ten(sing(10), flon::SING_BANK);
+    REQUIRE_FAIL(chain.push(flon::VAULT_POOL, "move"_n, alice, flon::GUARANTY_POOL, flon::STAKE_POOL, ten, uint64_t(1)),
+                 "missing authority");
+    REQUIRE_FAIL(chain.push(flon::VAULT_POOL, "withdraw"_n, flon::GUARANTY_POOL, flon::GUARANTY_POOL, flon::STAKE_POOL,
+                            ten, std::string("x")), "use move between pools");
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+}
+
+// SING the pools held themselves before the vault existed moves into their vault ledgers
+BOOST_FIXTURE_TEST_CASE(pool_balance_import, lifecycle_fixture) {
+    for (const name pool : {flon::STAKE_POOL, flon::YIELD_POOL, flon::GUARANTY_POOL}) {
+        chain.deploy(pool, [](uint64_t, uint64_t, uint64_t) {});
+        REQUIRE_OK(transfer(flon::SING_BANK, admin, pool, sing(40), "pre-upgrade"));
+    }
+    chain.deploy(flon::STAKE_POOL,    sim_apply_stakerwa);
+    chain.deploy(flon::YIELD_POOL,    sim_apply_yieldrwa);
+    chain.deploy(flon::GUARANTY_POOL, sim_apply_guarantyrwa);
+
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::VAULT_POOL, sing(1), "stake/migrate"), "invalid memo");
+    for (const name pool : {flon::STAKE_POOL, flon::YIELD_POOL, flon::GUARANTY_POOL}) {
+        REQUIRE_FAIL(chain.push(pool, "migratebal"_n, alice, flon::SING_BANK, flon::SING_SYM), "missing authority");
+        REQUIRE_OK(chain.push(pool, "migratebal"_n, admin, flon::SING_BANK, flon::SING_SYM));
+        REQUIRE_FAIL(chain.push(pool, "migratebal"_n, admin, flon::SING_BANK, flon::SING_SYM), "no balance");
+        BOOST_CHECK_EQUAL(balance(flon::SING_BANK, pool, flon::SING_SYM).amount, 0);
+        BOOST_CHECK_EQUAL(vault_balance(pool, flon::SING_SYM), sing(40));
+    }
+}
+
+// first-loss guarantors absorb the year-1 top-up before the senior tranche; rewards are weighted 1.5 : 1
+BOOST_FIXTURE_TEST_CASE(guarantor_tranches_waterfall, lifecycle_fixture) {
+    const name junior = "junior"_n, senior = "senior"_n;
+    create_account(junior, sing(100));
+    create_account(senior, sing(300));
+
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+
+    REQUIRE_FAIL(transfer(flon::SING_BANK, junior, flon::VAULT_POOL, sing(60), "guaranty/guaranty:1:4"), "invalid tranche");
+    REQUIRE_OK(transfer(flon::SING_BANK, junior, flon::VAULT_POOL, sing(60), "guaranty/guaranty:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, senior, flon::VAULT_POOL, sing(200), "guaranty/guaranty:1:1"));
+    REQUIRE_FAIL(transfer(flon::SING_BANK, junior, flon::VAULT_POOL, sing(10), "guaranty/guaranty:1:1"),
+                 "already in tranche 0");
+
+    // no yield delivered in year 1: the ~72 SING top-up exhausts the first-loss capital first
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+
+    rwafi::guaranty_stats_t::idx_t stats(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const asset used = stats.get(1).used_guarantee_funds.of(flon::SING_SYM);
+    BOOST_REQUIRE_GT(used.amount, sing(60).amount);
+
+    rwafi::guaranty_tranche_t::idx_t tranches(flon::GUARANTY_POOL, 1);
+    BOOST_CHECK_EQUAL(tranches.get(0).absorbed_loss.of(flon::SING_SYM), sing(60));
+    BOOST_CHECK_EQUAL(tranches.get(0).capital.amount, 0);
+    BOOST_CHECK_EQUAL(tranches.get(1).absorbed_loss.of(flon::SING_SYM), used - sing(60));
+    BOOST_CHECK_EQUAL(tranches.get(1).capital.of(flon::SING_SYM), sing(200) - (used - sing(60)));
+
+    // the guarantors' part of a yield deposit is split 60 x 1.5 : 200 x 1
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    rwafi::guaranty_tranche_t::idx_t rewarded(flon::GUARANTY_POOL, 1);
+    const int64_t senior_share = rewarded.get(1).earned_yield.amount;
+    const int64_t reward       = rewarded.get(0).earned_yield.amount + senior_share;
+    BOOST_REQUIRE_GT(reward, 0);
+    BOOST_CHECK_EQUAL(rewarded.get(0).earned_yield.amount, reward * 90 / 290);
+
+    // guarantor rows settle lazily: a top-up by the senior guarantor brings in both indices
+    REQUIRE_OK(transfer(flon::SING_BANK, senior, flon::VAULT_POOL, sing(100), "guaranty/guaranty:1:1"));
+    rwafi::guarantor_stake_t::idx_t stakes(flon::GUARANTY_POOL, 1);
+    const auto& s = stakes.get(senior.value);
+    BOOST_CHECK_LE(std::abs(s.earned_yield.amount - senior_share), 1);
+    BOOST_CHECK_LE(std::abs((s.locked_stake.of(flon::SING_SYM) - (sing(300) - (used - sing(60)))).amount), 1);
+    BOOST_CHECK_EQUAL(stakes.get(junior.value).locked_stake.of(flon::SING_SYM), sing(60));
+}
+
+// share-pool guarantors hold transferable share tokens; top-ups and rewards only move the pool's exchange rate
+BOOST_FIXTURE_TEST_CASE(guarantor_share_pool, lifecycle_fixture) {
+    const name junior = "junior"_n, carol = "carol"_n;
+    const symbol gsh("GSH", 8);
+    create_account(junior, sing(100));
+    create_account(carol);
+
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+
+    REQUIRE_FAIL(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(300), "guaranty/share:1"), "no share pool");
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "openshares"_n, bob, bob, (uint64_t)1, gsh.code()), "no auth");
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "openshares"_n, creator, creator, (uint64_t)1, gsh.code()));
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "openshares"_n, admin, admin, (uint64_t)1, gsh.code()), "already opened");
+
+    // first subscription mints 1:1; shares move between holders like any token
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(300), "guaranty/share:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, junior, flon::VAULT_POOL, sing(100), "guaranty/guaranty:1"));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, gsh), asset(sing(300).amount, gsh));
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, bob, carol, asset(sing(100).amount, gsh), "gift"));
+
+    // no yield in year 1: the top-up is shared by pool assets and tranche capital 300 : 100
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+
+    rwafi::guaranty_stats_t::idx_t stats(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const int64_t used = stats.get(1).used_guarantee_funds.amount;
+    BOOST_REQUIRE_GT(used, 0);
+
+    rwafi::guaranty_share_t::idx_t pools(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const int64_t pool_loss = used * 3 / 4;
+    BOOST_CHECK_EQUAL(pools.get(1).absorbed_loss.amount, pool_loss);
+    BOOST_CHECK_EQUAL(pools.get(1).assets.amount, sing(300).amount - pool_loss);
+    BOOST_CHECK_EQUAL(pools.get(1).shares.amount, sing(300).amount);
+    rwafi::guaranty_tranche_t::idx_t tranches(flon::GUARANTY_POOL, 1);
+    BOOST_CHECK_EQUAL(tranches.get(0).absorbed_loss.amount, used - pool_loss);
+
+    // guarantors' reward: pool assets at 1x against the first-loss tranche at 1.5x; the pool keeps the remainder
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    rwafi::guaranty_share_t::idx_t rewarded(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    rwafi::guaranty_tranche_t::idx_t rewarded_tranches(flon::GUARANTY_POOL, 1);
+    const int64_t pool_reward    = rewarded.get(1).earned_yield.amount;
+    const int64_t tranche_reward = rewarded_tranches.get(0).earned_yield.amount;
+    BOOST_REQUIRE_GT(pool_reward, 0);
+    BOOST_CHECK_EQUAL(rewarded.get(1).assets.amount, sing(300).amount - pool_loss + pool_reward);
+    BOOST_CHECK_EQUAL(tranche_reward, flon::muldiv(pool_reward + tranche_reward, (int128_t)sing(100).amount * 15000,
+        (int128_t)(sing(300).amount - pool_loss) * 10000 + (int128_t)sing(100).amount * 15000));
+
+    // in progress the pool is below the 50% line: no redemption
+    REQUIRE_FAIL(transfer(flon::RECEIPT_BANK, bob, flon::GUARANTY_POOL, asset(sing(50).amount, gsh), "redeem:1"),
+                 "below 50%");
+
+    // after the return period shares burn at the rate left by the final top-up
+    chain.produce(2 * 366 * flon::DAY_SECONDS);
+    const asset before = balance(flon::SING_BANK, bob, flon::SING_SYM);
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, bob, flon::GUARANTY_POOL, asset(sing(200).amount, gsh), "redeem:1"));
+    const int64_t paid = (balance(flon::SING_BANK, bob, flon::SING_SYM) - before).amount;
+
+    rwafi::guaranty_share_t::idx_t redeemed(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const auto& pool = redeemed.get(1);
+    BOOST_CHECK_EQUAL(pool.shares.amount, sing(100).amount);
+    BOOST_CHECK_EQUAL(paid, flon::muldiv(sing(200).amount, pool.assets.amount + paid, sing(300).amount));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, gsh).amount, 0);
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, flon::GUARANTY_POOL, gsh).amount, 0);
+}
+
+// a top-up that drains the share pool leaves it reopenable under a new share symbol at 1:1
+BOOST_FIXTURE_TEST_CASE(share_pool_reopen, lifecycle_fixture) {
+    const symbol gsh("GSH", 8), gsb("GSB", 8);
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "openshares"_n, creator, creator, (uint64_t)1, gsh.code()));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(10), "guaranty/share:1"));
+
+    // the ~72 SING year-1 top-up takes all 10 SING of pool assets
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+    rwafi::guaranty_share_t::idx_t pools(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    BOOST_REQUIRE_EQUAL(pools.get(1).assets.amount, 0);
+
+    REQUIRE_FAIL(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(50), "guaranty/share:1"), "share pool exhausted");
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "openshares"_n, creator, creator, (uint64_t)1, gsh.code()),
+                 "new share symbol");
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "openshares"_n, creator, creator, (uint64_t)1, gsb.code()));
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "openshares"_n, creator, creator, (uint64_t)1, gsh.code()),
+                 "already opened");
+
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(50), "guaranty/share:1"));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, bob, gsb), asset(sing(50).amount, gsb));
+    rwafi::guaranty_share_t::idx_t reopened(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    BOOST_CHECK_EQUAL(reopened.get(1).shares.amount, sing(50).amount);
+    BOOST_CHECK_EQUAL(reopened.get(1).assets.amount, sing(50).amount);
+
+    // the orphaned shares no longer redeem against the new assets
+    REQUIRE_FAIL(transfer(flon::RECEIPT_BANK, bob, flon::GUARANTY_POOL, asset(sing(10).amount, gsh), "redeem:1"),
+                 "share symbol mismatch");
+}
+
+// a registered operator settles the stakers that granted it claims in one action and receives a single aggregated payout
+BOOST_FIXTURE_TEST_CASE(operator_claimfor, lifecycle_fixture) {
+    const name custodian = "custodian"_n, payout = "custpayout"_n;
+    create_account(custodian);
+    create_account(payout);
+
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    std::vector<name> owners;
+    for (uint32_t i = 0; i < 9; ++i) {
+        const name u = participant("user", i);
+        create_account(u, sing(100));
+        REQUIRE_OK(transfer(flon::SING_BANK, u, flon::INVEST_POOL, sing(100), "plan:1"));
+        owners.push_back(u);
+    }
+    chain.produce(30 * flon::DAY_SECONDS);
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(90), "yield/plan:1"));
+
+    const auto claimfor = [&](name op, const std::vector<name>& list) {
+        return chain.push(flon::STAKE_POOL, "claimfor"_n, op, op, (uint64_t)1, list);
+    };
+    REQUIRE_FAIL(claimfor(custodian, owners), "not a registered operator");
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "setoperator"_n, custodian, custodian, payout), "missing authority");
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "setoperator"_n, admin, custodian, payout));
+    REQUIRE_FAIL(claimfor(custodian, {}), "owners must be");
+
+    // every owner opts in; one without a grant fails the whole batch
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "grantclaim"_n, custodian, owners[0], custodian), "missing authority");
+    for (size_t i = 0; i + 1 < owners.size(); ++i)
+        REQUIRE_OK(chain.push(flon::STAKE_POOL, "grantclaim"_n, owners[i], owners[i], custodian));
+    REQUIRE_FAIL(claimfor(custodian, owners), "has not granted claims");
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "grantclaim"_n, owners.back(), owners.back(), custodian));
+    REQUIRE_FAIL(claimfor(custodian, {bob}), "has not granted claims");
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "grantclaim"_n, bob, bob, custodian));
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "grantclaim"_n, bob, bob, custodian), "claims already granted");
+    REQUIRE_FAIL(claimfor(custodian, {bob}), "no new rewards");
+
+    // the first user claims on their own and bob never staked; the batch skips both and pays the rest in one transfer
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "claim"_n, owners[0], owners[0], (uint64_t)1));
+    std::vector<name> batch = owners;
+    batch.push_back(bob);
+    REQUIRE_OK(claimfor(custodian, batch));
+    size_t payouts = 0;
+    for (const auto& t : chain.traces())
+        payouts += t.receiver == flon::VAULT_POOL && t.action == "withdraw"_n;
+    BOOST_CHECK_EQUAL(payouts, 1u);
+    BOOST_CHECK_LE(std::abs((balance(flon::SING_BANK, payout, flon::SING_SYM) - sing(64)).amount), 8);
+    REQUIRE_FAIL(claimfor(custodian, owners), "no new rewards");
+
+    // grants name the payout they were given for: a new payout needs every owner to grant again
+    const name payout2 = "custpayout2"_n;
+    create_account(payout2);
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "setoperator"_n, admin, custodian, payout2));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(90), "yield/plan:1"));
+    REQUIRE_FAIL(claimfor(custodian, owners), "must grant claims again");
+    for (const auto& o : owners)
+        REQUIRE_OK(chain.push(flon::STAKE_POOL, "grantclaim"_n, o, o, custodian));
+    REQUIRE_OK(claimfor(custodian, owners));
+    BOOST_CHECK_LE(std::abs((balance(flon::SING_BANK, payout2, flon::SING_SYM) - sing(72)).amount), 9);
+
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "revokeclaim"_n, owners[1], owners[1], custodian));
+    REQUIRE_FAIL(claimfor(custodian, owners), "has not granted claims");
+
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "deloperator"_n, admin, custodian));
+    REQUIRE_FAIL(claimfor(custodian, owners), "not a registered operator");
+}
+
+// an allowlisted plan takes investments only after a merkle proof; the pass row is consumed by the investment
+BOOST_FIXTURE_TEST_CASE(allowlisted_plan_requires_proof, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+
+    std::vector<name> kyc;
+    for (uint32_t i = 0; i < 37; ++i) {
+        kyc.push_back(participant("kyc", i));
+        create_account(kyc.back(), sing(20));
+    }
+    kyc.push_back(alice);
+    const merkle_tree tree(kyc);
+    const auto prove = [&](name investor, const std::vector<checksum256>& proof) {
+        return chain.push(flon::INVEST_POOL, "prove"_n, investor, investor, (uint64_t)1, proof);
+    };
+
+    REQUIRE_FAIL(prove(alice, tree.proofs.back()), "plan has no allowlist");
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "setallowlist"_n, bob, bob, (uint64_t)1, tree.root),
+                 "no auth to set allowlist");
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "setallowlist"_n, creator, creator, (uint64_t)1, tree.root));
+
+    // no proof, a proof for someone else, or a reused pass are all rejected
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:1"), "investor not proven");
+    REQUIRE_FAIL(prove(bob, tree.proofs.back()), "not in plan allowlist");
+    REQUIRE_FAIL(prove(alice, std::vector<checksum256>(33, tree.root)), "proof deeper than");
+
+    REQUIRE_OK(prove(alice, tree.proofs.back()));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:1"));
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:1"), "investor not proven");
+
+    // a pass only holds under the root it was proven against
+    REQUIRE_OK(prove(alice, tree.proofs.back()));
+    REQUIRE_OK(prove(kyc[0], tree.proofs[0]));
+    const merkle_tree rotated(std::vector<name>(kyc.begin(), kyc.end() - 1));
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "setallowlist"_n, creator, creator, (uint64_t)1, rotated.root));
+    REQUIRE_FAIL(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:1"), "allowlist changed since proof");
+    REQUIRE_FAIL(prove(alice, tree.proofs.back()), "not in plan allowlist");
+    REQUIRE_FAIL(transfer(flon::SING_BANK, kyc[0], flon::INVEST_POOL, sing(20), "plan:1"), "allowlist changed since proof");
+    REQUIRE_OK(prove(kyc[0], rotated.proofs[0]));
+    REQUIRE_OK(transfer(flon::SING_BANK, kyc[0], flon::INVEST_POOL, sing(20), "plan:1"));
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "setallowlist"_n, creator, creator, (uint64_t)1, tree.root));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(10), "plan:1"));
+
+    for (size_t i = 1; i + 1 < kyc.size(); ++i) {
+        REQUIRE_OK(prove(kyc[i], tree.proofs[i]));
+        REQUIRE_OK(transfer(flon::SING_BANK, kyc[i], flon::INVEST_POOL, sing(20), "plan:1"));
+    }
+    BOOST_CHECK_EQUAL(plan(1).total_raised_funds, sing(10 + 10 + 37 * 20));
+    // no per-investor rows stay behind in invest.rwa
+    rwafi::invest_pass_t::idx_t passes(flon::INVEST_POOL, 1);
+    BOOST_CHECK(passes.begin() == passes.end());
+
+    // an all-zero root lifts the allowlist
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "setallowlist"_n, admin, admin, (uint64_t)1, checksum256()));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::INVEST_POOL, sing(10), "plan:1"));
+}
+
+// 30 monthly distributions: only the last YIELD_LOG_WINDOW months stay in RAM, totals keep the rest
+BOOST_FIXTURE_TEST_CASE(yield_history_window, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 48));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+
+    constexpr int months = 30;
+    const uint32_t start = chain.now().sec_since_epoch();
+    int64_t ram_at_window = 0;
+    for (int m = 0; m < months; ++m) {
+        chain.set_time(time_point_sec(flon::calendar::add_months(start, m + 1)));
+        REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/plan:1"));
+        bool logged = false;
+        for (const auto& t : chain.traces())
+            logged |= t.receiver == flon::YIELD_POOL && t.action == "logyield"_n;
+        BOOST_CHECK(logged);
+        if (m == rwafi::YIELD_LOG_WINDOW) ram_at_window = chain.ram_usage(flon::YIELD_POOL);
+    }
+    // rolling window: RAM stops growing once the window is full
+    BOOST_CHECK_EQUAL(chain.ram_usage(flon::YIELD_POOL), ram_at_window);
+
+    rwafi::yield_log_t::idx_t logs(flon::YIELD_POOL, 1);
+    BOOST_CHECK_EQUAL(std::distance(logs.begin(), logs.end()), rwafi::YIELD_LOG_WINDOW);
+    BOOST_CHECK_EQUAL(logs.rbegin()->cumulative_yield.amount, sing(10 * months).amount);
+
+    rwafi::yield_total_t::idx_t totals(flon::YIELD_POOL, flon::YIELD_POOL.value);
+    const auto& t = totals.get(1);
+    BOOST_CHECK_EQUAL(t.total_yield.amount, sing(10 * months).amount);
+    BOOST_CHECK_EQUAL(t.investor_yield.amount + t.guarantor_yield.amount + t.buyback_yield.amount,
+                      t.total_yield.amount);
+    BOOST_CHECK_EQUAL(t.periods, (uint32_t)months);
+    BOOST_CHECK_LT(t.first_period, logs.begin()->period);
+
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "logyield"_n, admin, (uint64_t)1, t.last_period, sing(1), sing(1),
+                            sing(0), sing(0), sing(1)), "missing authority");
+}
+
+// one credit transfer funds several plans; each destination pool gets a single batched move
+BOOST_FIXTURE_TEST_CASE(batched_yield_distribution, lifecycle_fixture) {
+    for (uint64_t id = 1; id <= 3; ++id) {
+        REQUIRE_OK(create_plan(receipt_sym(id), sing(1000), 7 * flon::DAY_SECONDS));
+        REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:" + std::to_string(id)));
+    }
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(500), "guaranty/guaranty:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(300), "yield/credit"));
+
+    using allocs_t = std::vector<flon::plan_alloc_t>;
+    const auto distribute = [&](name signer, const allocs_t& allocs) {
+        return chain.push(flon::YIELD_POOL, "distribute"_n, signer, admin, allocs);
+    };
+    REQUIRE_FAIL(distribute(alice, {{1, sing(10)}}), "missing authority");
+    REQUIRE_FAIL(distribute(admin, {{1, sing(400)}}), "insufficient yield credit");
+    REQUIRE_FAIL(distribute(admin, {{1, sing(10)}, {9, sing(10)}}), "plan not found");
+    REQUIRE_FAIL(distribute(admin, allocs_t(51, {1, sing(1)})), "too many plans");  // MAX_DISTRIBUTE_PLANS + 1
+
+    REQUIRE_OK(distribute(admin, {{1, sing(100)}, {2, sing(100)}, {3, sing(50)}}));
+    size_t batches = 0, single_moves = 0, addyields = 0;
+    for (const auto& t : chain.traces()) {
+        if (t.receiver != flon::VAULT_POOL && t.receiver != flon::GUARANTY_POOL) continue;
+        batches      += t.action == "movebatch"_n && t.receiver == flon::VAULT_POOL;
+        single_moves += t.action == "move"_n && t.receiver == flon::VAULT_POOL;
+        addyields    += t.action == "addyields"_n;
+    }
+    BOOST_CHECK_EQUAL(batches, 1u);         // three plans to stake
+    BOOST_CHECK_EQUAL(single_moves, 1u);    // only plan 1 has guarantors
+    BOOST_CHECK_EQUAL(addyields, 1u);
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(200));
+    BOOST_CHECK_EQUAL(vault_balance(flon::GUARANTY_POOL, flon::SING_SYM), sing(510));
+
+    rwafi::yield_total_t::idx_t totals(flon::YIELD_POOL, flon::YIELD_POOL.value);
+    BOOST_CHECK_EQUAL(totals.get(3).total_yield.amount, sing(50).amount);
+    BOOST_CHECK_EQUAL(totals.get(1).guarantor_yield.amount, sing(10).amount);
+
+    // 50 SING of credit left
+    REQUIRE_FAIL(distribute(admin, {{2, sing(60)}}), "insufficient yield credit");
+    REQUIRE_OK(distribute(admin, {{2, sing(50)}}));
+    REQUIRE_FAIL(distribute(admin, {{2, sing(1)}}), "no yield credit");
+}
+
+// with a flush interval the stake / guaranty shares accrue in yield.rwa and leave in one move per pool
+BOOST_FIXTURE_TEST_CASE(deferred_share_flush, lifecycle_fixture) {
+    for (uint64_t id = 1; id <= 2; ++id) {
+        REQUIRE_OK(create_plan(receipt_sym(id), sing(1000), 7 * flon::DAY_SECONDS));
+        REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:" + std::to_string(id)));
+    }
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "setflush"_n, alice, (uint32_t)3600), "missing authority");
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "setflush"_n, admin, (uint32_t)3600));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "flush"_n, keeper, (uint16_t)10), "nothing to flush");
+
+    for (int i = 0; i < 3; ++i)
+        for (uint64_t id = 1; id <= 2; ++id)
+            REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/plan:" + std::to_string(id)));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(0));
+
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "flush"_n, keeper, (uint16_t)10));
+    size_t moves = 0;
+    for (const auto& t : chain.traces())
+        moves += t.receiver == flon::VAULT_POOL && (t.action == "move"_n || t.action == "movebatch"_n);
+    BOOST_CHECK_EQUAL(moves, 1u);
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(48));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "flush"_n, keeper, (uint16_t)10), "nothing to flush");
+
+    // once the oldest share is older than the interval, the next deposit flushes on its own
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/plan:1"));
+    chain.produce(3600);
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/plan:2"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(64));
+
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "setflush"_n, admin, (uint32_t)0));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(72));
+}
+
+// yield still waiting for a flush already counts as delivered: the year-end top-up has nothing to cover
+BOOST_FIXTURE_TEST_CASE(deferred_share_counts_as_delivered, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(500), "guaranty/guaranty:1"));
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "setflush"_n, admin, (uint32_t)(400 * flon::DAY_SECONDS)));
+
+    // the investors' part (> 72 SING, 900 x 8%) stays pending in yield.rwa
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(0));
+
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+    rwafi::guaranty_stats_t::idx_t stats(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    BOOST_CHECK_EQUAL(stats.get(1).used_guarantee_funds.amount, 0);
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(0));
+
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "flush"_n, keeper, (uint16_t)10));
+    BOOST_CHECK_GE(vault_balance(flon::STAKE_POOL, flon::SING_SYM).amount, sing(72).amount);
+}
+
+// a top-up attempted while the plan is still raising must not skip the accrual that starts at start_time
+BOOST_FIXTURE_TEST_CASE(accrual_starts_at_plan_start, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 400 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(500), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(200), "guaranty/guaranty:1"));
+
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM).amount, 0);
+
+    // once the plan succeeds, year 1 is owed in full: 900 x 8%
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::INVEST_POOL, sing(400), "plan:1"));
+    BOOST_REQUIRE_EQUAL(plan(1).status, rwafi::PlanStatus::SUCCESS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(72));
+}
+
+// guaranty pushes the plan coverage to yield on every change of the guarantee pool; yield only reads its cache
+BOOST_FIXTURE_TEST_CASE(coverage_push_cache, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS, 24));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+
+    const auto coverage = [&]() -> int64_t {
+        rwafi::plan_coverage_t::idx_t covers(flon::YIELD_POOL, flon::YIELD_POOL.value);
+        auto it = covers.find(1);
+        return it == covers.end() ? -1 : it->coverage_bps;
+    };
+    const auto pushes = [&] {
+        size_t n = 0;
+        for (const auto& t : chain.traces())
+            n += t.receiver == flon::YIELD_POOL && t.action == "setcoverage"_n;
+        return n;
+    };
+    BOOST_CHECK_EQUAL(coverage(), -1);
+
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(200), "guaranty/guaranty:1"));
+    BOOST_CHECK_EQUAL(coverage(), 4000);
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(300), "guaranty/guaranty:1"));
+    BOOST_CHECK_EQUAL(coverage(), 10000);
+
+    // unchanged coverage (already capped) is not pushed again
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(10), "guaranty/guaranty:1"));
+    BOOST_CHECK_EQUAL(pushes(), 0u);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "synccover"_n, alice, (uint64_t)1));
+    BOOST_CHECK_EQUAL(pushes(), 0u);
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "setcoverage"_n, admin, (uint64_t)1, (uint16_t)0), "missing authority");
+
+    // no yield in year 1: the top-up is deducted from the pool and the lower coverage is pushed
+    chain.produce(366 * flon::DAY_SECONDS);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "guarantpay"_n, admin, admin, (uint64_t)1, (uint64_t)1));
+    rwafi::guaranty_stats_t::idx_t stats(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const int64_t funds = stats.get(1).total_guarantee_funds.amount;
+    BOOST_REQUIRE_LT(funds, sing(500).amount);
+    BOOST_CHECK_EQUAL(pushes(), 1u);
+    BOOST_CHECK_EQUAL(coverage(), rwafi::plan_coverage_t::bps_of(funds, sing(1000).amount));
+
+    // the guarantors' share follows the cached coverage: 100 x 10% x coverage
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    rwafi::yield_total_t::idx_t totals(flon::YIELD_POOL, flon::YIELD_POOL.value);
+    BOOST_CHECK_EQUAL(totals.get(1).guarantor_yield.amount,
+                      sing(10).amount * coverage() / 10000);
+}
+
+// fixed bps split: a per-plan override wins over the default, removing it falls back
+BOOST_FIXTURE_TEST_CASE(yield_split_overrides, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    const auto setsplit = [&](name signer, uint64_t plan_id, uint16_t stake, uint16_t guar, uint16_t swap) {
+        return chain.push(flon::YIELD_POOL, "setsplit"_n, signer, plan_id, stake, guar, swap);
+    };
+
+    REQUIRE_FAIL(setsplit(alice, 1, 7000, 1000, 2000), "missing authority");
+    REQUIRE_FAIL(setsplit(admin, 1, 7000, 1000, 1000), "must sum to 10000");
+    REQUIRE_FAIL(setsplit(admin, 2, 7000, 1000, 2000), "plan not found");
+    REQUIRE_OK(setsplit(admin, 1, 7000, 1000, 2000));
+
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(70));
+
+    REQUIRE_OK(setsplit(admin, 0, 9000, 0, 1000));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(140));
+
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "delsplit"_n, admin, (uint64_t)1));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "delsplit"_n, admin, (uint64_t)1), "no split override");
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    BOOST_CHECK_EQUAL(vault_balance(flon::STAKE_POOL, flon::SING_SYM), sing(230));
+}
+
+// a chunk the market cannot fill parks the plan instead of failing the whole crank, and parking earns no keeper fee
+BOOST_FIXTURE_TEST_CASE(crank_parks_unfillable_buyback, lifecycle_fixture) {
+    const symbol st = receipt_sym(1);
+    const name   tp = "stsing"_n;
+    REQUIRE_OK(create_plan(st, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+
+    // one receipt unit against 1000 SING: no buyback chunk gets out a whole unit
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "unstake"_n, alice, alice, (uint64_t)1, asset(1, st)));
+    REQUIRE_OK(chain.push(flon::SWAP_POOL, "addmarket"_n, flon::SWAP_POOL, tp,
+                          extended_symbol(st, flon::RECEIPT_BANK), extended_symbol(flon::SING_SYM, flon::SING_BANK),
+                          (uint16_t)30));
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, alice, flon::SWAP_POOL, asset(1, st), "deposit:" + tp.to_string()));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::SWAP_POOL, sing(1000), "deposit:" + tp.to_string()));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "observe"_n, keeper, (uint64_t)1), "missing authority");
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "observe"_n, admin, (uint64_t)1));
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "setkeeper"_n, admin, sing(1)));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(10), "yield/keeper"));
+    chain.produce(60);
+
+    const asset fees = balance(flon::SING_BANK, keeper, flon::SING_SYM);
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, keeper, flon::SING_SYM), fees);
+    eosio::multi_index<"buybacks"_n, buyback_row> buybacks(flon::YIELD_POOL, flon::YIELD_POOL.value);
+    BOOST_CHECK(buybacks.get(1).next_buyback_at == time_point_sec::maximum());
+    BOOST_CHECK_EQUAL(buybacks.get(1).used_buyback, 0);
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "crank"_n, keeper, keeper, (uint16_t)5), "no pending buyback");
+
+    // an explicit buyback still reports why
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "buyback"_n, admin, admin, (uint64_t)1), "too small");
+}
+
+// a pushed-up spot is turned away by the TWAP guard and never enters the price history
+BOOST_FIXTURE_TEST_CASE(crank_does_not_record_spot, lifecycle_fixture) {
+    const symbol st = receipt_sym(1);
+    const name   tp = "stsing"_n;
+    REQUIRE_OK(create_plan(st, sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "unstake"_n, alice, alice, (uint64_t)1, asset(5000000000, st)));
+    REQUIRE_OK(chain.push(flon::SWAP_POOL, "addmarket"_n, flon::SWAP_POOL, tp,
+                          extended_symbol(st, flon::RECEIPT_BANK), extended_symbol(flon::SING_SYM, flon::SING_BANK),
+                          (uint16_t)30));
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, alice, flon::SWAP_POOL, asset(5000000000, st), "deposit:" + tp.to_string()));
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::SWAP_POOL, sing(50), "deposit:" + tp.to_string()));
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "observe"_n, admin, (uint64_t)1));
+    using oracles_t = eosio::multi_index<"priceoracle"_n, oracle_row>;
+    const oracle_row before = oracles_t(flon::YIELD_POOL, flon::YIELD_POOL.value).get(tp.value);
+    chain.produce(60);
+
+    // the price of a receipt jumps twentyfold right before the crank
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::SWAP_POOL, sing(1000), "deposit:" + tp.to_string()));
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+
+    eosio::multi_index<"buybacks"_n, buyback_row> buybacks(flon::YIELD_POOL, flon::YIELD_POOL.value);
+    BOOST_CHECK_EQUAL(buybacks.get(1).used_buyback, 0);
+    const oracle_row after = oracles_t(flon::YIELD_POOL, flon::YIELD_POOL.value).get(tp.value);
+    BOOST_CHECK(after.last_price == before.last_price);
+    BOOST_CHECK_EQUAL(after.last_observed_at, before.last_observed_at);
+}
+
+// the percentage-map global converts to bps; the buyback share stays the remainder
+BOOST_FIXTURE_TEST_CASE(yield_conf_migration, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    chain.deploy(flon::YIELD_POOL, seed_old_yield_conf);
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "seed"_n, flon::YIELD_POOL));
+    chain.deploy(flon::YIELD_POOL, sim_apply_yieldrwa);
+
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "migrateconf"_n, admin), "missing authority");
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "migrateconf"_n, flon::YIELD_POOL));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "migrateconf"_n, flon::YIELD_POOL), "no legacy config");
+
+    const auto g = eosio::singleton<"yieldconf"_n, yield_conf>(flon::YIELD_POOL, flon::YIELD_POOL.value).get();
+    BOOST_CHECK_EQUAL(g.admin, admin);
+    BOOST_CHECK_EQUAL(g.stake_bps, 6000);
+    BOOST_CHECK_EQUAL(g.guaranty_bps, 1000);
+    BOOST_CHECK_EQUAL(g.swap_bps, 3000);
+    BOOST_CHECK_EQUAL(g.twap_window, 1800u);
+
+    // yield booked before the move would start a fresh buyback row next to the baseline one
+    REQUIRE_FAIL(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"),
+                 "plan buyback pending migration");
+    REQUIRE_OK(chain.push(flon::YIELD_POOL, "migratebuys"_n, admin, (uint16_t)10));
+    REQUIRE_FAIL(chain.push(flon::YIELD_POOL, "migratebuys"_n, admin, (uint16_t)10), "no legacy buyback");
+    const auto b = eosio::multi_index<"buybacks"_n, buyback_row>(flon::YIELD_POOL, flon::YIELD_POOL.value).get(1);
+    BOOST_CHECK_EQUAL(b.total_buyback - b.used_buyback, 30);
+    BOOST_CHECK_EQUAL(b.total_voucher, asset(7, receipt_sym(1)));
+    BOOST_CHECK_EQUAL(b.next_buyback_at.sec_since_epoch(), 0u);
+    BOOST_CHECK_EQUAL(b.chunk_size, 0);
+
+    REQUIRE_OK(transfer(flon::SING_BANK, admin, flon::VAULT_POOL, sing(100), "yield/plan:1"));
+    const auto booked = eosio::multi_index<"buybacks"_n, buyback_row>(flon::YIELD_POOL, flon::YIELD_POOL.value).get(1);
+    BOOST_CHECK(booked.total_buyback > b.total_buyback);
+    BOOST_CHECK_EQUAL(booked.used_buyback, b.used_buyback);
+}
+
+// baseline rows move to the compact tables in bounded batches; guarantors join the first-loss tranche
+BOOST_FIXTURE_TEST_CASE(guaranty_compact_migration, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(900), "plan:1"));
+    BOOST_REQUIRE_EQUAL(plan(1).status, rwafi::PlanStatus::SUCCESS);
+
+    chain.deploy(flon::GUARANTY_POOL, seed_old_guaranty);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "seed"_n, flon::GUARANTY_POOL));
+    chain.deploy(flon::GUARANTY_POOL, sim_apply_guarantyrwa);
+
+    // a deposit before the move would start a fresh stats row next to the baseline one
+    REQUIRE_FAIL(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(10), "guaranty/guaranty:1"),
+                 "plan stats pending migration");
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "migratestats"_n, alice, (uint16_t)10), "missing authority");
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "migratestats"_n, admin, (uint16_t)10));
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "migratestats"_n, admin, (uint16_t)10), "no legacy stats");
+
+    rwafi::guaranty_stats_t::idx_t stats(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+    const auto& s = stats.get(1);
+    BOOST_CHECK_EQUAL(s.total_guarantee_funds.of(flon::SING_SYM), asset(600, flon::SING_SYM));
+    BOOST_CHECK_EQUAL(s.shortfall(), 0);
+    BOOST_CHECK(s.last_accrued_at == time_point_sec(chain.now()));
+    BOOST_CHECK_EQUAL(s.next_pay_year, 1);
+    BOOST_CHECK(s.next_pay_at > s.last_accrued_at);
+
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "migratestake"_n, admin, (uint64_t)1, (uint16_t)2));
+    eosio::multi_index<"stakes"_n, old_stake_row> old_stakes(flon::GUARANTY_POOL, 1);
+    BOOST_CHECK_EQUAL(std::distance(old_stakes.begin(), old_stakes.end()), 1);
+
+    // between batches the tranche holds only part of the stake: the plan is frozen
+    chain.create_account(name(1));
+    REQUIRE_FAIL(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(10), "guaranty/guaranty:1"),
+                 "plan guarantors pending migration");
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "redeem"_n, name(1), name(1), (uint64_t)1, asset(1, flon::SING_SYM)),
+                 "plan guarantors pending migration");
+    chain.produce(s.next_pay_at.sec_since_epoch() - chain.now().sec_since_epoch() + 1);
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "crank"_n, admin, admin, (uint16_t)5));
+    {
+        rwafi::guaranty_stats_t::idx_t held(flon::GUARANTY_POOL, flon::GUARANTY_POOL.value);
+        BOOST_CHECK_EQUAL(held.get(1).next_pay_year, 1);
+        BOOST_CHECK_EQUAL(held.get(1).used_guarantee_funds.amount, 0);
+    }
+
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "migratestake"_n, admin, (uint64_t)1, (uint16_t)2));
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "migratestake"_n, admin, (uint64_t)1, (uint16_t)2), "no legacy stakes");
+
+    rwafi::guarantor_stake_t::idx_t stakes(flon::GUARANTY_POOL, 1);
+    for (uint64_t i = 1; i <= 3; ++i) {
+        const auto& g = stakes.get(i);
+        BOOST_CHECK_EQUAL(g.total_stake.amount, 100 * i);
+        BOOST_CHECK_EQUAL(g.locked_stake.amount, 90 * i);
+        BOOST_CHECK_EQUAL(g.withdrawn.amount, i);
+        BOOST_CHECK_EQUAL(g.tranche, 0);
+        BOOST_CHECK(g.reward_index == 0);
+    }
+    rwafi::guaranty_tranche_t::idx_t tranches(flon::GUARANTY_POOL, 1);
+    BOOST_CHECK_EQUAL(std::distance(tranches.begin(), tranches.end()), 1);
+    BOOST_CHECK_EQUAL(tranches.get(0).total_stake.amount, 600);
+    BOOST_CHECK_EQUAL(tranches.get(0).capital.amount, 540);
+
+    // the whole plan has moved: deposits go through again
+    REQUIRE_OK(transfer(flon::SING_BANK, bob, flon::VAULT_POOL, sing(10), "guaranty/guaranty:1"));
+}
+
+// baseline globals and plan rows are read in place; migrated plans join the crank indexes
+BOOST_FIXTURE_TEST_CASE(baseline_conf_and_plan_migration, lifecycle_fixture) {
+    REQUIRE_OK(create_plan(receipt_sym(1), sing(1000), 7 * flon::DAY_SECONDS));
+    REQUIRE_OK(transfer(flon::SING_BANK, alice, flon::INVEST_POOL, sing(100), "plan:1"));
+
+    const std::pair<name, void (*)(uint64_t, uint64_t, uint64_t)> seeds[] = {
+        {flon::INVEST_POOL,   seed_old_invest},
+        {flon::STAKE_POOL,    seed_old_stake},
+        {flon::GUARANTY_POOL, seed_old_guaranty_conf},
+    };
+    for (const auto& [pool, seed] : seeds) {
+        chain.deploy(pool, seed);
+        REQUIRE_OK(chain.push(pool, "seed"_n, pool));
+    }
+    chain.deploy(flon::INVEST_POOL,   sim_apply_investrwa);
+    chain.deploy(flon::STAKE_POOL,    sim_apply_stakerwa);
+    chain.deploy(flon::GUARANTY_POOL, sim_apply_guarantyrwa);
+    chain.produce(7 * flon::DAY_SECONDS + 1);
+
+    // the baseline plan row has no bydeadline entry: the crank cannot see it, and moving its key fails
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)5), "no overdue plan");
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "cancelplan"_n, creator, creator, (uint64_t)1),
+                 "secondary index entry missing");
+
+    // the baseline globals read in place, so the admin is known before migrateconf rewrites them
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "migrateconf"_n, alice), "no auth");
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "migrateconf"_n, admin));
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "migrateconf"_n, admin));
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "migrateplans"_n, alice, (uint16_t)10), "no auth");
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "migrateplans"_n, admin, (uint16_t)10));
+    REQUIRE_FAIL(chain.push(flon::INVEST_POOL, "migrateplans"_n, admin, (uint16_t)10), "no legacy plans");
+
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "migrateconf"_n, admin));
+    REQUIRE_OK(chain.push(flon::STAKE_POOL, "migratepools"_n, admin, (uint16_t)10));
+    REQUIRE_FAIL(chain.push(flon::STAKE_POOL, "migratepools"_n, admin, (uint16_t)10), "no legacy plans");
+    REQUIRE_FAIL(chain.push(flon::GUARANTY_POOL, "migrateconf"_n, alice), "missing authority");
+    REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "migrateconf"_n, admin));
+
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::RAISEACTIVE);
+    REQUIRE_OK(create_plan(receipt_sym(2), sing(1000), 7 * flon::DAY_SECONDS));
+    BOOST_CHECK_EQUAL(plan(2).id, 2u);
+
+    REQUIRE_OK(chain.push(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+    BOOST_CHECK_EQUAL(plan(1).status, rwafi::PlanStatus::REFUNDED);
+    BOOST_CHECK_EQUAL(balance(flon::SING_BANK, alice, flon::SING_SYM), sing(10000));
+}
+
+// 20 plans x 20 investors, half of them failing: a full run stays in the millisecond range
+BOOST_FIXTURE_TEST_CASE(many_plans, lifecycle_fixture) {
+    constexpr int plans = 20, investors = 20;
+    std::vector<name> users;
+    for (int i = 0; i < investors; ++i) {
+        users.emplace_back("inv" + std::string(1, char('a' + i)));
+        create_account(users.back(), sing(10000));
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int p = 1; p <= plans; ++p)
+        REQUIRE_OK(create_plan(receipt_sym(p), sing(investors * 100), 7 * flon::DAY_SECONDS));
+
+    for (int p = 1; p <= plans; ++p)
+        for (int i = 0; i < (p % 2 ? investors : investors / 2); ++i)
+            REQUIRE_OK(transfer(flon::SING_BANK, users[i], flon::INVEST_POOL, sing(100), "plan:" + std::to_string(p)));
+
+    chain.produce(7 * flon::DAY_SECONDS + 1);
+    for (int i = 0; i < plans / 2; i += 5)
+        REQUIRE_OK(chain.push(flon::INVEST_POOL, "crank"_n, keeper, keeper, (uint16_t)5));
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    BOOST_TEST_MESSAGE("many_plans: " << ms << " ms");
+
+    for (int p = 1; p <= plans; ++p)
+        BOOST_CHECK_EQUAL(plan(p).status, p % 2 ? rwafi::PlanStatus::SUCCESS : rwafi::PlanStatus::REFUNDED);
+    for (const auto& u : users)
+        BOOST_CHECK_EQUAL(balance(flon::SING_BANK, u, flon::SING_SYM), sing(10000 - 100 * (plans / 2)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
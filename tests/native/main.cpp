@@ -0,0 +1,2 @@
+#define BOOST_TEST_MODULE rwafi_native_sim
+#include <boost/test/included/unit_test.hpp>
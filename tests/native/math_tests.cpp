@@ -0,0 +1,271 @@
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include <flon/utils.hpp>
+#include <flon/merkle.hpp>
+#include <sim/kernels.hpp>
+
+using namespace eosio;
+namespace k = sim::kernels;
+
+namespace {
+
+constexpr int     rounds    = 20000;
+constexpr int64_t int64_max = std::numeric_limits<int64_t>::max();
+constexpr int64_t asset_max = asset::max_amount;
+constexpr int128_t e18      = 1'000'000'000'000'000'000;
+
+struct fuzzer {
+    std::mt19937_64 rng{20250101};
+
+    // log-uniform in [1, 2^bits): small and huge amounts are equally likely
+    int64_t amount(int bits = 62) {
+        const int b = 1 + rng() % bits;
+        const int64_t v = int64_t(rng() >> (64 - b));
+        return v > 0 ? v : 1;
+    }
+    uint8_t decimals() { return rng() % 19; }
+    symbol  sym(const char* code) { return symbol(code, decimals()); }
+};
+
+int128_t pow10_128(int p) {
+    int128_t v = 1;
+    while (p-- > 0) v *= 10;
+    return v;
+}
+
+// runs f, returns false when a contract check aborted it
+template<typename F>
+bool passes(F&& f) {
+    try {
+        f();
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(math_tests)
+
+// issue → refund never pays back more than was accepted, and loses less than one receipt unit
+BOOST_AUTO_TEST_CASE(invest_refund_round_trip) {
+    fuzzer f;
+    int checked = 0;
+    for (int i = 0; i < rounds; ++i) {
+        const asset accepted(f.amount(), f.sym("SING"));
+        const asset per_unit(f.amount(40), f.sym("STAAA"));
+
+        int64_t issued = 0;
+        const int128_t want = (int128_t)accepted.amount * per_unit.amount / pow10_128(accepted.symbol.precision());
+        if (!passes([&] { issued = k::issue_amount(accepted, per_unit); })) {
+            BOOST_REQUIRE(want > int64_max);
+            continue;
+        }
+        BOOST_REQUIRE(want == issued);
+        if (issued == 0) continue;
+
+        if (issued > asset_max) continue;     // no receipt of that size can exist
+
+        int64_t refund = 0;
+        BOOST_REQUIRE(passes([&] { refund = k::refund_amount(asset(issued, per_unit.symbol), per_unit, accepted.symbol); }));
+        BOOST_REQUIRE_LE(refund, accepted.amount);
+        // rounding loss is below the value of one receipt unit: 10^goal_precision / per_unit + 1
+        BOOST_REQUIRE((int128_t)(accepted.amount - refund) * per_unit.amount
+                      <= pow10_128(accepted.symbol.precision()) + per_unit.amount);
+        ++checked;
+    }
+    BOOST_TEST_MESSAGE("invest_refund_round_trip: " << checked << " round trips");
+    BOOST_CHECK_GT(checked, rounds / 4);
+}
+
+// the receipt supply created by createplan covers every investment the hard cap admits
+BOOST_AUTO_TEST_CASE(max_supply_covers_hard_cap) {
+    fuzzer f;
+    for (int i = 0; i < rounds; ++i) {
+        const asset   goal(f.amount(), f.sym("SING"));
+        const asset   per_unit(f.amount(40), f.sym("STAAA"));
+        const uint8_t hard = 60 + f.rng() % 196;
+
+        int64_t cap = 0, supply = 0;
+        if (!passes([&] { cap = k::cap_amount(goal, hard); })) {
+            BOOST_REQUIRE((int128_t)goal.amount * hard / 100 > int64_max);
+            continue;
+        }
+        if (!passes([&] { supply = k::max_supply(goal, hard, per_unit); }))
+            continue;
+
+        if (cap > asset_max || supply > asset_max) continue;
+
+        // any split of the hard cap into investments issues at most the supply
+        const int64_t first = cap > 0 ? f.rng() % cap : 0;
+        int64_t a = 0, b = 0;
+        if (first > 0) BOOST_REQUIRE(passes([&] { a = k::issue_amount(asset(first, goal.symbol), per_unit); }));
+        if (cap - first > 0) BOOST_REQUIRE(passes([&] { b = k::issue_amount(asset(cap - first, goal.symbol), per_unit); }));
+        BOOST_REQUIRE((int128_t)a + b <= supply);
+    }
+}
+
+// reward per share never distributes more than the reward, whatever the split of stakes
+BOOST_AUTO_TEST_CASE(reward_per_share_conserves) {
+    fuzzer f;
+    for (int i = 0; i < rounds / 10; ++i) {
+        const symbol rsym = f.sym("SING");
+        const asset  rewards(f.amount(), rsym);
+        const int    stakers = 1 + f.rng() % 50;
+
+        std::vector<int64_t> stakes;
+        int128_t total = 0;
+        for (int s = 0; s < stakers; ++s) {
+            stakes.push_back(f.amount(55));
+            total += stakes.back();
+        }
+        if (total > asset_max) continue;
+        const symbol ssym("STAAA", 8);
+
+        const int128_t delta = k::reward_per_share_delta(rewards, asset((int64_t)total, ssym));
+        BOOST_REQUIRE(delta == (int128_t)rewards.amount * e18 / total);
+
+        int128_t paid = 0;
+        for (const auto s : stakes) {
+            asset r;
+            BOOST_REQUIRE(passes([&] { r = k::user_reward(asset(s, ssym), delta, rsym); }));
+            BOOST_REQUIRE(r.symbol == rsym);
+            paid += r.amount;
+        }
+        BOOST_REQUIRE(paid <= rewards.amount);
+        // each staker loses below one unit, the delta floor below total / 1e18 units
+        BOOST_REQUIRE(rewards.amount - paid <= stakers + total / e18 + 1);
+    }
+}
+
+// a per-share delta large enough to push a reward past the asset range is rejected, not truncated
+BOOST_AUTO_TEST_CASE(user_reward_overflow_checked) {
+    fuzzer f;
+    const symbol rsym("SING", 8), ssym("STAAA", 8);
+    for (int i = 0; i < rounds; ++i) {
+        const asset    staked(f.amount(), ssym);
+        const int128_t delta = (int128_t)f.amount() * f.amount();
+        const bool     wraps = delta > std::numeric_limits<int128_t>::max() / staked.amount;
+        const int128_t want  = wraps ? 0 : (int128_t)staked.amount * delta / e18;
+        asset r;
+        if (passes([&] { r = k::user_reward(staked, delta, rsym); }))
+            BOOST_REQUIRE(!wraps && r.amount == want);
+        else
+            BOOST_REQUIRE(wraps || want > asset_max);
+    }
+    BOOST_CHECK_EQUAL(k::user_reward(asset(0, ssym), e18, rsym).amount, 0);
+    BOOST_CHECK(k::reward_per_share_delta(asset(0, rsym), asset(1, ssym)) == 0);
+}
+
+// utils.hpp decimal helpers round half up and flag results outside int64;
+// inputs are kept where 10 * a * b fits the __int128 intermediate, the helpers' precondition
+BOOST_AUTO_TEST_CASE(decimal_helpers_round_half_up) {
+    fuzzer f;
+    for (int i = 0; i < rounds; ++i) {
+        const int      p = f.decimals();
+        const int128_t precision = pow10_128(p);
+        const int128_t a = f.amount(60), b = f.amount(60);
+
+        const int128_t md = 10 * a * b / precision;
+        int128_t got = 0;
+        if (passes([&] { got = multiply_decimal64(a, b, precision); }))
+            BOOST_REQUIRE(got == (md + 5) / 10 && md <= int64_max);
+        else
+            BOOST_REQUIRE(md > int64_max);
+
+        const int128_t dd = 10 * a * precision / b;
+        if (passes([&] { got = divide_decimal64(a, b, precision); }))
+            BOOST_REQUIRE(got == (dd + 5) / 10 && dd <= int64_max);
+        else
+            BOOST_REQUIRE(dd > int64_max);
+    }
+}
+
+// flon::muldiv: exact floor quotient, overflow rejected at either stage
+BOOST_AUTO_TEST_CASE(muldiv_floor_and_overflow) {
+    fuzzer f;
+    for (int i = 0; i < rounds; ++i) {
+        const int128_t a = f.amount(63), b = i % 2 ? f.amount(63) : (int128_t)f.amount(63) << f.rng() % 64;
+        const int128_t c = f.amount(63);
+        const bool     wraps = a != 0 && b > std::numeric_limits<int128_t>::max() / a;
+        const int128_t want  = wraps ? 0 : a * b / c;
+
+        int64_t got = 0;
+        if (passes([&] { got = flon::muldiv(a, b, c); }))
+            BOOST_REQUIRE(!wraps && got == want);
+        else
+            BOOST_REQUIRE(wraps || want > int64_max);
+    }
+    BOOST_CHECK(!passes([] { flon::muldiv(1, 1, 0); }));
+    BOOST_CHECK(!passes([] { flon::muldiv(-1, 1, 1); }));
+}
+
+BOOST_AUTO_TEST_CASE(decimal_table) {
+    for (uint8_t p = 0; p <= flon::MAX_DECIMALS; ++p) {
+        BOOST_CHECK(flon::pow10(p) == pow10_128(p));
+        BOOST_CHECK_EQUAL(power10(p), flon::pow10(p));
+    }
+    BOOST_CHECK(!passes([] { flon::pow10(19); }));
+    BOOST_CHECK(!passes([] { power10(19); }));
+    BOOST_CHECK(!passes([] { power10(-1); }));
+
+    BOOST_CHECK_EQUAL(flon::sub_floor0(5, 7), 0);
+    BOOST_CHECK_EQUAL(flon::sub_floor0(7, 5), 2);
+}
+
+template<typename T>
+void check_safe(fuzzer& f) {
+    const int bits = sizeof(T) * 8 - 1;
+    auto pick = [&]() -> T {
+        const int64_t v = f.amount(bits);
+        return T(f.rng() % 2 ? v : -v);
+    };
+    auto in_range = [](int128_t v) {
+        return v >= std::numeric_limits<T>::min() && v <= std::numeric_limits<T>::max();
+    };
+    for (int i = 0; i < rounds; ++i) {
+        const T a = pick(), b = pick();
+        safe<T> r;
+        BOOST_REQUIRE_EQUAL(passes([&] { r = safe<T>(a) + safe<T>(b); }), in_range((int128_t)a + b));
+        BOOST_REQUIRE_EQUAL(passes([&] { r = safe<T>(a) - safe<T>(b); }), in_range((int128_t)a - b));
+        BOOST_REQUIRE_EQUAL(passes([&] { r = safe<T>(a) * safe<T>(b); }), in_range((int128_t)a * b));
+        if (in_range((int128_t)a * b)) BOOST_REQUIRE(r.value == T(a * b));
+    }
+}
+
+// FIPS 180-4 test vectors; sorted-pair nodes make a proof independent of the sibling side
+BOOST_AUTO_TEST_CASE(sha256_and_merkle_proofs) {
+    const auto hex = [](const checksum256& c) {
+        static const char* digits = "0123456789abcdef";
+        std::string s;
+        for (uint8_t b : c.extract_as_byte_array()) { s += digits[b >> 4]; s += digits[b & 15]; }
+        return s;
+    };
+    BOOST_CHECK_EQUAL(hex(sha256("abc", 3)), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    BOOST_CHECK_EQUAL(hex(sha256("", 0)), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    const std::string two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    BOOST_CHECK_EQUAL(hex(sha256(two_blocks.data(), two_blocks.size())),
+                      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    const name a = "alice"_n, b = "bob"_n, c = "carol"_n;
+    const checksum256 ab   = flon::merkle_parent(flon::merkle_leaf(a), flon::merkle_leaf(b));
+    const checksum256 root = flon::merkle_parent(ab, flon::merkle_leaf(c));
+    BOOST_CHECK(flon::merkle_parent(flon::merkle_leaf(b), flon::merkle_leaf(a)) == ab);
+    BOOST_CHECK(flon::merkle_verify(root, a, {flon::merkle_leaf(b), flon::merkle_leaf(c)}));
+    BOOST_CHECK(flon::merkle_verify(root, c, {ab}));
+    BOOST_CHECK(!flon::merkle_verify(root, "dave"_n, {ab}));
+    BOOST_CHECK(!flon::merkle_verify(root, a, {flon::merkle_leaf(c)}));
+}
+
+// safe<T> throws exactly when the exact result leaves T
+BOOST_AUTO_TEST_CASE(safe_arithmetic_bounds) {
+    fuzzer f;
+    check_safe<int16_t>(f);
+    check_safe<int32_t>(f);
+    check_safe<int64_t>(f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <boost/test/unit_test.hpp>
+
+#include <flon/consts.hpp>
+#include <flon/flon.token.hpp>
+#include <vault.rwa/vaultrwa.hpp>
+
+#include <sim/chain.hpp>
+#include <sim/contracts.hpp>
+
+#define REQUIRE_OK(expr)            BOOST_REQUIRE_EQUAL((expr), std::string())
+#define REQUIRE_FAIL(expr, substr)  BOOST_REQUIRE_MESSAGE((expr).find(substr) != std::string::npos, \
+                                                          "expected failure containing: " << substr)
+
+namespace rwafi_sim {
+
+using namespace eosio;
+
+inline asset sing(double v) { return asset((int64_t)(v * 100000000 + (v >= 0 ? 0.5 : -0.5)), flon::SING_SYM); }
+
+/**
+ * The rwafi contracts plus sing.token / flon.swap stand-ins, deployed at
+ * their production accounts and initialised the way the deploy scripts do.
+ */
+struct rwafi_fixture {
+    sim::chain  chain;
+
+    const name  admin       = "admin"_n;
+    const name  creator     = "creator"_n;
+    const name  keeper      = "keeper"_n;
+
+    rwafi_fixture() {
+        chain.deploy(flon::INVEST_POOL,   sim_apply_investrwa);
+        chain.deploy(flon::STAKE_POOL,    sim_apply_stakerwa);
+        chain.deploy(flon::YIELD_POOL,    sim_apply_yieldrwa);
+        chain.deploy(flon::GUARANTY_POOL, sim_apply_guarantyrwa);
+        chain.deploy(flon::VAULT_POOL,    sim_apply_vaultrwa);
+        chain.deploy(flon::RECEIPT_BANK,  sim_apply_rwafitoken);
+        chain.deploy(flon::SING_BANK,     sim_apply_flontoken);
+        chain.deploy(flon::SWAP_POOL,     sim_apply_flonswap);
+
+        for (auto a : {admin, creator, keeper})
+            chain.create_account(a);
+
+        REQUIRE_OK(chain.push(flon::SING_BANK, "create"_n, flon::SING_BANK, admin, sing(1e9)));
+        REQUIRE_OK(chain.push(flon::SING_BANK, "issue"_n, admin, admin, sing(1e8), "genesis"));
+
+        REQUIRE_OK(chain.push(flon::INVEST_POOL, "init"_n, flon::INVEST_POOL, admin));
+        REQUIRE_OK(chain.push(flon::INVEST_POOL, "addtoken"_n, admin, flon::SING_BANK, flon::SING_SYM));
+        REQUIRE_OK(chain.push(flon::STAKE_POOL, "init"_n, flon::STAKE_POOL, admin, flon::INVEST_POOL));
+        REQUIRE_OK(chain.push(flon::YIELD_POOL, "init"_n, flon::YIELD_POOL, admin));
+        REQUIRE_OK(chain.push(flon::GUARANTY_POOL, "init"_n, flon::GUARANTY_POOL, admin));
+        REQUIRE_OK(chain.push(flon::VAULT_POOL, "init"_n, flon::VAULT_POOL, admin));
+    }
+
+    void create_account(name a, const asset& funds = asset(0, flon::SING_SYM)) {
+        chain.create_account(a);
+        if (funds.amount > 0)
+            REQUIRE_OK(transfer(flon::SING_BANK, admin, a, funds, "fund"));
+    }
+
+    std::string transfer(name bank, name from, name to, const asset& quantity, const std::string& memo) {
+        return chain.push(bank, "transfer"_n, from, from, to, quantity, memo);
+    }
+
+    asset balance(name bank, name owner, const symbol& sym) const {
+        flon::token::accounts accts(bank, owner.value);
+        auto it = accts.find(sym.code().raw());
+        return it == accts.end() ? asset(0, sym) : it->balance;
+    }
+
+    // a pool's share of the tokens held by vault.rwa
+    asset vault_balance(name pool, const symbol& sym) const {
+        rwafi::ledger_t::idx_t ledgers(flon::VAULT_POOL, pool.value);
+        auto it = ledgers.find(sym.code().raw());
+        return it == ledgers.end() ? asset(0, sym) : it->balance.quantity;
+    }
+
+    // inv.aaaa, inv.aaab, ...: a valid account name for any participant index
+    static name participant(const char* prefix, uint32_t i) {
+        const char suffix[] = {'.', char('a' + i / 17576 % 26), char('a' + i / 676 % 26),
+                               char('a' + i / 26 % 26), char('a' + i % 26), 0};
+        return name(std::string(prefix) + suffix);
+    }
+
+    // receipt symbol STAAA, STAAB, ... with 8 decimals, 1 receipt per SING
+    static symbol receipt_sym(uint64_t n) {
+        const char code[] = {'S', 'T', char('A' + n / 676 % 26), char('A' + n / 26 % 26), char('A' + n % 26), 0};
+        return symbol(code, 8);
+    }
+
+    std::string create_plan(const symbol& receipt, const asset& goal, uint32_t raise_seconds,
+                            uint16_t return_months = 12, uint8_t soft_cap = 80, uint8_t hard_cap = 100) {
+        const time_point start = chain.now();
+        const time_point end   = chain.now() + raise_seconds;
+        return chain.push(flon::INVEST_POOL, "createplan"_n, creator,
+                          creator, std::string("plan"), flon::SING_BANK, goal,
+                          flon::RECEIPT_BANK, asset(100000000, receipt),
+                          soft_cap, hard_cap, start, end, return_months, (uint32_t)800);
+    }
+};
+
+} // namespace rwafi_sim
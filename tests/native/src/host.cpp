@@ -0,0 +1,548 @@
+#include <sim/chain.hpp>
+#include <sim/host.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace sim {
+
+namespace {
+
+// approximate nodeos billable sizes (key_value_object / index objects)
+constexpr int64_t ROW_OVERHEAD_BYTES        = 112;
+constexpr int64_t INDEX_ROW_OVERHEAD_BYTES  = 120;
+constexpr uint32_t MAX_INLINE_DEPTH         = 8;
+
+struct assert_failure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct row_t {
+    std::vector<char>           data;
+    uint64_t                    payer = 0;
+    std::vector<std::string>    sec_keys;
+};
+
+using table_id  = std::tuple<uint64_t, uint64_t, uint64_t>;     // code, scope, table
+using index_set = std::set<std::pair<std::string, uint64_t>>;
+
+struct table_t {
+    std::map<uint64_t, row_t>   rows;
+    std::vector<index_set>      indexes;
+};
+
+struct undo_t {
+    table_id                tid;
+    uint64_t                pk;
+    std::optional<row_t>    old;
+};
+
+struct pending_action {
+    uint64_t                                        account = 0;
+    uint64_t                                        name    = 0;
+    std::vector<std::pair<uint64_t, uint64_t>>      auth;
+    std::vector<char>                               data;
+    uint64_t                                        sender  = 0;    // 0 for the pushed action
+};
+
+struct apply_context {
+    const pending_action*   act;
+    uint64_t                receiver;
+    std::vector<uint64_t>*  recipients;
+    std::vector<pending_action>* inlines;
+};
+
+} // namespace
+
+struct chain::impl {
+    std::map<uint64_t, apply_fn>            contracts;
+    std::set<uint64_t>                      accounts;
+    std::set<std::pair<uint64_t, uint64_t>> code_grants;    // (actor, contract)
+    std::map<table_id, table_t>             db;
+    std::map<uint64_t, int64_t>             ram;
+    int64_t                                 now_us = 0;
+
+    // per transaction
+    std::vector<undo_t>                     undo;
+    std::vector<action_trace>               traces;
+    std::map<eosio::name, int64_t>          ram_deltas;     // per payer, successful transactions only
+    uint32_t                                net_bytes = 0;
+    std::string                             console;
+    std::vector<apply_context>              ctx;
+
+    static int64_t row_bytes(const row_t& r) {
+        int64_t b = ROW_OVERHEAD_BYTES + (int64_t)r.data.size();
+        for (const auto& k : r.sec_keys) b += INDEX_ROW_OVERHEAD_BYTES + (int64_t)k.size();
+        return b;
+    }
+
+    table_t* find_table(uint64_t code, uint64_t scope, uint64_t table) {
+        auto it = db.find({code, scope, table});
+        return it == db.end() ? nullptr : &it->second;
+    }
+
+    index_set* find_index(uint64_t code, uint64_t scope, uint64_t table, uint32_t index) {
+        table_t* t = find_table(code, scope, table);
+        if (!t || index >= t->indexes.size()) return nullptr;
+        return &t->indexes[index];
+    }
+
+    // write (or delete, when `row` is empty) without undo bookkeeping
+    void put_row(const table_id& tid, uint64_t pk, std::optional<row_t> row) {
+        table_t& t = db[tid];
+        auto it = t.rows.find(pk);
+        if (it != t.rows.end()) {
+            ram[it->second.payer] -= row_bytes(it->second);
+            for (size_t i = 0; i < it->second.sec_keys.size(); ++i)
+                t.indexes[i].erase({it->second.sec_keys[i], pk});
+            t.rows.erase(it);
+        }
+        if (row) {
+            if (t.indexes.size() < row->sec_keys.size()) t.indexes.resize(row->sec_keys.size());
+            for (size_t i = 0; i < row->sec_keys.size(); ++i)
+                t.indexes[i].insert({row->sec_keys[i], pk});
+            ram[row->payer] += row_bytes(*row);
+            t.rows.emplace(pk, std::move(*row));
+        }
+        if (t.rows.empty()) db.erase(tid);
+    }
+
+    void write_row(const table_id& tid, uint64_t pk, std::optional<row_t> row) {
+        std::optional<row_t> old;
+        if (table_t* t = find_table(std::get<0>(tid), std::get<1>(tid), std::get<2>(tid))) {
+            auto it = t->rows.find(pk);
+            if (it != t->rows.end()) old = it->second;
+        }
+        undo.push_back({tid, pk, std::move(old)});
+        put_row(tid, pk, std::move(row));
+    }
+
+    void rollback() {
+        for (auto it = undo.rbegin(); it != undo.rend(); ++it)
+            put_row(it->tid, it->pk, std::move(it->old));
+        undo.clear();
+    }
+
+    const apply_context& current() const {
+        if (ctx.empty()) throw assert_failure("host function called outside of an action");
+        return ctx.back();
+    }
+
+    bool authorized(uint64_t account) const {
+        for (const auto& a : current().act->auth)
+            if (a.first == account) return true;
+        return false;
+    }
+
+    void execute(const pending_action& act, uint32_t depth) {
+        if (depth > MAX_INLINE_DEPTH)
+            throw assert_failure("max inline action depth exceeded");
+        if (!accounts.count(act.account))
+            throw assert_failure("action's code account does not exist: " + eosio::name(act.account).to_string());
+
+        // inline authorizations are satisfied only by the sender's eosio.code
+        if (act.sender) {
+            for (const auto& a : act.auth) {
+                if (a.first != act.sender && !code_grants.count({a.first, act.sender}))
+                    throw assert_failure("missing authority of " + eosio::name(a.first).to_string()
+                                         + " for inline action sent by " + eosio::name(act.sender).to_string());
+            }
+        }
+
+        std::vector<uint64_t>       recipients{act.account};
+        std::vector<pending_action> inlines;
+
+        for (size_t i = 0; i < recipients.size(); ++i) {
+            const uint64_t receiver = recipients[i];
+            auto c = contracts.find(receiver);
+            if (c == contracts.end()) {
+                if (receiver == act.account)
+                    throw assert_failure("no contract deployed on " + eosio::name(receiver).to_string());
+                continue;
+            }
+
+            action_trace tr;
+            tr.receiver = eosio::name(receiver);
+            tr.code     = eosio::name(act.account);
+            tr.action   = eosio::name(act.name);
+            tr.depth    = depth;
+
+            const int64_t ram_before = total_ram();
+            const auto    start      = std::chrono::steady_clock::now();
+
+            ctx.push_back({&act, receiver, &recipients, &inlines});
+            try {
+                c->second(receiver, act.account, act.name);
+            } catch (...) {
+                ctx.pop_back();
+                traces.push_back(tr);   // keep the failing receiver in the trace
+                throw;
+            }
+            ctx.pop_back();
+
+            tr.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count();
+            tr.ram_delta  = total_ram() - ram_before;
+            traces.push_back(tr);
+        }
+
+        for (const auto& ia : inlines)
+            execute(ia, depth + 1);
+    }
+
+    int64_t total_ram() const {
+        int64_t t = 0;
+        for (const auto& r : ram) t += r.second;
+        return t;
+    }
+};
+
+namespace {
+chain::impl* g_chain = nullptr;
+
+chain::impl& my() {
+    if (!g_chain) throw assert_failure("no sim::chain instance");
+    return *g_chain;
+}
+} // namespace
+
+// ---- chain ---------------------------------------------------------------
+
+chain::chain() : _my(std::make_unique<impl>()) {
+    if (g_chain) throw std::logic_error("only one sim::chain may exist at a time");
+    g_chain = _my.get();
+    _my->now_us = int64_t(1767225600) * 1000000;   // 2026-01-01T00:00:00Z
+}
+
+chain::~chain() {
+    g_chain = nullptr;
+}
+
+void chain::create_account(eosio::name account) {
+    _my->accounts.insert(account.value);
+}
+
+void chain::deploy(eosio::name account, apply_fn apply) {
+    _my->accounts.insert(account.value);
+    _my->contracts[account.value] = apply;
+}
+
+void chain::grant_code(eosio::name actor, eosio::name contract) {
+    _my->code_grants.insert({actor.value, contract.value});
+}
+
+void chain::set_time(eosio::time_point_sec t) {
+    _my->now_us = int64_t(t.sec_since_epoch()) * 1000000;
+}
+
+void chain::produce(uint32_t seconds) {
+    _my->now_us += int64_t(seconds) * 1000000;
+}
+
+eosio::time_point_sec chain::now() const {
+    return eosio::time_point_sec(uint32_t(_my->now_us / 1000000));
+}
+
+std::string chain::push_action(eosio::name code, eosio::name action,
+                               const std::vector<eosio::permission_level>& auth,
+                               std::vector<char> data) {
+    return _push(code, action, auth, std::move(data), true);
+}
+
+std::string chain::dry_run_action(eosio::name code, eosio::name action,
+                                  const std::vector<eosio::permission_level>& auth,
+                                  std::vector<char> data) {
+    return _push(code, action, auth, std::move(data), false);
+}
+
+std::string chain::_push(eosio::name code, eosio::name action,
+                         const std::vector<eosio::permission_level>& auth,
+                         std::vector<char> data, bool commit) {
+    impl& m = *_my;
+    m.undo.clear();
+    m.traces.clear();
+    m.ram_deltas.clear();
+    m.console.clear();
+    m.ctx.clear();
+
+    pending_action act;
+    act.account = code.value;
+    act.name    = action.value;
+    act.data    = std::move(data);
+    for (const auto& p : auth) {
+        if (!m.accounts.count(p.actor.value))
+            return "unknown authorizing account " + p.actor.to_string();
+        act.auth.emplace_back(p.actor.value, p.permission.value);
+    }
+
+    // account + name + auth vector + data vector, as packed into the transaction
+    auto varuint_size = [](size_t v) { uint32_t n = 1; while (v >= 0x80) { v >>= 7; ++n; } return n; };
+    m.net_bytes = 16 + varuint_size(act.auth.size()) + 16 * (uint32_t)act.auth.size()
+                + varuint_size(act.data.size()) + (uint32_t)act.data.size();
+
+    const std::map<uint64_t, int64_t> ram_before = m.ram;
+    try {
+        m.execute(act, 0);
+    } catch (const std::exception& e) {
+        m.ctx.clear();
+        m.rollback();
+        return e.what();
+    }
+    for (const auto& [payer, bytes] : m.ram) {
+        auto it = ram_before.find(payer);
+        const int64_t delta = bytes - (it == ram_before.end() ? 0 : it->second);
+        if (delta != 0) m.ram_deltas[eosio::name(payer)] = delta;
+    }
+    if (commit) m.undo.clear();
+    else        m.rollback();
+    return std::string();
+}
+
+int64_t chain::ram_usage(eosio::name account) const {
+    auto it = _my->ram.find(account.value);
+    return it == _my->ram.end() ? 0 : it->second;
+}
+
+const std::vector<action_trace>& chain::traces() const { return _my->traces; }
+const std::map<eosio::name, int64_t>& chain::ram_deltas() const { return _my->ram_deltas; }
+uint32_t                              chain::net_bytes() const { return _my->net_bytes; }
+const std::string&               chain::console() const { return _my->console; }
+
+uint64_t chain::rows(eosio::name code) const {
+    uint64_t n = 0;
+    for (const auto& t : _my->db)
+        if (std::get<0>(t.first) == code.value) n += t.second.rows.size();
+    return n;
+}
+
+// ---- host functions ------------------------------------------------------
+
+namespace host {
+
+void abort(const std::string& msg) {
+    throw assert_failure("assertion failure with message: " + msg);
+}
+
+void print(const std::string& s) {
+    my().console += s;
+}
+
+int64_t current_time_us() {
+    return my().now_us;
+}
+
+bool is_account(uint64_t account) {
+    return my().accounts.count(account) > 0;
+}
+
+void require_auth(uint64_t account) {
+    if (!my().authorized(account))
+        throw assert_failure("missing authority of " + eosio::name(account).to_string());
+}
+
+bool has_auth(uint64_t account) {
+    return my().authorized(account);
+}
+
+void require_recipient(uint64_t account) {
+    auto& r = *my().current().recipients;
+    if (std::find(r.begin(), r.end(), account) == r.end()) r.push_back(account);
+}
+
+const bytes& action_data() {
+    return my().current().act->data;
+}
+
+void send_inline(uint64_t account, uint64_t action,
+                 const std::vector<std::pair<uint64_t, uint64_t>>& auth, bytes data) {
+    auto& c = my().current();
+    pending_action a;
+    a.account = account;
+    a.name    = action;
+    a.auth    = auth;
+    a.data    = std::move(data);
+    a.sender  = c.receiver;
+    c.inlines->push_back(std::move(a));
+}
+
+// FIPS 180-4 SHA-256 (the wasm intrinsic's native counterpart)
+void sha256(const char* data, uint32_t length, uint8_t out[32]) {
+    static constexpr uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    const auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+
+    // message + 0x80 + zero padding + 64-bit big-endian bit length, in 64-byte blocks
+    std::vector<uint8_t> msg(data, data + length);
+    msg.push_back(0x80);
+    while (msg.size() % 64 != 56) msg.push_back(0);
+    const uint64_t bits = uint64_t(length) * 8;
+    for (int i = 7; i >= 0; --i) msg.push_back(uint8_t(bits >> (8 * i)));
+
+    for (size_t off = 0; off < msg.size(); off += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+            w[i] = uint32_t(msg[off + 4 * i]) << 24 | uint32_t(msg[off + 4 * i + 1]) << 16
+                 | uint32_t(msg[off + 4 * i + 2]) << 8 | uint32_t(msg[off + 4 * i + 3]);
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 4; ++j) out[4 * i + j] = uint8_t(h[i] >> (24 - 8 * j));
+}
+
+bool db_get(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, bytes& out) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t) return false;
+    auto it = t->rows.find(pk);
+    if (it == t->rows.end()) return false;
+    out = it->second.data;
+    return true;
+}
+
+void db_set(uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, uint64_t pk,
+            const bytes& data, const std::vector<std::string>& sec_keys) {
+    auto& m = my();
+    if (code != m.current().receiver)
+        throw assert_failure("db access violation: cannot modify table of " + eosio::name(code).to_string());
+
+    row_t row;
+    row.data     = data;
+    row.sec_keys = sec_keys;
+    row.payer    = payer;
+    int64_t billed = 0;     // bytes already charged to the new payer for this row
+    if (table_t* t = m.find_table(code, scope, table)) {
+        auto it = t->rows.find(pk);
+        if (it != t->rows.end()) {
+            if (payer == 0) row.payer = it->second.payer;
+            if (row.payer == it->second.payer) billed = chain::impl::row_bytes(it->second);
+        }
+    }
+    if (row.payer == 0)
+        throw assert_failure("must specify a valid account to pay for new record");
+    // like nodeos, only a growing charge to a third party needs its authority
+    if (row.payer != code && chain::impl::row_bytes(row) > billed && !m.authorized(row.payer))
+        throw assert_failure("cannot charge RAM to other accounts during notify/inline: "
+                             + eosio::name(row.payer).to_string());
+
+    m.write_row({code, scope, table}, pk, std::move(row));
+}
+
+void db_erase(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk) {
+    auto& m = my();
+    if (code != m.current().receiver)
+        throw assert_failure("db access violation: cannot erase from table of " + eosio::name(code).to_string());
+    m.write_row({code, scope, table}, pk, std::nullopt);
+}
+
+bool db_lower_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t) return false;
+    auto it = t->rows.lower_bound(pk);
+    if (it == t->rows.end()) return false;
+    out = it->first;
+    return true;
+}
+
+bool db_upper_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t) return false;
+    auto it = t->rows.upper_bound(pk);
+    if (it == t->rows.end()) return false;
+    out = it->first;
+    return true;
+}
+
+bool db_prev(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, uint64_t& out) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t) return false;
+    auto it = t->rows.lower_bound(pk);
+    if (it == t->rows.begin()) return false;
+    out = (--it)->first;
+    return true;
+}
+
+bool db_last(uint64_t code, uint64_t scope, uint64_t table, uint64_t& out) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t || t->rows.empty()) return false;
+    out = t->rows.rbegin()->first;
+    return true;
+}
+
+bool idx_lower_bound(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                     const std::string& key, uint64_t pk, std::string& out_key, uint64_t& out_pk) {
+    index_set* s = my().find_index(code, scope, table, index);
+    if (!s) return false;
+    auto it = s->lower_bound({key, pk});
+    if (it == s->end()) return false;
+    out_key = it->first;
+    out_pk  = it->second;
+    return true;
+}
+
+bool idx_next(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+              const std::string& key, uint64_t pk, std::string& out_key, uint64_t& out_pk) {
+    index_set* s = my().find_index(code, scope, table, index);
+    if (!s) return false;
+    auto it = s->upper_bound({key, pk});
+    if (it == s->end()) return false;
+    out_key = it->first;
+    out_pk  = it->second;
+    return true;
+}
+
+bool idx_prev(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+              const std::string& key, uint64_t pk, std::string& out_key, uint64_t& out_pk) {
+    index_set* s = my().find_index(code, scope, table, index);
+    if (!s) return false;
+    auto it = s->lower_bound({key, pk});
+    if (it == s->begin()) return false;
+    --it;
+    out_key = it->first;
+    out_pk  = it->second;
+    return true;
+}
+
+bool idx_last(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+              std::string& out_key, uint64_t& out_pk) {
+    index_set* s = my().find_index(code, scope, table, index);
+    if (!s || s->empty()) return false;
+    out_key = s->rbegin()->first;
+    out_pk  = s->rbegin()->second;
+    return true;
+}
+
+bool idx_key_of(uint64_t code, uint64_t scope, uint64_t table, uint32_t index,
+                uint64_t pk, std::string& out_key) {
+    table_t* t = my().find_table(code, scope, table);
+    if (!t) return false;
+    auto it = t->rows.find(pk);
+    if (it == t->rows.end() || index >= it->second.sec_keys.size()) return false;
+    out_key = it->second.sec_keys[index];
+    return true;
+}
+
+} // namespace host
+} // namespace sim
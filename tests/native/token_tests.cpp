@@ -0,0 +1,127 @@
+#include "rwafi_fixture.hpp"
+
+#include <rwafi.token/rwafi.token.hpp>
+
+using namespace rwafi_sim;
+
+namespace {
+
+using batch_t = std::vector<std::pair<name, asset>>;
+
+struct token_fixture : rwafi_fixture {
+    const symbol tkn   = symbol("TKN", 4);
+    const name   alice = "alice"_n;
+    const name   bob   = "bob"_n;
+
+    token_fixture() {
+        create_account(alice);
+        create_account(bob);
+    }
+
+    asset tk(int64_t v) const { return asset(v * 10000, tkn); }
+
+    // rwafi.token creation is reserved to invest.rwa; issuer and holder of the supply is `issuer`
+    void create_token(name issuer, const asset& supply) {
+        REQUIRE_OK(chain.push(flon::RECEIPT_BANK, "create"_n, flon::INVEST_POOL, issuer, supply));
+        REQUIRE_OK(chain.push(flon::RECEIPT_BANK, "issue"_n, issuer, issuer, supply, std::string("issue")));
+    }
+
+    std::string transferbatch(name from, const batch_t& transfers, const std::string& memo) {
+        return chain.push(flon::RECEIPT_BANK, "transferbatch"_n, from, from, transfers, memo);
+    }
+
+    bool notified(name account) const {
+        for (const auto& t : chain.traces())
+            if (t.receiver == account && t.action == "transferbatch"_n) return true;
+        return false;
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(token_tests)
+
+BOOST_FIXTURE_TEST_CASE(transferbatch_debits_once_and_credits_all, token_fixture) {
+    create_token(admin, tk(10000));
+
+    batch_t batch;
+    for (uint32_t i = 0; i < 50; ++i) {
+        const name r = participant("rcv", i);
+        create_account(r);
+        batch.emplace_back(r, tk(i + 1));
+    }
+    batch.emplace_back(flon::SWAP_POOL, tk(1));
+
+    REQUIRE_OK(transferbatch(admin, batch, "airdrop"));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, admin, tkn), tk(10000 - 50 * 51 / 2 - 1));
+    for (uint32_t i = 0; i < 50; ++i)
+        BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, participant("rcv", i), tkn), tk(i + 1));
+    BOOST_CHECK(notified(flon::SWAP_POOL));
+
+    REQUIRE_FAIL(transferbatch(admin, {{participant("rcv", 0), tk(10000)}}, "x"), "overdrawn balance");
+    REQUIRE_FAIL(transferbatch(admin, {{admin, tk(1)}}, "x"), "cannot transfer to self");
+    REQUIRE_FAIL(transferbatch(admin, {{participant("rcv", 0), tk(1)}, {participant("rcv", 1), sing(1)}}, "x"),
+                 "share one symbol");
+    REQUIRE_FAIL(transferbatch(admin, {{"nobody"_n, tk(1)}}, "x"), "to account does not exist");
+    REQUIRE_FAIL(transferbatch(admin, {}, "x"), "empty transfer batch");
+    REQUIRE_FAIL(transferbatch(admin, batch_t(eosio::token::max_batch_transfers + 1, {participant("rcv", 0), tk(0)}), "x"),
+                 "too many transfers");
+}
+
+// a pool paying out does not notify the recipients; pools themselves never take a batch
+BOOST_FIXTURE_TEST_CASE(transferbatch_from_pool_is_quiet, token_fixture) {
+    create_token(flon::STAKE_POOL, tk(100));
+    create_account("carol"_n);
+
+    REQUIRE_OK(transferbatch(flon::STAKE_POOL, {{"carol"_n, tk(10)}, {flon::SWAP_POOL, tk(5)}}, "payout"));
+    BOOST_CHECK_EQUAL(balance(flon::RECEIPT_BANK, flon::SWAP_POOL, tkn), tk(5));
+    BOOST_CHECK(notified(flon::STAKE_POOL));
+    BOOST_CHECK(!notified(flon::SWAP_POOL));
+
+    for (const name pool : {flon::INVEST_POOL, flon::GUARANTY_POOL, flon::VAULT_POOL})
+        REQUIRE_FAIL(transferbatch(flon::STAKE_POOL, {{"carol"_n, tk(1)}, {pool, tk(1)}}, "payout"),
+                     "pools only accept transfer");
+    REQUIRE_FAIL(transferbatch(flon::YIELD_POOL, {{flon::STAKE_POOL, tk(1)}}, "payout"), "pools only accept transfer");
+}
+
+// holders that never stake still have a provable balance history
+BOOST_FIXTURE_TEST_CASE(balance_checkpoints, token_fixture) {
+    using eosio::token;
+    const symbol_code code = tkn.code();
+    create_token(admin, tk(1000));
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, admin, alice, tk(100), "pre"));
+
+    chain.produce(10);
+    REQUIRE_FAIL(chain.push(flon::RECEIPT_BANK, "checkpoint"_n, alice, code), "missing authority");
+    REQUIRE_OK(chain.push(flon::RECEIPT_BANK, "checkpoint"_n, admin, code));
+    const time_point_sec t0 = chain.now();
+    REQUIRE_FAIL(chain.push(flon::RECEIPT_BANK, "checkpoint"_n, admin, code), "already checkpointed");
+
+    chain.produce(10);
+    const time_point_sec t1 = chain.now();
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, alice, bob, tk(30), "a"));
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, alice, bob, tk(20), "b"));      // same second: one checkpoint
+
+    chain.produce(10);
+    const time_point_sec t2 = chain.now();
+    REQUIRE_OK(transfer(flon::RECEIPT_BANK, bob, alice, tk(5), "c"));
+    REQUIRE_OK(chain.push(flon::RECEIPT_BANK, "retire"_n, admin, tk(100), std::string("burn")));
+
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, alice, code, t0), tk(100));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, alice, code, t1 - 1), tk(100));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, alice, code, t1), tk(50));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, alice, code, t2), tk(55));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, bob, code, t1 - 1), tk(0));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, bob, code, t1 + 5), tk(50));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, bob, code, t2 + 100), tk(45));
+    // untouched since checkpointing started: the current balance
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, creator, code, t2), tk(0));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, admin, code, t1), tk(900));
+    BOOST_CHECK_EQUAL(token::balance_at(flon::RECEIPT_BANK, admin, code, t2), tk(800));
+
+    BOOST_CHECK_EQUAL(token::supply_at(flon::RECEIPT_BANK, code, t1), tk(1000));
+    BOOST_CHECK_EQUAL(token::supply_at(flon::RECEIPT_BANK, code, t2), tk(900));
+    BOOST_CHECK_THROW(token::balance_at(flon::RECEIPT_BANK, alice, code, t0 - 1), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,8 +23,24 @@ mpush sing.token transfer '["flonian", "yieldrwa1111", "100.00000000 SING", "pla
 
 
 
+# 回购 TWAP 保护：30 分钟窗口，现价高出 3% 开始缩减，6% 以上拒绝
+mpush  $yield_con settwap  '[1800,300]' -p flonian
+
+# 记录交易对价格观测（首次回购前需有早于当前区块的观测）
+mpush  $yield_con observe  '[8]' -p flonian
+
+# 分批回购：每次最多 5 SING，间隔 1 小时
+mpush  $yield_con setchunk  '["flonian",8,"5.00000000 SING",3600]' -p flonian
+
 mpush $yield_con buyback '["flonian",8]' -p flonian
 
+#未到下一批时间，报错
+mpush $yield_con buyback '["flonian",8]' -p flonian
+
+# keeper 依次执行到期回购
+mpush sing.token transfer '["flonian", "yieldrwa1111", "10.00000000 SING", "keeper"]' -p flonian
+mpush $yield_con crank '["flonian",5]' -p flonian
+
 
 #非admin，报错
 mpush  $yield_con setslippage  '["gahbnbehaskk",8,200]' -p gahbnbehaskk
\ No newline at end of file